@@ -0,0 +1,91 @@
+#ifndef LU_BTF_H
+#define LU_BTF_H
+
+#include <vector>
+#include "LUDecomposition.h"
+#include "Permutation.h"
+#include "SparseLU.h"
+#include "SparseMatrix.h"
+#include "numcomp.h"
+
+
+/**
+ * Maximum transversal of a sparse matrix (Duff's algorithm: depth-first augmenting paths
+ * with a cheap assignment lookahead), i.e. a largest set of structurally non-zero entries
+ * with no two in the same row or column.
+ * @return  the row matched to each column (index_t(-1) for unmatched columns)
+ */
+std::vector<index_t> maximumTransversal(const SparseMatrix &A);
+
+/// Permutations taking a sparse matrix to block upper triangular form (see blockTriangularForm)
+struct BlockTriangularForm {
+    Permutation::Vector rowPerm;  ///< row rowPerm[k] of A is row k of PAQ
+    Permutation::Vector colPerm;  ///< column colPerm[k] of A is column k of PAQ
+    std::vector<index_t> blocks;  ///< block k spans rows and columns [blocks[k], blocks[k + 1]) of PAQ
+    size_t rank = 0;  ///< structural rank (the size of a maximum transversal)
+
+    inline size_t blockCount() const { return blocks.size() - 1; }
+};
+
+/**
+ * Permute a sparse matrix to block upper triangular form PAQ, with irreducible diagonal blocks:
+ * a maximum transversal puts non-zero entries on the diagonal, then the strongly connected
+ * components of the graph of the permuted matrix (Tarjan) give the diagonal blocks, in
+ * topological order. Structurally singular matrices (rank < n) get their unmatched rows and
+ * columns paired arbitrarily.
+ */
+BlockTriangularForm blockTriangularForm(const SparseMatrix &A);
+
+
+/**
+ * LU decomposition of a sparse matrix through its block triangular form: PAQ is block upper
+ * triangular, and only its diagonal blocks are factored (independently, on the shared thread
+ * pool), each in dense or in sparse storage depending on its size and density. For reducible
+ * matrices the cost drops from that of the whole matrix to the sum of the blocks'.
+ */
+class BTFDecomposition {
+public:
+    /**
+     * Compute the block triangular form of a matrix and factor its diagonal blocks.
+     * @param A  matrix to decompose
+     * @param tol  numerical tolerance
+     * @throws SingularMatrixError if A is singular
+     */
+    explicit BTFDecomposition(const SparseMatrix &A, double tol = numcomp::DEFAULT_TOL);
+    BTFDecomposition() = default;
+
+    /// Exception-free counterpart of the constructor (see LUDecomposition::tryFactor)
+    LUStatus tryFactor(const SparseMatrix &A, double tol = numcomp::DEFAULT_TOL);
+
+    /// Like tryFactor(const SparseMatrix &, double), with the block triangular form of A already computed
+    LUStatus tryFactor(const SparseMatrix &A, BlockTriangularForm form, double tol = numcomp::DEFAULT_TOL);
+
+    // getters:
+    inline size_t size() const { return _C.size(); }
+    inline const BlockTriangularForm &form() const { return _form; }
+    inline size_t blockCount() const { return _form.blockCount(); }
+    /// The block upper triangular matrix PAQ, in CSR layout
+    inline const SparseMatrix &permuted() const { return _C; }
+    /// Whether diagonal block k was factored in sparse storage (sparseBlock(k)) or dense (denseBlock(k))
+    inline bool isSparseBlock(index_t k) const { return _isSparse[k]; }
+    inline const LUDecomposition &denseBlock(index_t k) const { return _dense[k]; }
+    inline const SparseLUDecomposition &sparseBlock(index_t k) const { return _sparse[k]; }
+    /// Overall row pivot order: row rowPerm()[k] of A is the k-th pivot row (block permutations included)
+    inline const Permutation::Vector &rowPerm() const { return _rowPerm; }
+    /// Overall column pivot order: column colPerm()[k] of A is the k-th pivot column
+    inline const Permutation::Vector &colPerm() const { return _colPerm; }
+    inline double tol() const { return _tol; }
+    bool parity() const;  ///< 0 if both pivot orders together are even, 1 if odd
+
+private:
+    BlockTriangularForm _form;
+    SparseMatrix _C;  ///< PAQ
+    std::vector<char> _isSparse;  ///< (not vector<bool>: blocks are factored concurrently)
+    std::vector<LUDecomposition> _dense;
+    std::vector<SparseLUDecomposition> _sparse;
+    Permutation::Vector _rowPerm, _colPerm;
+    double _tol = numcomp::DEFAULT_TOL;  ///< numerical tolerance
+};
+
+
+#endif //LU_BTF_H
@@ -0,0 +1,53 @@
+#ifndef LU_BANDLU_H
+#define LU_BANDLU_H
+
+#include <vector>
+#include "BandMatrix.h"
+#include "LUDecomposition.h"
+#include "Permutation.h"
+#include "numcomp.h"
+
+
+/**
+ * LU decomposition of a band matrix with partial pivoting, like LAPACK's dgbtrf (unblocked).
+ *
+ * Row interchanges keep L within kl sub-diagonals, and widen U to kl + ku super-diagonals,
+ * which is what the extra kl slots of each column of BandMatrix make room for: factoring
+ * takes O(n kl (kl + ku)) operations and no memory beyond the band.
+ */
+class BandLUDecomposition {
+public:
+    /**
+     * Compute the LU decomposition of a band matrix.
+     * @param A  matrix to decompose
+     * @param tol  numerical tolerance: the matrix is deemed singular if a pivot column has no entry
+     * larger than this (in absolute value)
+     * @throws SingularMatrixError if A is singular
+     */
+    explicit BandLUDecomposition(const BandMatrix &A, double tol = numcomp::DEFAULT_TOL);
+    BandLUDecomposition() = default;
+
+    /// Exception-free counterpart of the constructor (see LUDecomposition::tryFactor)
+    LUStatus tryFactor(const BandMatrix &A, double tol = numcomp::DEFAULT_TOL);
+
+    // getters:
+    inline size_t size() const { return _LU.size(); }
+    /// U in the upper kl + ku super-diagonals, the multipliers of L (unit diagonal) below the diagonal
+    inline const BandMatrix &factors() const { return _LU; }
+    /// Row interchanges (LAPACK's ipiv): at step j, row j was swapped with row pivots()[j] >= j
+    inline const std::vector<index_t> &pivots() const { return _pivots; }
+    /// The row permutation equivalent to the interchanges: row perm()[k] of A is the k-th pivot row
+    Permutation::Vector perm() const;
+    inline double tol() const { return _tol; }
+    bool parity() const;  ///< 0 if the row interchanges make an even permutation, 1 if odd
+
+private:
+    BandMatrix _LU;
+    std::vector<index_t> _pivots;
+    double _tol = numcomp::DEFAULT_TOL;  ///< numerical tolerance
+
+    LUStatus decompose();
+};
+
+
+#endif //LU_BANDLU_H
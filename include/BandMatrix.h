@@ -0,0 +1,91 @@
+#ifndef LU_BANDMATRIX_H
+#define LU_BANDMATRIX_H
+
+#include <algorithm>
+#include <vector>
+#include "aliases.h"
+#include "Matrix.h"
+#include "SparseMatrix.h"
+#include "Vector.h"
+
+
+/// Lower and upper bandwidth of a matrix: A(i, j) = 0 unless -lower <= j - i <= upper
+struct Bandwidth {
+    size_t lower = 0;
+    size_t upper = 0;
+
+    /// Widen the band to include entry (i, j)
+    inline void add(index_t i, index_t j) {
+        if (i > j) lower = std::max(lower, i - j);
+        else upper = std::max(upper, j - i);
+    }
+
+    inline void merge(const Bandwidth &other) {
+        lower = std::max(lower, other.lower);
+        upper = std::max(upper, other.upper);
+    }
+};
+
+/// Bandwidth of the non-zero entries of a matrix
+Bandwidth bandwidth(const Matrix &A);
+
+/// Bandwidth of the stored entries of a sparse matrix
+Bandwidth bandwidth(const SparseMatrix &A);
+
+
+/**
+ * Square band matrix in LAPACK band storage (as taken by dgbtrf).
+ *
+ * Columns are stored one after the other, each in `ldab() = 2 kl + ku + 1` slots: entry (i, j)
+ * of the band, max(0, j - ku) <= i <= min(n - 1, j + kl), is `data()[j*ldab() + kl + ku + i - j]`.
+ * The first kl slots of every column are not part of the matrix: they make room for the
+ * fill-in of BandLUDecomposition, whose upper factor has kl + ku super-diagonals.
+ */
+class BandMatrix {
+public:
+    BandMatrix() = default;
+    /// n by n zero matrix with kl sub-diagonals and ku super-diagonals
+    BandMatrix(size_t n, size_t kl, size_t ku);
+
+    /// Band copy of a dense matrix (with its own bandwidth, see bandwidth(const Matrix &))
+    static BandMatrix fromDense(const Matrix &A);
+    /// Band copy of a dense matrix with the given bandwidth
+    /// @throws MatrixError if A has non-zero entries outside the band
+    static BandMatrix fromDense(const Matrix &A, size_t kl, size_t ku);
+    /// Band copy of a sparse matrix (with the bandwidth of its stored entries)
+    static BandMatrix fromSparse(const SparseMatrix &A);
+
+    // Getters:
+    inline size_t size() const { return _n; }
+    inline size_t lower() const { return _kl; }  ///< kl, the number of sub-diagonals
+    inline size_t upper() const { return _ku; }  ///< ku, the number of super-diagonals
+    inline size_t ldab() const { return 2*_kl + _ku + 1; }  ///< leading dimension of the storage
+    inline const std::vector<double> &data() const { return _data; }
+    inline std::vector<double> &data() { return _data; }
+
+    /// Whether (i, j) lies within the band
+    inline bool inBand(index_t i, index_t j) const { return i <= j + _kl and j <= i + _ku; }
+
+    /// Entry (i, j), zero outside the band. Has bounds checking.
+    double operator()(index_t i, index_t j) const;
+    /// Entry (i, j) within the band (no checks)
+    inline double &at(index_t i, index_t j) { return _data[j*ldab() + _kl + _ku + i - j]; }
+    inline double at(index_t i, index_t j) const { return _data[j*ldab() + _kl + _ku + i - j]; }
+
+    /// Set entry (i, j)
+    /// @throws std::out_of_range if (i, j) lies outside the matrix or the band
+    void set(index_t i, index_t j, double value);
+
+    Matrix toDense() const;
+
+private:
+    size_t _n = 0;
+    size_t _kl = 0, _ku = 0;
+    std::vector<double> _data;
+};
+
+
+Vector operator*(const BandMatrix &A, const Vector &v);
+
+
+#endif //LU_BANDMATRIX_H
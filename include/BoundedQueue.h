@@ -0,0 +1,64 @@
+#ifndef LU_BOUNDEDQUEUE_H
+#define LU_BOUNDEDQUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include "aliases.h"
+
+
+/// Blocking FIFO queue with a maximum size, for producer/consumer hand-offs
+template<typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : _capacity(capacity ? capacity : 1) {}
+
+    /// Block while the queue is full. Returns false (dropping `item`) if the queue was closed.
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notFull.wait(lock, [this] { return _closed or _items.size() < _capacity; });
+        if (_closed) return false;
+        _items.push_back(std::move(item));
+        if (_items.size() > _maxSize) _maxSize = _items.size();
+        _notEmpty.notify_one();
+        return true;
+    }
+
+    /// Block while the queue is empty. Returns false once it's closed and drained.
+    bool pop(T &item) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notEmpty.wait(lock, [this] { return _closed or not _items.empty(); });
+        if (_items.empty()) return false;
+        item = std::move(_items.front());
+        _items.pop_front();
+        _notFull.notify_one();
+        return true;
+    }
+
+    /// No more items will be pushed; wakes up every waiting thread
+    void close() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _closed = true;
+        _notEmpty.notify_all();
+        _notFull.notify_all();
+    }
+
+    inline size_t capacity() const { return _capacity; }
+
+    /// Largest number of items that were waiting in the queue at any time
+    size_t maxSize() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _maxSize;
+    }
+
+private:
+    const size_t _capacity;
+    std::deque<T> _items;
+    size_t _maxSize = 0;
+    bool _closed = false;
+    std::mutex _mutex;
+    std::condition_variable _notEmpty, _notFull;
+};
+
+
+#endif //LU_BOUNDEDQUEUE_H
@@ -0,0 +1,111 @@
+#ifndef LU_CHOLESKY_H
+#define LU_CHOLESKY_H
+
+#include <vector>
+#include "LUDecomposition.h"
+#include "Matrix.h"
+#include "PackedMatrix.h"
+#include "Permutation.h"
+#include "numcomp.h"
+
+
+/// Columns processed at a time by CholeskyDecomposition
+const size_t CHOLESKY_BLOCK_SIZE = 64;
+
+/// Trailing rows below which CholeskyDecomposition updates serially even if asked to go parallel
+const size_t CHOLESKY_PARALLEL_MIN_ROWS = 256;
+
+
+/**
+ * Cholesky decomposition A = LL^T of a symmetric positive definite matrix.
+ *
+ * Only the lower triangle of A is read, and L is kept in packed storage (see PackedMatrix):
+ * half the memory and a third of the operations of LUDecomposition (n^3/3 flops), and no
+ * pivoting. The factorization is blocked by CHOLESKY_BLOCK_SIZE columns: each block column is
+ * factored, then subtracted from the trailing rows with dot products of block length, which
+ * keep a row of the panel in cache; those updates can run on the shared thread pool.
+ */
+class CholeskyDecomposition {
+public:
+    /**
+     * Compute the Cholesky decomposition of a matrix.
+     * @param A  symmetric matrix to decompose (only the lower triangle is read)
+     * @param tol  numerical tolerance: the matrix is deemed not positive definite if the square
+     * of a diagonal entry of L is smaller than this
+     * @param parallel  update the trailing rows on the shared thread pool
+     * @throws SingularMatrixError if A isn't (numerically) positive definite
+     */
+    explicit CholeskyDecomposition(const Matrix &A, double tol = numcomp::DEFAULT_TOL, bool parallel = false);
+    /// Likewise, for a matrix in packed storage
+    explicit CholeskyDecomposition(const PackedMatrix &A, double tol = numcomp::DEFAULT_TOL, bool parallel = false);
+    CholeskyDecomposition() = default;
+
+    /// Exception-free counterpart of the constructor (see LUDecomposition::tryFactor)
+    LUStatus tryFactor(const Matrix &A, double tol = numcomp::DEFAULT_TOL, bool parallel = false);
+    LUStatus tryFactor(const PackedMatrix &A, double tol = numcomp::DEFAULT_TOL, bool parallel = false);
+
+    // getters:
+    inline size_t size() const { return _L.size(); }
+    /// L, lower triangular (the packed matrix stands for its lower triangle here)
+    inline const PackedMatrix &factor() const { return _L; }
+    inline double tol() const { return _tol; }
+
+private:
+    PackedMatrix _L;
+    double _tol = numcomp::DEFAULT_TOL;  ///< numerical tolerance
+
+    LUStatus decompose(bool parallel);
+};
+
+
+/**
+ * LDL^T decomposition with Bunch-Kaufman pivoting, PAP^T = LDL^T, of a symmetric (possibly
+ * indefinite) matrix.
+ *
+ * D is block diagonal with 1x1 and 2x2 blocks, L unit lower triangular and P a symmetric
+ * permutation, chosen so that the entries of L stay bounded: a stable alternative to
+ * LUDecomposition for symmetric matrices which aren't positive definite, with the memory and
+ * operations of CholeskyDecomposition. Everything is stored in packed form.
+ */
+class LDLTDecomposition {
+public:
+    /**
+     * Compute the LDL^T decomposition of a matrix.
+     * @param A  symmetric matrix to decompose (only the lower triangle is read)
+     * @param tol  numerical tolerance: the matrix is deemed singular if, at some step, the
+     * column left to eliminate is smaller than this
+     * @throws SingularMatrixError if A is singular
+     */
+    explicit LDLTDecomposition(const Matrix &A, double tol = numcomp::DEFAULT_TOL);
+    /// Likewise, for a matrix in packed storage
+    explicit LDLTDecomposition(const PackedMatrix &A, double tol = numcomp::DEFAULT_TOL);
+    LDLTDecomposition() = default;
+
+    /// Exception-free counterpart of the constructor (see LUDecomposition::tryFactor)
+    LUStatus tryFactor(const Matrix &A, double tol = numcomp::DEFAULT_TOL);
+    LUStatus tryFactor(const PackedMatrix &A, double tol = numcomp::DEFAULT_TOL);
+
+    // getters:
+    inline size_t size() const { return _LDL.size(); }
+    /**
+     * D on the diagonal (and at (k + 1, k) for a 2x2 block starting at k), L (unit diagonal)
+     * elsewhere below it
+     */
+    inline const PackedMatrix &factors() const { return _LDL; }
+    /// Whether a 2x2 block of D starts at k
+    inline bool isTwoByTwo(index_t k) const { return _twoByTwo[k]; }
+    /// Symmetric permutation: row and column perm()[k] of A are row and column k of PAP^T
+    inline const Permutation::Vector &perm() const { return _perm; }
+    inline double tol() const { return _tol; }
+
+private:
+    PackedMatrix _LDL;
+    std::vector<char> _twoByTwo;
+    Permutation::Vector _perm;
+    double _tol = numcomp::DEFAULT_TOL;  ///< numerical tolerance
+
+    LUStatus decompose();
+};
+
+
+#endif //LU_CHOLESKY_H
@@ -0,0 +1,67 @@
+#ifndef LU_KRONECKER_H
+#define LU_KRONECKER_H
+
+#include <vector>
+#include "LUDecomposition.h"
+#include "Matrix.h"
+#include "Vector.h"
+#include "numcomp.h"
+
+
+/// Kronecker systems of at least this size are solved on the thread pool
+const size_t KRONECKER_PARALLEL_MIN_SIZE = 1u << 14u;
+
+
+/**
+ * Linear system with a Kronecker product matrix A_0 ⊗ A_1 ⊗ ... ⊗ A_(d-1), solved through the
+ * LU decompositions of its factors alone: the N = n_0 n_1 ... n_(d-1) unknowns are read as a
+ * row-major n_0 x n_1 x ... tensor (x[i*n_1 + j] is X(i, j) for two factors, so that
+ * (A ⊗ B) x = vec(A X B^T)), and the inverse of each factor is applied along its own index,
+ * as multi-RHS triangular solves. That takes N (n_0 + ... + n_(d-1)) operations per solve and
+ * the factors' n_m^3 to decompose, against N^3 for the whole matrix (whose N^2 entries never get
+ * stored).
+ */
+class KroneckerSystem {
+public:
+    /**
+     * Decompose the factors of a Kronecker product.
+     * @param factors  A_0, A_1, ..., the outermost first
+     * @param tol  numerical tolerance of their LU decompositions
+     * @throws MatrixError if there are no factors, or an empty one
+     * @throws SingularMatrixError if a factor (and so the product) is singular
+     */
+    explicit KroneckerSystem(const std::vector<Matrix> &factors, double tol = numcomp::DEFAULT_TOL);
+    /// The system with matrix A ⊗ B
+    KroneckerSystem(const Matrix &A, const Matrix &B, double tol = numcomp::DEFAULT_TOL);
+    KroneckerSystem() = default;
+
+    /**
+     * Exception-free counterpart of the constructor (only throws MatrixError for no or empty factors):
+     * on failure, the status pivot is that of the LU decomposition of factor failedFactor()
+     */
+    LUStatus tryFactor(const std::vector<Matrix> &factors, double tol = numcomp::DEFAULT_TOL);
+
+    // getters:
+    inline size_t size() const { return _size; }  ///< N, the product of the sizes of the factors
+    inline size_t factorCount() const { return _factors.size(); }
+    inline const std::vector<LUDecomposition> &factors() const { return _factors; }
+    inline index_t failedFactor() const { return _failedFactor; }
+    inline double tol() const { return _tol; }
+
+private:
+    std::vector<LUDecomposition> _factors;
+    size_t _size = 0;
+    index_t _failedFactor = 0;
+    double _tol = numcomp::DEFAULT_TOL;  ///< numerical tolerance
+};
+
+
+/// Product (A_0 ⊗ A_1 ⊗ ...) x in N (n_0 + n_1 + ...) operations, the Kronecker product never being formed
+/// @throws MatrixError if there are no factors, an empty one, or x hasn't the size of the product
+Vector kroneckerProduct(const std::vector<Matrix> &factors, const Vector &x);
+
+/// Dense Kronecker product A ⊗ B, of size A.size() B.size()
+Matrix kroneckerProduct(const Matrix &A, const Matrix &B);
+
+
+#endif //LU_KRONECKER_H
@@ -11,6 +11,23 @@
 #include "numcomp.h"
 
 
+/// Outcome of an exception-free factorization
+struct LUStatus {
+    bool success = true;
+    index_t pivot = 0;  ///< index of the pivot at which the factorization failed (if unsuccessful)
+
+    inline explicit
+    operator bool() const { return success; }
+
+    static LUStatus singularAt(index_t pivot) {
+        LUStatus status;
+        status.success = false;
+        status.pivot = pivot;
+        return status;
+    }
+};
+
+
 /// This class handles the LU decomposition of a matrix
 class LUDecomposition {
 public:
@@ -23,6 +40,41 @@ public:
     explicit LUDecomposition(const Matrix &mat, double tol = numcomp::DEFAULT_TOL);
     LUDecomposition() = default;
 
+    /**
+     * Exception-free counterpart of the constructor: (re)compute the LU decomposition
+     * of `mat` into this object.
+     * @param mat  matrix to decompose
+     * @param tol  numerical tolerance
+     * @return  a status which evaluates to `false` if `mat` is singular; in that case
+     *          the contents of this object are unspecified until the next successful call
+     */
+    LUStatus tryFactor(const Matrix &mat, double tol = numcomp::DEFAULT_TOL);
+
+    /**
+     * Border the decomposed matrix A with a new last row and column,
+     *
+     *     A' = [A    col ]
+     *          [row  diag]
+     *
+     * extending L and U in O(n^2) instead of refactoring: the new row of L solves U^T l = row,
+     * the new column of U solves L u = P col, and the new pivot is diag - l u (the new row being
+     * the only candidate, as the permutation only grows by a fixed point). The pivot is singular
+     * when smaller than tol() times the largest entry of the new row (diag included).
+     * @return  a status which evaluates to `false` (pivot n) if A' is singular; in that case
+     *          the decomposition of A is left as it was
+     * @throws MatrixError if row or col hasn't the size of A
+     */
+    LUStatus appendRowCol(const Vector &row, const Vector &col, double diag);
+
+    /**
+     * Remove the last row and column of the decomposed matrix: O(n^2) if the last row of A is
+     * still the last of PA (as after appendRowCol), otherwise A is rebuilt from its factors and
+     * its leading block refactored, in O(n^3).
+     * @return  a status which evaluates to `false` if the leading block is singular (see tryFactor)
+     * @throws MatrixError if the matrix is empty
+     */
+    LUStatus removeLast();
+
     // getters:
     inline const Permutation &perm() const { return _perm; }
     inline const Matrix &decompMatrix() const { return _mat; }
@@ -34,10 +86,13 @@ private:
     double _tol = numcomp::DEFAULT_TOL;  ///< numerical tolerance
 
     /// Performs the actual LU decomposition. Called upon construction.
-    void decompose();
+    LUStatus decompose();
 
-    /// Swaps the row at pivot_index with the row with the (relatively) largest pivot.
-    void scaledPartialPivoting(index_t pivot_index);
+    /**
+     * Swaps the row at pivot_index with the row with the (relatively) largest pivot.
+     * @return  false if no acceptable pivot exists (i.e. the matrix is singular)
+     */
+    bool scaledPartialPivoting(index_t pivot_index);
 };
 
 
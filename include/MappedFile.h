@@ -0,0 +1,39 @@
+#ifndef LU_MAPPEDFILE_H
+#define LU_MAPPEDFILE_H
+
+#include <string>
+#include "aliases.h"
+
+
+/// Read-only view of a whole file's contents, memory-mapped when possible
+class MappedFile {
+public:
+    /**
+     * Map the file at `path` into memory.
+     * @param path  path to the file
+     * @throws IOError if the file can't be opened or read
+     */
+    explicit MappedFile(const char *path);
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    ~MappedFile();
+
+    // getters:
+    inline const char *data() const { return _data; }
+    inline size_t size() const { return _size; }
+    inline const char *begin() const { return _data; }
+    inline const char *end() const { return _data + _size; }
+
+private:
+    const char *_data = nullptr;
+    size_t _size = 0;
+    bool _mapped = false;  ///< whether _data is an mmap'ed region (otherwise it's owned by _buffer)
+    std::string _buffer;  ///< fallback storage for files that can't be mapped (e.g. pipes)
+
+    void release();
+};
+
+
+#endif //LU_MAPPEDFILE_H
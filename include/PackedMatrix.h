@@ -0,0 +1,52 @@
+#ifndef LU_PACKEDMATRIX_H
+#define LU_PACKEDMATRIX_H
+
+#include <vector>
+#include "aliases.h"
+#include "Matrix.h"
+#include "Vector.h"
+
+
+/**
+ * Symmetric (or lower triangular) square matrix, of which only the lower triangle is stored,
+ * packed by rows: row i holds columns 0 <= j <= i at `data()[i*(i + 1)/2 + j]`, in n(n + 1)/2
+ * entries overall. Rows being contiguous, the dot products of the symmetric factorizations
+ * (see CholeskyDecomposition) run over adjacent memory.
+ */
+class PackedMatrix {
+public:
+    /// n by n zero matrix
+    explicit PackedMatrix(size_t n) : _n(n), _data(n*(n + 1)/2, 0.0) {}
+    PackedMatrix() = default;
+
+    /// Packed copy of the lower triangle of a dense matrix (the upper one is ignored)
+    static PackedMatrix fromDense(const Matrix &A);
+
+    // Getters:
+    inline size_t size() const { return _n; }
+    inline const std::vector<double> &data() const { return _data; }
+    inline std::vector<double> &data() { return _data; }
+    /// Start of row i (columns 0 to i)
+    inline const double *row(index_t i) const { return _data.data() + i*(i + 1)/2; }
+    inline double *row(index_t i) { return _data.data() + i*(i + 1)/2; }
+
+    /// Entry (i, j) of the symmetric matrix, for any i and j. Has bounds checking.
+    double operator()(index_t i, index_t j) const;
+    /// Entry (i, j) of the lower triangle, j <= i (no checks)
+    inline double &at(index_t i, index_t j) { return _data[i*(i + 1)/2 + j]; }
+    inline double at(index_t i, index_t j) const { return _data[i*(i + 1)/2 + j]; }
+
+    /// The symmetric matrix, both triangles filled
+    Matrix toDense() const;
+
+private:
+    size_t _n = 0;
+    std::vector<double> _data;
+};
+
+
+/// Product of the symmetric matrix A by v
+Vector operator*(const PackedMatrix &A, const Vector &v);
+
+
+#endif //LU_PACKEDMATRIX_H
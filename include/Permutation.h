@@ -18,6 +18,11 @@ public:
     Permutation() = default;
 
     void permute(index_t a, index_t b);
+    /// Append an element mapped to itself (the parity doesn't change)
+    void extend();
+    /// Remove the last element, which must be mapped to itself
+    /// @throws std::invalid_argument if it isn't
+    void shrink();
     inline const Vector &vector() const { return _vec; }
     inline bool parity() const { return _parity; }  ///< 0 if even, 1 if odd
 
@@ -26,5 +31,8 @@ private:
     bool _parity = false;
 };
 
+/// Parity of a permutation given as a vector (0 if even, 1 if odd)
+bool permutationParity(const Permutation::Vector &perm);
+
 
 #endif //LU_PERMUTATION_H
@@ -0,0 +1,62 @@
+#ifndef LU_SCANNER_H
+#define LU_SCANNER_H
+
+#include "aliases.h"
+#include "MappedFile.h"
+
+
+/**
+ * Whitespace-separated token reader over an in-memory character range
+ * (typically a MappedFile). Numbers are parsed in place, without going
+ * through iostreams or the locale machinery.
+ */
+class Scanner {
+public:
+    Scanner(const char *first, const char *last) : _begin(first), _pos(first), _end(last) {}
+    explicit Scanner(const MappedFile &file) : Scanner(file.begin(), file.end()) {}
+
+    /**
+     * Parse a non-negative integer.
+     * @param what  description of what's being parsed, used in error messages
+     * @throws BadFormat (with the current byte offset) if there's no valid integer
+     */
+    size_t readIndex(const char *what);
+
+    /**
+     * Parse a floating point number.
+     * @param what  description of what's being parsed, used in error messages
+     * @throws BadFormat (with the current byte offset) if there's no valid number
+     */
+    double readDouble(const char *what);
+
+    /// Whether only whitespace remains
+    bool atEnd();
+
+    /// Skip the next token (without parsing it)
+    void skipToken();
+
+    /// Move to `pos`, which must lie within the scanned range
+    inline void seek(const char *pos) { _pos = pos; }
+
+    // getters:
+    inline size_t offset() const { return size_t(_pos - _begin); }  ///< bytes consumed so far
+    inline const char *position() const { return _pos; }
+    inline const char *begin() const { return _begin; }
+    inline const char *end() const { return _end; }
+
+private:
+    const char *_begin, *_pos, *_end;
+
+    void skipSpace();
+    double readDoubleSlow(const char *what);
+};
+
+
+/// Whether `c` is a token separator
+inline
+bool isSpace(char c) {
+    return c == ' ' or c == '\n' or c == '\t' or c == '\r' or c == '\v' or c == '\f';
+}
+
+
+#endif //LU_SCANNER_H
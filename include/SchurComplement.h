@@ -0,0 +1,71 @@
+#ifndef LU_SCHURCOMPLEMENT_H
+#define LU_SCHURCOMPLEMENT_H
+
+#include <vector>
+#include "LUDecomposition.h"
+#include "Matrix.h"
+#include "Vector.h"
+#include "numcomp.h"
+
+
+/**
+ * Block LU decomposition of a bordered (2 x 2 block) matrix
+ *
+ *     M = [A  B]
+ *         [C  D]
+ *
+ * with A n by n and already factored, D m by m (typically m << n): the Schur complement
+ * S = D - C A^-1 B takes m solves with A (one multi-RHS solve) and a product, and only S gets
+ * factored anew. A^-1 B is kept (coupling()), so that a new D only refactors S (see setD).
+ * The unknowns and right-hand sides of M are those of A followed by those of D.
+ */
+class SchurComplementDecomposition {
+public:
+    /**
+     * Factor a bordered matrix given the LU decomposition of its leading block.
+     * @param luA  LU decomposition of A (moved in, see getA(): pass a copy to keep it)
+     * @param B  columns of B, m vectors of size n
+     * @param C  rows of C, m vectors of size n
+     * @param D  trailing block
+     * @param tol  numerical tolerance of the LU decomposition of S
+     * @throws MatrixError if the blocks' sizes don't match
+     * @throws SingularMatrixError if S (and so M) is singular
+     */
+    SchurComplementDecomposition(LUDecomposition &&luA, const std::vector<Vector> &B, std::vector<Vector> C,
+                                 const Matrix &D, double tol = numcomp::DEFAULT_TOL);
+    SchurComplementDecomposition() = default;
+
+    /**
+     * Exception-free counterpart of the constructor (only throws MatrixError for mismatched sizes).
+     * On failure, the status pivot is n plus that of S.
+     */
+    LUStatus tryFactor(LUDecomposition &&luA, const std::vector<Vector> &B, std::vector<Vector> C,
+                       const Matrix &D, double tol = numcomp::DEFAULT_TOL);
+
+    /**
+     * Replace the trailing block, refactoring S only (O(m^2 n + m^3)).
+     * @return  a status as tryFactor's
+     * @throws MatrixError if D hasn't the size of the old one
+     */
+    LUStatus setD(const Matrix &D);
+
+    // getters:
+    inline size_t size() const { return leadingSize() + borderSize(); }
+    inline size_t leadingSize() const { return _luA.decompMatrix().size(); }  ///< n
+    inline size_t borderSize() const { return _C.size(); }  ///< m
+    inline const LUDecomposition &getA() const { return _luA; }
+    inline const LUDecomposition &getSchur() const { return _luS; }  ///< LU decomposition of S
+    inline const std::vector<Vector> &coupling() const { return _coupling; }  ///< columns of A^-1 B
+    inline const std::vector<Vector> &lowerBorder() const { return _C; }  ///< rows of C
+    inline double tol() const { return _tol; }
+
+private:
+    LUDecomposition _luA;
+    LUDecomposition _luS;
+    std::vector<Vector> _coupling;
+    std::vector<Vector> _C;
+    double _tol = numcomp::DEFAULT_TOL;  ///< numerical tolerance
+};
+
+
+#endif //LU_SCHURCOMPLEMENT_H
@@ -0,0 +1,83 @@
+#ifndef LU_SKYLINELU_H
+#define LU_SKYLINELU_H
+
+#include "SkylineMatrix.h"
+#include "LUDecomposition.h"
+#include "numcomp.h"
+
+
+/**
+ * LU decomposition of a skyline matrix, without pivoting.
+ *
+ * Without row interchanges L keeps the row envelope of A and U its column envelope, so the
+ * factors overwrite a copy of A in place: memory and operations depend on the size of the
+ * profile rather than on n². The price is stability: this suits matrices that don't need
+ * pivoting (e.g. diagonally dominant ones), and fails on a (numerically) zero pivot.
+ */
+class SkylineLUDecomposition {
+public:
+    /**
+     * Compute the LU decomposition of a skyline matrix.
+     * @param A  matrix to decompose (if symmetric, it gets expanded, see SkylineLDLTDecomposition)
+     * @param tol  numerical tolerance: the matrix is deemed singular if a pivot is smaller than
+     * this (in absolute value)
+     * @throws SingularMatrixError if a pivot is (numerically) zero
+     */
+    explicit SkylineLUDecomposition(const SkylineMatrix &A, double tol = numcomp::DEFAULT_TOL);
+    SkylineLUDecomposition() = default;
+
+    /// Exception-free counterpart of the constructor (see LUDecomposition::tryFactor)
+    LUStatus tryFactor(const SkylineMatrix &A, double tol = numcomp::DEFAULT_TOL);
+
+    // getters:
+    inline size_t size() const { return _LU.size(); }
+    /// U on and above the diagonal, the multipliers of L (unit diagonal) below it
+    inline const SkylineMatrix &factors() const { return _LU; }
+    inline double tol() const { return _tol; }
+
+private:
+    SkylineMatrix _LU;
+    double _tol = numcomp::DEFAULT_TOL;  ///< numerical tolerance
+
+    LUStatus decompose();
+};
+
+
+/**
+ * LDL^T decomposition of a symmetric skyline matrix, without pivoting.
+ *
+ * Like SkylineLUDecomposition, L keeps the envelope of A; only the lower part is stored,
+ * which halves memory and operations. Best suited to positive definite matrices: indefinite
+ * ones may need pivoting this can't do.
+ */
+class SkylineLDLTDecomposition {
+public:
+    /**
+     * Compute the LDL^T decomposition of a symmetric skyline matrix.
+     * @param A  matrix to decompose
+     * @param tol  numerical tolerance: the matrix is deemed singular if an entry of D is smaller
+     * than this (in absolute value)
+     * @throws MatrixError if A isn't stored as symmetric
+     * @throws SingularMatrixError if an entry of D is (numerically) zero
+     */
+    explicit SkylineLDLTDecomposition(const SkylineMatrix &A, double tol = numcomp::DEFAULT_TOL);
+    SkylineLDLTDecomposition() = default;
+
+    /// Exception-free counterpart of the constructor (only throws MatrixError for non-symmetric A)
+    LUStatus tryFactor(const SkylineMatrix &A, double tol = numcomp::DEFAULT_TOL);
+
+    // getters:
+    inline size_t size() const { return _LDL.size(); }
+    /// D on the diagonal, L (unit diagonal) below it
+    inline const SkylineMatrix &factors() const { return _LDL; }
+    inline double tol() const { return _tol; }
+
+private:
+    SkylineMatrix _LDL;
+    double _tol = numcomp::DEFAULT_TOL;  ///< numerical tolerance
+
+    LUStatus decompose();
+};
+
+
+#endif //LU_SKYLINELU_H
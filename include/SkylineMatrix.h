@@ -0,0 +1,90 @@
+#ifndef LU_SKYLINEMATRIX_H
+#define LU_SKYLINEMATRIX_H
+
+#include <vector>
+#include "aliases.h"
+#include "Matrix.h"
+#include "SparseMatrix.h"
+#include "Vector.h"
+
+
+/**
+ * Square matrix in skyline (profile, or variable band) storage.
+ *
+ * The strictly lower part is stored by rows, each from its first non-zero entry up to the
+ * diagonal: row i holds columns rowStart(i) <= j < i at `lowerValues()[lowerPointers()[i] + j - rowStart(i)]`.
+ * The strictly upper part is stored by columns in the same way, from row columnStart(j), and the
+ * diagonal on its own. The envelope is everything in between, zeros included: it's what
+ * SkylineLUDecomposition fills in, so that the factors need no memory beyond it.
+ *
+ * A symmetric skyline matrix only stores its lower part (and the diagonal).
+ */
+class SkylineMatrix {
+public:
+    SkylineMatrix() = default;
+
+    /// Skyline copy of a dense matrix (with the envelope of its non-zero entries)
+    static SkylineMatrix fromDense(const Matrix &A, bool symmetric = false);
+    /**
+     * Skyline copy of a sparse matrix (with the envelope of its stored entries)
+     * @param symmetric  keep only the lower part
+     * @throws MatrixError if symmetric is true but A isn't
+     */
+    static SkylineMatrix fromSparse(const SparseMatrix &A, bool symmetric = false);
+
+    // Getters:
+    inline size_t size() const { return _diagonal.size(); }
+    inline bool isSymmetric() const { return _symmetric; }
+    /// Number of stored entries, i.e. the size of the envelope
+    inline size_t profileSize() const { return size() + _lowerValues.size() + _upperValues.size(); }
+    /// First column of the envelope of row i (i if there's nothing left of the diagonal)
+    inline index_t rowStart(index_t i) const { return i - (_lowerPointers[i + 1] - _lowerPointers[i]); }
+    /// First row of the envelope of column j (j if there's nothing above the diagonal)
+    inline index_t columnStart(index_t j) const {
+        return _symmetric ? rowStart(j) : j - (_upperPointers[j + 1] - _upperPointers[j]);
+    }
+
+    inline const std::vector<double> &diagonal() const { return _diagonal; }
+    inline std::vector<double> &diagonal() { return _diagonal; }
+    inline const std::vector<size_t> &lowerPointers() const { return _lowerPointers; }
+    inline const std::vector<double> &lowerValues() const { return _lowerValues; }
+    inline std::vector<double> &lowerValues() { return _lowerValues; }
+    /// Upper part, by columns (the same as the lower part if the matrix is symmetric)
+    inline const std::vector<size_t> &upperPointers() const { return _symmetric ? _lowerPointers : _upperPointers; }
+    inline const std::vector<double> &upperValues() const { return _symmetric ? _lowerValues : _upperValues; }
+    inline std::vector<double> &upperValues() { return _symmetric ? _lowerValues : _upperValues; }
+
+    /// Whether (i, j) lies within the envelope
+    inline bool inProfile(index_t i, index_t j) const { return i >= j ? j >= rowStart(i) : i >= columnStart(j); }
+
+    /// Entry (i, j), zero outside the envelope. Has bounds checking.
+    double operator()(index_t i, index_t j) const;
+    /// Entry (i, j) within the envelope (no checks)
+    inline double &at(index_t i, index_t j) {
+        if (i == j) return _diagonal[i];
+        if (i > j) return _lowerValues[_lowerPointers[i] + j - rowStart(i)];
+        return upperValues()[upperPointers()[j] + i - columnStart(j)];
+    }
+    inline double at(index_t i, index_t j) const { return const_cast<SkylineMatrix *>(this)->at(i, j); }
+
+    /// The same matrix with both parts stored (a copy, if it already is)
+    SkylineMatrix expanded() const;
+    Matrix toDense() const;
+
+private:
+    bool _symmetric = false;
+    std::vector<double> _diagonal;
+    std::vector<size_t> _lowerPointers = {0};  ///< start of each row of the lower part, plus the end
+    std::vector<double> _lowerValues;
+    std::vector<size_t> _upperPointers = {0};  ///< start of each column of the upper part, plus the end
+    std::vector<double> _upperValues;
+
+    /// n by n zero matrix with the envelope given by the first row (column) of each column (row)
+    SkylineMatrix(const std::vector<index_t> &rowStarts, const std::vector<index_t> &columnStarts, bool symmetric);
+};
+
+
+Vector operator*(const SkylineMatrix &A, const Vector &v);
+
+
+#endif //LU_SKYLINEMATRIX_H
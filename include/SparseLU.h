@@ -0,0 +1,103 @@
+#ifndef LU_SPARSELU_H
+#define LU_SPARSELU_H
+
+#include "LUDecomposition.h"
+#include "Permutation.h"
+#include "SparseMatrix.h"
+#include "numcomp.h"
+
+
+/**
+ * Fill-reducing ordering of a sparse matrix: minimum degree on the pattern of A + A^T.
+ * Nodes of very high degree (dense rows/columns) are ordered last.
+ * @return  q such that column q[k] of A is the k-th to be eliminated
+ */
+Permutation::Vector minimumDegreeOrdering(const SparseMatrix &A);
+
+
+/**
+ * Sparse LU decomposition PAQ = LU (left-looking, Gilbert-Peierls).
+ *
+ * Columns are taken in a fill-reducing order Q (minimum degree, see minimumDegreeOrdering).
+ * Each column of L and U comes from a sparse triangular solve with the columns computed
+ * so far, whose non-zero pattern is found beforehand by a depth-first search in the graph
+ * of L; the cost is thus proportional to the arithmetic, not to n. Rows are chosen by
+ * threshold partial pivoting: the diagonal entry is kept if it isn't smaller than
+ * `threshold` times the largest candidate, which preserves the symmetric ordering.
+ *
+ * Matrices sharing a sparsity pattern (e.g. the Jacobians of a Newton iteration) are
+ * better factored once with tryFactor and then with refactor: the column ordering, the
+ * patterns of L and U and the pivot sequence are kept, and only the numeric values
+ * are recomputed, with no graph searches nor memory allocation.
+ */
+class SparseLUDecomposition {
+public:
+    static constexpr double DEFAULT_THRESHOLD = 0.1;
+    /// Pivots kept by refactor may fall below DEFAULT_THRESHOLD, as long as they stay above this
+    static constexpr double DEFAULT_REFACTOR_THRESHOLD = 1e-3;
+
+    /**
+     * Compute the sparse LU decomposition of a matrix.
+     * @param A  matrix to decompose
+     * @param tol  numerical tolerance: pivots smaller than this (in absolute value) are rejected
+     * @param threshold  relative pivot threshold in (0, 1] (1 is plain partial pivoting)
+     * @throws SingularMatrixError if A is singular
+     */
+    explicit SparseLUDecomposition(const SparseMatrix &A, double tol = numcomp::DEFAULT_TOL,
+                                   double threshold = DEFAULT_THRESHOLD);
+    SparseLUDecomposition() = default;
+
+    /// Exception-free counterpart of the constructor (see LUDecomposition::tryFactor)
+    LUStatus tryFactor(const SparseMatrix &A, double tol = numcomp::DEFAULT_TOL,
+                       double threshold = DEFAULT_THRESHOLD);
+
+    /**
+     * Factor a matrix with the same pattern as the last one given to tryFactor (or the
+     * constructor), reusing its analysis and pivot sequence. If a static pivot is no longer
+     * acceptable (smaller than tol, or than `threshold` times the largest entry below it),
+     * the factorization falls back to pivoting again, keeping the column ordering.
+     * @throws std::invalid_argument if the pattern differs
+     */
+    LUStatus refactor(const SparseMatrix &A, double threshold = DEFAULT_REFACTOR_THRESHOLD);
+
+    /**
+     * Like refactor(const SparseMatrix &), taking just the new values, in the order
+     * of `values()` of the matrix that was analysed.
+     */
+    LUStatus refactor(const std::vector<double> &values, double threshold = DEFAULT_REFACTOR_THRESHOLD);
+
+    /// Whether the last (re)factorization kept the previous pivot sequence
+    inline bool reusedPivots() const { return _reusedPivots; }
+
+    // getters:
+    inline size_t size() const { return _L.size(); }
+    /// Unit lower triangular factor in CSC layout (the diagonal comes first in each column)
+    inline const SparseMatrix &lower() const { return _L; }
+    /// Upper triangular factor in CSC layout (the diagonal comes last in each column)
+    inline const SparseMatrix &upper() const { return _U; }
+    /// Row permutation: row rowPerm()[k] of A is the k-th pivot row
+    inline const Permutation::Vector &rowPerm() const { return _rowPerm; }
+    /// Column permutation: column colPerm()[k] of A is the k-th pivot column
+    inline const Permutation::Vector &colPerm() const { return _colPerm; }
+    inline double tol() const { return _tol; }
+    inline size_t nnz() const { return _L.nnz() + _U.nnz(); }  ///< stored entries of L and U
+    bool parity() const;  ///< 0 if both permutations together are even, 1 if odd
+
+private:
+    SparseMatrix _L, _U;
+    Permutation::Vector _rowPerm, _colPerm;
+    double _tol = numcomp::DEFAULT_TOL;  ///< numerical tolerance
+    double _threshold = DEFAULT_THRESHOLD;  ///< relative pivot threshold
+
+    SparseMatrix _A;  ///< matrix being factored, in CSC layout
+    std::vector<index_t> _valuePosition;  ///< position in the caller's values of each entry of _A (if CSR)
+    std::vector<index_t> _pivotOf;  ///< pivot position of each row of A (inverse of _rowPerm)
+    bool _reusedPivots = false;
+    bool _factored = false;  ///< whether L and U hold a complete factorization
+
+    LUStatus factor();  ///< numeric factorization with pivoting of _A
+    LUStatus refactor(double threshold);  ///< numeric factorization of _A with the current pivots
+};
+
+
+#endif //LU_SPARSELU_H
@@ -0,0 +1,128 @@
+#ifndef LU_SPARSEMATRIX_H
+#define LU_SPARSEMATRIX_H
+
+#include <cstdint>
+#include <vector>
+#include "aliases.h"
+#include "Matrix.h"
+#include "Vector.h"
+
+
+/// Compressed storage orientation: by rows (CSR) or by columns (CSC)
+enum class SparseLayout { CSR, CSC };
+
+/**
+ * Square sparse matrix in compressed storage.
+ *
+ * In CSR layout, the column indices and values of row i are stored in
+ * `indices()[k]`, `values()[k]` for `pointers()[i] <= k < pointers()[i + 1]`
+ * (and symmetrically for CSC). Indices within a row (column) are sorted and unique.
+ * `Index` is the integer type of the stored indices and pointers (a 32-bit type halves
+ * the index storage, as long as the number of stored entries fits).
+ */
+template<typename Index>
+class BasicSparseMatrix {
+public:
+    typedef Index index_type;
+
+    BasicSparseMatrix() = default;
+    /// n by n zero matrix
+    explicit BasicSparseMatrix(size_t n, SparseLayout layout = SparseLayout::CSR);
+    /// Take ownership of compressed data (checked for consistency)
+    BasicSparseMatrix(size_t n, SparseLayout layout, std::vector<Index> &&pointers,
+                      std::vector<Index> &&indices, std::vector<double> &&values);
+
+    /// Sparse copy of the non-zero entries of a dense matrix
+    static BasicSparseMatrix fromDense(const Matrix &A, SparseLayout layout = SparseLayout::CSR);
+
+    // Getters:
+    inline size_t size() const { return _n; }
+    inline size_t nnz() const { return _values.size(); }  ///< number of stored entries
+    inline SparseLayout layout() const { return _layout; }
+    inline const std::vector<Index> &pointers() const { return _pointers; }
+    inline const std::vector<Index> &indices() const { return _indices; }
+    inline const std::vector<double> &values() const { return _values; }
+    inline std::vector<double> &values() { return _values; }  ///< values can change, the pattern can't
+
+    /// Entry (i, j), zero if not stored. Has bounds checking.
+    double operator()(index_t i, index_t j) const;
+
+    /// The same matrix in the given layout
+    BasicSparseMatrix converted(SparseLayout layout) const;
+    /// The transpose matrix (in the same layout)
+    BasicSparseMatrix transposed() const;
+    Matrix toDense() const;
+
+private:
+    size_t _n = 0;  ///< dimension of matrix
+    SparseLayout _layout = SparseLayout::CSR;
+    std::vector<Index> _pointers = {0};  ///< start of each row (column), plus the end
+    std::vector<Index> _indices;  ///< column (row) index of each entry
+    std::vector<double> _values;
+
+    // Same data, compressed the other way round (i.e. the transpose in the same layout)
+    BasicSparseMatrix swapped() const;
+};
+
+typedef BasicSparseMatrix<index_t> SparseMatrix;
+typedef BasicSparseMatrix<std::uint32_t> SparseMatrix32;
+
+extern template class BasicSparseMatrix<index_t>;
+extern template class BasicSparseMatrix<std::uint32_t>;
+
+
+/**
+ * Accumulates (i, j, value) entries in any order and compresses them into a BasicSparseMatrix.
+ * Repeated entries resolve like in a dense matrix filled in the same order: the last one wins.
+ * Entries that end up zero are not stored.
+ */
+class TripletBuilder {
+public:
+    explicit TripletBuilder(size_t n) : _n(n) {}
+
+    /// Add the entry A[i][j] = value. Has bounds checking.
+    void add(index_t i, index_t j, double value);
+    void reserve(size_t m);
+
+    inline size_t size() const { return _n; }
+    inline size_t count() const { return _values.size(); }  ///< entries added so far
+
+    /// @throws std::overflow_error if the entries don't fit in `Index`
+    template<typename Index>
+    BasicSparseMatrix<Index> build(SparseLayout layout = SparseLayout::CSR) const;
+
+private:
+    size_t _n;
+    std::vector<index_t> _rows;
+    std::vector<index_t> _cols;
+    std::vector<double> _values;
+};
+
+extern template SparseMatrix TripletBuilder::build<index_t>(SparseLayout) const;
+extern template SparseMatrix32 TripletBuilder::build<std::uint32_t>(SparseLayout) const;
+
+
+/// Maximum fraction of non-zero entries for which a matrix is worth keeping sparse
+const double SPARSE_MAX_DENSITY = 0.05;
+
+/// Matrices smaller than this are always factored in dense storage
+const size_t SPARSE_MIN_SIZE = 100;
+
+/// Whether an n by n matrix with m stored entries should be kept in sparse storage
+inline bool preferSparse(size_t n, size_t m) {
+    return double(m) <= SPARSE_MAX_DENSITY*double(n)*double(n);
+}
+
+
+//-------------------- Sparse matrix operations -------------------//
+
+template<typename Index>
+Vector operator*(const BasicSparseMatrix<Index> &A, const Vector &v);
+
+template<typename Index>
+double norm1(const BasicSparseMatrix<Index> &A);
+
+template<typename Index>
+double normInf(const BasicSparseMatrix<Index> &A);
+
+#endif //LU_SPARSEMATRIX_H
@@ -0,0 +1,88 @@
+#ifndef LU_THREADPOOL_H
+#define LU_THREADPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "aliases.h"
+
+
+/// Fixed-size pool of worker threads consuming a FIFO task queue
+class ThreadPool {
+public:
+    /**
+     * Create a pool with nThreads workers. A pool without workers is valid: work
+     * submitted through parallelFor is then done by the calling thread alone.
+     */
+    explicit ThreadPool(unsigned nThreads = hardwareConcurrency());
+    ~ThreadPool();  ///< Finishes pending tasks and joins the workers
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /// Enqueue a callable; its result (or exception) is delivered through the returned future
+    template<typename F>
+    auto submit(F &&f) -> std::future<decltype(f())>;
+
+    /// Enqueue a fire-and-forget task
+    void post(std::function<void()> task);
+
+    inline unsigned size() const { return unsigned(_workers.size()); }
+
+    /**
+     * Process-wide pool shared by every parallel algorithm in the library, so that
+     * nested parallelism can't oversubscribe the machine.
+     */
+    static ThreadPool &shared();
+
+    /**
+     * Set the number of workers of the shared pool (by default, one per hardware
+     * thread). Only effective before the first call to shared().
+     */
+    static void configureShared(unsigned nThreads);
+
+    /// Number of hardware threads (at least 1)
+    static unsigned hardwareConcurrency();
+
+private:
+    std::vector<std::thread> _workers;
+    std::deque<std::function<void()>> _tasks;
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    bool _stop = false;
+
+    void workerLoop();
+};
+
+
+template<typename F>
+auto ThreadPool::submit(F &&f) -> std::future<decltype(f())> {
+    typedef decltype(f()) Result;
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(f));
+    std::future<Result> future = task->get_future();
+    post([task]() { (*task)(); });
+    return future;
+}
+
+
+/**
+ * Call f(0), ..., f(n - 1) in parallel on a pool. The calling thread takes part
+ * in the work, so it's safe to call this from within a pool task (tasks that
+ * can't be picked up by a free worker are simply run by the caller).
+ * The first exception thrown by f, if any, is rethrown once all calls finished.
+ */
+void parallelFor(ThreadPool &pool, size_t n, const std::function<void(index_t)> &f);
+
+/// parallelFor on the shared pool
+inline
+void parallelFor(size_t n, const std::function<void(index_t)> &f) {
+    parallelFor(ThreadPool::shared(), n, f);
+}
+
+
+#endif //LU_THREADPOOL_H
@@ -0,0 +1,63 @@
+#ifndef LU_TOEPLITZMATRIX_H
+#define LU_TOEPLITZMATRIX_H
+
+#include "aliases.h"
+#include "Matrix.h"
+#include "Vector.h"
+
+
+/// Products with Toeplitz matrices of at least this size go through the FFT (see convolution)
+const size_t TOEPLITZ_FFT_MIN_SIZE = 256;
+
+
+/**
+ * Square Toeplitz matrix: constant along each diagonal, A(i, j) = t_(i-j), so that its first
+ * column and first row (2n - 1 values) define it.
+ */
+class ToeplitzMatrix {
+public:
+    ToeplitzMatrix() = default;
+    /**
+     * Matrix with the given first column (t_0, t_1, ..., t_(n-1)) and first row (t_0, t_-1, ..., t_-(n-1))
+     * @throws MatrixError if they have different sizes, or disagree on t_0
+     */
+    ToeplitzMatrix(Vector column, Vector row);
+
+    /// Toeplitz copy of a dense matrix
+    /// @throws MatrixError if A isn't Toeplitz
+    static ToeplitzMatrix fromDense(const Matrix &A);
+
+    // Getters:
+    inline size_t size() const { return _column.size(); }
+    inline const Vector &column() const { return _column; }
+    inline const Vector &row() const { return _row; }
+    /// t_k, for -n < k < n
+    inline double diagonal(long k) const { return k >= 0 ? _column[k] : _row[-k]; }
+
+    /// Entry (i, j). Has bounds checking.
+    double operator()(index_t i, index_t j) const;
+
+    /// The transpose (first row and column swapped)
+    ToeplitzMatrix transposed() const;
+
+    Matrix toDense() const;
+
+private:
+    Vector _column;
+    Vector _row;
+};
+
+
+/// Product of a Toeplitz matrix by a vector (by FFT from TOEPLITZ_FFT_MIN_SIZE on)
+Vector operator*(const ToeplitzMatrix &A, const Vector &v);
+
+
+/**
+ * Entries 0 to length - 1 of the linear convolution of a and b, (a * b)_k = sum_j a_j b_(k-j).
+ * @param fft  compute it with the FFT (O(m log m) for m = a.size() + b.size()) instead of
+ * directly (O(length min(a.size(), b.size())))
+ */
+Vector convolution(const Vector &a, const Vector &b, size_t length, bool fft);
+
+
+#endif //LU_TOEPLITZMATRIX_H
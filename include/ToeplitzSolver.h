@@ -0,0 +1,70 @@
+#ifndef LU_TOEPLITZSOLVER_H
+#define LU_TOEPLITZSOLVER_H
+
+#include "LUDecomposition.h"
+#include "ToeplitzMatrix.h"
+#include "Vector.h"
+#include "numcomp.h"
+
+
+/// Levinson steps whose pivot is smaller than this (relative to 1) make ToeplitzDecomposition fall back to LU
+const double LEVINSON_MIN_PIVOT = 1e-8;
+
+
+/**
+ * Inverse of a Toeplitz matrix T in Gohberg-Semencul form: the Levinson-Trench recursion
+ * computes the first and last columns x and y of T^-1 in O(n^2) operations and O(n) memory, and
+ *
+ *     T^-1 = (L(x) U(Jy) - L(Zy) U(ZJx))/x_0
+ *
+ * where L(v) (U(v)) is the lower (upper) triangular Toeplitz matrix with first column (row) v,
+ * J reverses a vector and Z shifts it down. Each solve is then four triangular Toeplitz products,
+ * i.e. convolutions: O(n^2) directly, O(n log n) through the FFT.
+ *
+ * The recursion goes through the leading principal submatrices of T, so it needs them all to be
+ * well conditioned, which positive definite matrices guarantee but not every nonsingular one.
+ * When a step meets a pivot smaller than LEVINSON_MIN_PIVOT, the matrix gets an LUDecomposition
+ * instead (see isFallback()).
+ */
+class ToeplitzDecomposition {
+public:
+    /**
+     * Compute the inverse generators of a Toeplitz matrix (or its LU decomposition).
+     * @param T  matrix to decompose
+     * @param tol  numerical tolerance of the LU decomposition, if needed
+     * @param fftMinSize  solve through the FFT for matrices of this size or larger
+     * @throws SingularMatrixError if T is singular
+     */
+    explicit ToeplitzDecomposition(const ToeplitzMatrix &T, double tol = numcomp::DEFAULT_TOL,
+                                   size_t fftMinSize = TOEPLITZ_FFT_MIN_SIZE);
+    ToeplitzDecomposition() = default;
+
+    /// Exception-free counterpart of the constructor (see LUDecomposition::tryFactor)
+    LUStatus tryFactor(const ToeplitzMatrix &T, double tol = numcomp::DEFAULT_TOL,
+                       size_t fftMinSize = TOEPLITZ_FFT_MIN_SIZE);
+
+    // getters:
+    inline size_t size() const { return _n; }
+    /// Whether a leading principal submatrix was near-singular, so that T was factored by getLU() instead
+    inline bool isFallback() const { return _fallback; }
+    inline const LUDecomposition &getLU() const { return _lu; }
+    inline const Vector &firstColumn() const { return _x; }  ///< x = T^-1 e_0
+    inline const Vector &lastColumn() const { return _y; }  ///< y = T^-1 e_(n-1)
+    /// Whether solves go through the FFT
+    inline bool usesFFT() const { return _n >= _fftMinSize; }
+    inline double tol() const { return _tol; }
+
+private:
+    size_t _n = 0;
+    bool _fallback = false;
+    LUDecomposition _lu;
+    Vector _x, _y;
+    double _tol = numcomp::DEFAULT_TOL;  ///< numerical tolerance
+    size_t _fftMinSize = TOEPLITZ_FFT_MIN_SIZE;
+
+    /// Levinson-Trench recursion: false if a pivot is too small
+    bool levinson(const ToeplitzMatrix &T);
+};
+
+
+#endif //LU_TOEPLITZSOLVER_H
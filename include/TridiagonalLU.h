@@ -0,0 +1,113 @@
+#ifndef LU_TRIDIAGONALLU_H
+#define LU_TRIDIAGONALLU_H
+
+#include <vector>
+#include "LUDecomposition.h"
+#include "Permutation.h"
+#include "TridiagonalMatrix.h"
+#include "numcomp.h"
+
+
+/**
+ * LU decomposition of a tridiagonal matrix with partial pivoting (the Thomas algorithm made
+ * stable, as LAPACK's dgttrf): at each step, row i may be swapped with row i + 1, which gives U
+ * a second super-diagonal. O(n) operations and memory.
+ */
+class TridiagonalLUDecomposition {
+public:
+    /**
+     * Compute the LU decomposition of a tridiagonal matrix.
+     * @param A  matrix to decompose
+     * @param tol  numerical tolerance: the matrix is deemed singular if a pivot is smaller than
+     * this (in absolute value)
+     * @throws SingularMatrixError if A is singular
+     */
+    explicit TridiagonalLUDecomposition(const TridiagonalMatrix &A, double tol = numcomp::DEFAULT_TOL);
+    TridiagonalLUDecomposition() = default;
+
+    /// Exception-free counterpart of the constructor (see LUDecomposition::tryFactor)
+    LUStatus tryFactor(const TridiagonalMatrix &A, double tol = numcomp::DEFAULT_TOL);
+
+    // getters:
+    inline size_t size() const { return _d.size(); }
+    inline const std::vector<double> &multipliers() const { return _dl; }  ///< L (unit diagonal), below it
+    inline const std::vector<double> &diagonal() const { return _d; }  ///< U, on the diagonal
+    inline const std::vector<double> &upper() const { return _du; }  ///< U, first super-diagonal
+    inline const std::vector<double> &upper2() const { return _du2; }  ///< U, second super-diagonal
+    /// Whether rows i and i + 1 were swapped at step i
+    inline bool swapped(index_t i) const { return _swapped[i]; }
+    /// The row permutation equivalent to the interchanges: row perm()[k] of A is the k-th pivot row
+    Permutation::Vector perm() const;
+    bool parity() const;  ///< 0 if the row interchanges make an even permutation, 1 if odd
+    inline double tol() const { return _tol; }
+
+private:
+    std::vector<double> _dl, _d, _du, _du2;
+    std::vector<char> _swapped;
+    double _tol = numcomp::DEFAULT_TOL;  ///< numerical tolerance
+
+    LUStatus decompose();
+};
+
+
+/**
+ * Block LU decomposition of a block tridiagonal matrix (block Thomas algorithm): the diagonal
+ * blocks D_k - L_k X_(k-1) of the block U factor get an LUDecomposition each, and the blocks
+ * X_k = (D_k - L_k X_(k-1))^-1 U_k are kept for the back substitution. O(N b^3) operations for
+ * N blocks of size b, instead of O(N^3 b^3).
+ *
+ * Pivoting stays within the diagonal blocks, which is stable for block diagonally dominant
+ * matrices (as discretizations usually give), not in general.
+ */
+class BlockTridiagonalLUDecomposition {
+public:
+    /**
+     * Compute the block LU decomposition of a block tridiagonal matrix.
+     * @param A  matrix to decompose
+     * @param tol  numerical tolerance (see LUDecomposition)
+     * @throws SingularMatrixError if a diagonal block of the factor is singular
+     */
+    explicit BlockTridiagonalLUDecomposition(const BlockTridiagonalMatrix &A, double tol = numcomp::DEFAULT_TOL);
+    BlockTridiagonalLUDecomposition() = default;
+
+    /// Exception-free counterpart of the constructor (see LUDecomposition::tryFactor). The pivot
+    /// of a failed status is a row of the whole matrix.
+    LUStatus tryFactor(const BlockTridiagonalMatrix &A, double tol = numcomp::DEFAULT_TOL);
+
+    // getters:
+    inline size_t blockCount() const { return _pivotBlocks.size(); }
+    inline size_t blockSize() const { return _blockSize; }
+    inline size_t size() const { return blockCount()*_blockSize; }
+    /// LU decomposition of the k-th diagonal block of the block U factor
+    inline const LUDecomposition &pivotBlock(index_t k) const { return _pivotBlocks[k]; }
+    inline const Matrix &lower(index_t k) const { return _lower[k]; }  ///< block (k + 1, k) of A
+    /// X_k: block (k, k + 1) of the block unit upper factor
+    inline const Matrix &coupling(index_t k) const { return _coupling[k]; }
+    inline double tol() const { return _tol; }
+
+private:
+    size_t _blockSize = 0;
+    std::vector<LUDecomposition> _pivotBlocks;
+    std::vector<Matrix> _lower;
+    std::vector<Matrix> _coupling;
+    double _tol = numcomp::DEFAULT_TOL;  ///< numerical tolerance
+};
+
+
+/// Equations below which each level of solveCyclicReduction runs serially
+const size_t CYCLIC_REDUCTION_PARALLEL_MIN_SIZE = 1u << 14u;
+
+/**
+ * Solve a tridiagonal system by cyclic reduction: each level eliminates every other unknown
+ * left from the equations of the remaining ones, halving the system, and the unknowns are found
+ * back level by level. The equations of a level are independent, so long levels (see
+ * CYCLIC_REDUCTION_PARALLEL_MIN_SIZE) run on the shared thread pool. About twice the operations
+ * of TridiagonalLUDecomposition, and no pivoting: meant for diagonally dominant (or symmetric
+ * positive definite) systems.
+ * @param tol  numerical tolerance: the matrix is deemed singular if a pivot is smaller than this
+ * @throws SingularMatrixError if a pivot is (numerically) zero
+ */
+Vector solveCyclicReduction(const TridiagonalMatrix &A, const Vector &b, double tol = numcomp::DEFAULT_TOL);
+
+
+#endif //LU_TRIDIAGONALLU_H
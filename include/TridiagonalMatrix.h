@@ -0,0 +1,95 @@
+#ifndef LU_TRIDIAGONALMATRIX_H
+#define LU_TRIDIAGONALMATRIX_H
+
+#include <vector>
+#include "aliases.h"
+#include "Matrix.h"
+#include "Vector.h"
+
+
+/// Square tridiagonal matrix, stored as its three diagonals
+class TridiagonalMatrix {
+public:
+    TridiagonalMatrix() = default;
+    /// n by n zero matrix
+    explicit TridiagonalMatrix(size_t n);
+    /**
+     * Matrix with the given diagonals: lower[i] is entry (i + 1, i), upper[i] entry (i, i + 1).
+     * @throws MatrixError if lower and upper don't have one entry less than diagonal
+     */
+    TridiagonalMatrix(std::vector<double> lower, std::vector<double> diagonal, std::vector<double> upper);
+
+    /// Tridiagonal copy of a dense matrix
+    /// @throws MatrixError if A has non-zero entries outside the three diagonals
+    static TridiagonalMatrix fromDense(const Matrix &A);
+
+    // Getters:
+    inline size_t size() const { return _diagonal.size(); }
+    inline const std::vector<double> &lower() const { return _lower; }
+    inline std::vector<double> &lower() { return _lower; }
+    inline const std::vector<double> &diagonal() const { return _diagonal; }
+    inline std::vector<double> &diagonal() { return _diagonal; }
+    inline const std::vector<double> &upper() const { return _upper; }
+    inline std::vector<double> &upper() { return _upper; }
+
+    /// Entry (i, j), zero outside the three diagonals. Has bounds checking.
+    double operator()(index_t i, index_t j) const;
+
+    Matrix toDense() const;
+
+private:
+    std::vector<double> _lower;
+    std::vector<double> _diagonal;
+    std::vector<double> _upper;
+};
+
+
+Vector operator*(const TridiagonalMatrix &A, const Vector &v);
+
+
+/**
+ * Square block tridiagonal matrix: blockCount() by blockCount() blocks, each a dense
+ * blockSize() by blockSize() matrix, of which only the diagonal blocks and their neighbours
+ * (left and right) are stored.
+ */
+class BlockTridiagonalMatrix {
+public:
+    BlockTridiagonalMatrix() = default;
+    /// Zero matrix of blocks by blocks blocks of size blockSize
+    BlockTridiagonalMatrix(size_t blocks, size_t blockSize);
+    /**
+     * Matrix with the given blocks: lower[k] is block (k + 1, k), upper[k] block (k, k + 1).
+     * @throws MatrixError if the blocks aren't all the same size, or lower and upper don't have
+     * one block less than diagonal
+     */
+    BlockTridiagonalMatrix(std::vector<Matrix> lower, std::vector<Matrix> diagonal, std::vector<Matrix> upper);
+
+    /// Block tridiagonal copy of a dense matrix, in blocks of size blockSize
+    /// @throws MatrixError if blockSize doesn't divide the size of A, or A has non-zero entries outside the blocks
+    static BlockTridiagonalMatrix fromDense(const Matrix &A, size_t blockSize);
+
+    // Getters:
+    inline size_t blockCount() const { return _diagonal.size(); }
+    inline size_t blockSize() const { return _blockSize; }
+    inline size_t size() const { return blockCount()*_blockSize; }
+    inline const Matrix &lower(index_t k) const { return _lower[k]; }  ///< block (k + 1, k)
+    inline Matrix &lower(index_t k) { return _lower[k]; }
+    inline const Matrix &diagonal(index_t k) const { return _diagonal[k]; }  ///< block (k, k)
+    inline Matrix &diagonal(index_t k) { return _diagonal[k]; }
+    inline const Matrix &upper(index_t k) const { return _upper[k]; }  ///< block (k, k + 1)
+    inline Matrix &upper(index_t k) { return _upper[k]; }
+
+    Matrix toDense() const;
+
+private:
+    size_t _blockSize = 0;
+    std::vector<Matrix> _lower;
+    std::vector<Matrix> _diagonal;
+    std::vector<Matrix> _upper;
+};
+
+
+Vector operator*(const BlockTridiagonalMatrix &A, const Vector &v);
+
+
+#endif //LU_TRIDIAGONALMATRIX_H
@@ -0,0 +1,96 @@
+#ifndef LU_UPDATEDLU_H
+#define LU_UPDATEDLU_H
+
+#include <vector>
+#include "LUDecomposition.h"
+#include "Matrix.h"
+#include "Vector.h"
+#include "numcomp.h"
+
+
+/// Low-rank corrections accumulated by UpdatedLU before it refactors the matrix
+const size_t UPDATED_LU_MAX_RANK = 16;
+
+/// Relative residue (see UpdatedLU::residue) beyond which UpdatedLU refactors the matrix
+const double UPDATED_LU_MAX_RESIDUE = 1e-10;
+
+
+/**
+ * LU decomposition of a matrix A + U V^T undergoing low-rank updates: A keeps its
+ * LUDecomposition, and the rank k correction is accounted for by the Sherman-Morrison-Woodbury
+ * formula
+ *
+ *     (A + U V^T)^-1 = A^-1 - Z C^-1 V^T A^-1,    Z = A^-1 U,  C = I + V^T Z
+ *
+ * so that an update costs O(n^2 + nk + k^3) instead of O(n^3), and a solve O(n^2 + nk).
+ * Since both the cost of a solve and the rounding errors of the formula grow with k, the whole
+ * matrix is refactored (and the correction absorbed into A) when k goes past maxRank(), when the
+ * capacitance matrix C is singular, or when an update makes residue() exceed maxResidue() (or NaN).
+ */
+class UpdatedLU {
+public:
+    /**
+     * Compute the LU decomposition of a matrix.
+     * @param A  matrix to decompose
+     * @param tol  numerical tolerance of its LU decompositions
+     * @param maxRank  largest rank of the corrections between refactorizations
+     * @param maxResidue  largest residue() tolerated after an update
+     * @throws SingularMatrixError if A is singular
+     */
+    explicit UpdatedLU(const Matrix &A, double tol = numcomp::DEFAULT_TOL, size_t maxRank = UPDATED_LU_MAX_RANK,
+                       double maxResidue = UPDATED_LU_MAX_RESIDUE);
+    UpdatedLU() = default;
+
+    /// Exception-free counterpart of the constructor (see LUDecomposition::tryFactor)
+    LUStatus tryFactor(const Matrix &A, double tol = numcomp::DEFAULT_TOL, size_t maxRank = UPDATED_LU_MAX_RANK,
+                       double maxResidue = UPDATED_LU_MAX_RESIDUE);
+
+    /**
+     * Rank-1 update: the matrix becomes A + U V^T + u v^T.
+     * @return  a status which evaluates to `false` if a refactorization found the updated matrix singular
+     * @throws MatrixError if u or v hasn't the size of the matrix
+     */
+    LUStatus update(const Vector &u, const Vector &v);
+    /// Rank-k update with the columns of U and V (see update(const Vector &, const Vector &))
+    LUStatus update(const std::vector<Vector> &U, const std::vector<Vector> &V);
+
+    /// Absorb the corrections into A and factor it anew
+    LUStatus refactor();
+
+    /// The current matrix, A + U V^T (O(n^2 k))
+    Matrix matrix() const;
+
+    /**
+     * Relative residual ||M x - b||_inf / ||b||_inf of the solution of M x = b computed through
+     * the formula, for M the current matrix and b = M (1, 1, ..., 1): O(n^2 + nk).
+     * NaN if b = 0, which only a singular M allows (e.g. when every row sums to zero).
+     */
+    double residue() const;
+
+    // getters:
+    inline size_t size() const { return _A.size(); }
+    inline size_t rank() const { return _U.size(); }  ///< k, the rank of the current correction
+    inline const LUDecomposition &getLU() const { return _luA; }  ///< LU decomposition of A
+    inline const LUDecomposition &getCapacitance() const { return _luC; }  ///< LU decomposition of C
+    inline const std::vector<Vector> &lowRankU() const { return _U; }  ///< columns of U
+    inline const std::vector<Vector> &lowRankV() const { return _V; }  ///< columns of V
+    inline const std::vector<Vector> &solvedU() const { return _Z; }  ///< columns of Z = A^-1 U
+    inline size_t refactorizations() const { return _refactorizations; }  ///< number of refactorizations after the first
+    inline size_t maxRank() const { return _maxRank; }
+    inline double maxResidue() const { return _maxResidue; }
+    inline double tol() const { return _tol; }
+
+private:
+    Matrix _A;  ///< matrix last factored
+    LUDecomposition _luA;
+    std::vector<Vector> _U, _V, _Z;
+    Matrix _C;  ///< capacitance matrix I + V^T Z
+    LUDecomposition _luC;
+    size_t _refactorizations = 0;
+    size_t _maxRank = UPDATED_LU_MAX_RANK;
+    double _maxResidue = UPDATED_LU_MAX_RESIDUE;
+    double _tol = numcomp::DEFAULT_TOL;  ///< numerical tolerance
+};
+
+
+#endif //LU_UPDATEDLU_H
@@ -0,0 +1,134 @@
+/// @file
+/// Binary container format for matrices and vectors.
+///
+/// A file is a sequence of sections (typically a matrix followed by a vector).
+/// Each section is a 64-byte BinaryHeader followed by its payload, padded so that
+/// the next section starts at a multiple of 64 bytes. Payloads are either raw
+/// dense doubles (row-major for matrices) or (i, j, value) triplets ((i, value)
+/// pairs for vectors), stored in the native byte order recorded in the header.
+
+#ifndef LU_BINARY_H
+#define LU_BINARY_H
+
+#include <cstdint>
+#include <iosfwd>
+#include "Matrix.h"
+#include "MappedFile.h"
+#include "SparseMatrix.h"
+
+
+const uint32_t BINARY_VERSION = 1;
+
+enum class BinaryKind : uint32_t { Matrix = 0, Vector = 1 };
+enum class BinaryLayout : uint32_t { Dense = 0, Triplets = 1 };
+enum class BinaryDType : uint32_t { Float64 = 0 };
+
+/// Section header (64 bytes)
+struct BinaryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;  ///< BYTE_ORDER_MARK as written by the producing machine
+    BinaryKind kind;
+    BinaryLayout layout;
+    BinaryDType dtype;
+    uint32_t reserved;
+    uint64_t n;  ///< dimension
+    uint64_t nnz;  ///< number of stored entries (n^2 or n for dense layouts)
+    uint64_t payloadBytes;  ///< payload size (excluding padding)
+    uint64_t checksum;  ///< 64-bit FNV-1a hash of the payload
+
+    static constexpr char MAGIC[8] = {'\x89', 'L', 'U', 'B', 'I', 'N', '\r', '\n'};
+    static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+};
+
+struct BinaryTriplet {
+    uint64_t i, j;
+    double value;
+};
+
+struct BinaryPair {
+    uint64_t i;
+    double value;
+};
+
+
+/// Non-owning, read-only view of a dense row-major square matrix
+class MatrixView {
+public:
+    MatrixView(const double *data, size_t n) : _data(data), _n(n) {}
+    MatrixView() = default;
+
+    inline size_t size() const { return _n; }
+    inline const double *data() const { return _data; }
+    inline const double *operator[](index_t i) const { return _data + i*_n; }
+    double operator()(index_t i, index_t j) const;  ///< bounds-checked access
+
+private:
+    const double *_data = nullptr;
+    size_t _n = 0;
+};
+
+Vector operator*(const MatrixView &A, const Vector &v);
+
+
+/// Matrix section of a binary file; points into the file's (mapped) memory
+struct BinaryMatrix {
+    BinaryLayout layout;
+    size_t n, nnz;
+    const double *dense;  ///< row-major entries (Dense layout only)
+    const BinaryTriplet *triplets;  ///< entries (Triplets layout only)
+    size_t end;  ///< offset of the next section in the file
+
+    /// View of the mapped data
+    /// @throws ValueError if the layout isn't dense
+    MatrixView view() const;
+
+    /// Copy of the data as an owning Matrix
+    Matrix toMatrix() const;
+
+    /// Copy of the non-zero entries as a sparse matrix
+    SparseMatrix toSparse() const;
+};
+
+/// Vector section of a binary file; points into the file's (mapped) memory
+struct BinaryVector {
+    BinaryLayout layout;
+    size_t n, nnz;
+    const double *dense;  ///< entries (Dense layout only)
+    const BinaryPair *pairs;  ///< entries (Triplets layout only)
+    size_t end;  ///< offset of the next section in the file
+
+    Vector toVector() const;
+};
+
+
+/// Whether the given data starts with the binary format's magic bytes
+bool isBinary(const char *first, const char *last);
+
+inline
+bool isBinary(const MappedFile &file) { return isBinary(file.begin(), file.end()); }
+
+/**
+ * Map the matrix section starting at `offset` (no data is copied).
+ * @param verify  whether to validate the payload checksum
+ * @throws BadFormat (with the byte offset) if the section is malformed
+ */
+BinaryMatrix mapBinaryMatrix(const MappedFile &file, size_t offset = 0, bool verify = true);
+
+/// Vector analogue of mapBinaryMatrix
+BinaryVector mapBinaryVector(const MappedFile &file, size_t offset, bool verify = true);
+
+/**
+ * Read a vector section from a stream (e.g. a pipe, which can't be mapped).
+ * @throws BadFormat if the section is malformed or truncated
+ */
+Vector readBinaryVector(std::istream &is);
+
+/// Write a matrix section; the triplet layout only stores nonzero entries
+void writeBinaryMatrix(std::ostream &os, const Matrix &A, BinaryLayout layout = BinaryLayout::Dense);
+
+/// Write a vector section; the triplet layout only stores nonzero entries
+void writeBinaryVector(std::ostream &os, const Vector &b, BinaryLayout layout = BinaryLayout::Dense);
+
+
+#endif //LU_BINARY_H
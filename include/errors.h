@@ -57,6 +57,8 @@ class BadFormat : public virtual BaseException {
 public:
     static constexpr auto base = "bad input format";
     explicit BadFormat(const char *specific = nullptr) : BaseException(base, specific) {}
+    /// Parsing error at a known position of the input
+    BadFormat(const char *specific, size_t offset);
 };
 
 
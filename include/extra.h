@@ -5,6 +5,7 @@
 #ifndef LU_EXTRA_H
 #define LU_EXTRA_H
 
+#include "Cholesky.h"
 #include "LUDecomposition.h"
 
 /**
@@ -22,5 +23,11 @@ double determinant(const Matrix &A);
  */
 double determinant(const LUDecomposition & luObj);
 
+/// Determinant of a symmetric positive definite matrix given its Cholesky decomposition (the squared product of the diagonal of L)
+double determinant(const CholeskyDecomposition &cholObj);
+
+/// Determinant of a symmetric matrix given its LDL^T decomposition (that of D: the symmetric permutation doesn't change it)
+double determinant(const LDLTDecomposition &ldlObj);
+
 
 #endif //LU_EXTRA_H
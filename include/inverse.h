@@ -5,6 +5,7 @@
 #ifndef LU_INVERSE_H
 #define LU_INVERSE_H
 
+#include "Cholesky.h"
 #include "LUDecomposition.h"
 
 /**
@@ -22,6 +23,12 @@ Matrix inverse(const Matrix &A);
  */
 Matrix inverse(const LUDecomposition &luObj);
 
+/// Inverse of a symmetric positive definite matrix given its Cholesky decomposition
+Matrix inverse(const CholeskyDecomposition &cholObj);
+
+/// Inverse of a symmetric matrix given its LDL^T decomposition
+Matrix inverse(const LDLTDecomposition &ldlObj);
+
 /// n by n identity matrix
 Matrix identity(size_t n);
 
@@ -9,14 +9,34 @@
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include <vector>
 #include "aliases.h"
 #include "Matrix.h"
+#include "SparseMatrix.h"
+#include "BandMatrix.h"
+#include "SkylineMatrix.h"
 #include "Vector.h"
+#include "Scanner.h"
+#include "writer.h"
+#include "sistema.h"
 
 
 const unsigned PRECISION = 12;
-
-std::string solveFile(const char *filePath);
+/// Digits after the decimal point needed for doubles to survive a text round-trip
+const unsigned ROUND_TRIP_PRECISION = 16;
+
+/**
+ * Solve the system in the file `filePath` and write its solution file (see writeSolution).
+ * @param iterative  solve with an iterative method instead of a factorization (if not nullptr)
+ * @param choice  how to pick the solver of a dense matrix (see solve(const Matrix &, const std::vector<Vector> &, double, SolverChoice))
+ * @return  the name of the solution file
+ */
+std::string solveFile(const char *filePath, OutputFormat format = OutputFormat::Text,
+                      const IterativeOptions *iterative = nullptr, SolverChoice choice = SolverChoice::Auto);
+
+/// Write the solution file corresponding to the input file `filePath` and return its name
+std::string writeSolution(const char *filePath, const SolveResult &result, const ExtraSolveInfo &info,
+                          OutputFormat format = OutputFormat::Text);
 
 template<typename Integer>
 unsigned noDigits(Integer num) {
@@ -25,32 +45,121 @@ unsigned noDigits(Integer num) {
     return count;
 }
 
+// Vector entries as printed by printVector (a blank takes the place of the sign of non-negative numbers)
+inline
+void writeEntry(OutputWriter &out, double value, unsigned precision) {
+    if (value >= 0) out.put(' ');
+    out.writeScientific(value, precision);
+}
+
+inline
+void writeEntry(OutputWriter &out, index_t value, unsigned) {
+    out.put(' ');
+    out.writeIndex(value);
+}
+
 template<typename Vec>
-void printVector(const Vec &vec, std::ostream &os, const char *title = nullptr) {
+void printVector(const Vec &vec, OutputWriter &out, unsigned precision, const char *title = nullptr) {
     size_t n = vec.size();
     const unsigned width = noDigits(n);
 
-    if (title and *title != '\0') os << title << ":\n";
-    for (index_t i = 0; i < n; ++i)
-        os << std::setw(width) << i << " \t"
-           << (vec[i] >= 0 ? " " : "")
-           << std::scientific << vec[i]
-           << '\n';
+    if (title and *title != '\0') {
+        out.write(title);
+        out.write(":\n");
+    }
+    for (index_t i = 0; i < n; ++i) {
+        out.writeIndex(i, width);
+        out.write(" \t", 2);
+        writeEntry(out, vec[i], precision);
+        out.put('\n');
+    }
+
+    out.put('\n');
+}
 
-    os << '\n';
+template<typename Vec>
+void printVector(const Vec &vec, std::ostream &os, const char *title = nullptr) {
+    OutputWriter out(os);
+    printVector(vec, out, unsigned(os.precision()), title);
 }
 
+void printInfoNumber(double infoNum, OutputWriter &out, unsigned precision, const char *title);
+
 void printInfoNumber(double infoNum, std::ostream &os, const char *title);
 
+/// Write the solution of a system together with its extra information
+void printResult(const SolveResult &result, const ExtraSolveInfo &info, std::ostream &os,
+                 OutputFormat format = OutputFormat::Text);
+
 Matrix readMatrix(std::istream &is);
 
+/// Read a vector in sparse format ("k" followed by k "i value" entries), the null vector if there is none
+/// @throws BadFormat on malformed input
 Vector readVector(std::istream &is, size_t n);
 
+/**
+ * Parse a matrix in sparse triplet format ("n m" followed by m "i j value" entries).
+ * @throws BadFormat (including the byte offset) on malformed input
+ */
+Matrix readMatrix(Scanner &scanner);
+
+/**
+ * Like readMatrix(Scanner &), also detecting the bandwidth of the matrix while parsing.
+ * Every non-zero triplet counts, so an entry set twice (the last value wins) may widen it.
+ */
+Matrix readMatrix(Scanner &scanner, Bandwidth &bandwidth);
+
+/// Like readMatrix(Scanner &), but keeps the matrix in sparse storage
+SparseMatrix readSparseMatrix(Scanner &scanner);
+
+/**
+ * Like readMatrix(Scanner &), but keeps the matrix in skyline storage, with the envelope of the triplets read
+ * @param symmetric  store only the lower part (see SkylineMatrix::fromSparse)
+ */
+SkylineMatrix readSkylineMatrix(Scanner &scanner, bool symmetric = false);
+
+/**
+ * Parse a vector of size n in sparse format ("k" followed by k "i value" entries).
+ * @throws BadFormat (including the byte offset) on malformed input
+ */
+Vector readVector(Scanner &scanner, size_t n);
+
+/**
+ * Read the dimension n and the number of stored entries m of the matrix in a system
+ * file (in either format) without parsing the rest of it.
+ */
+void peekDimensions(const MappedFile &file, size_t &n, size_t &m);
+
+/**
+ * Read the system Ax = b from a file in either the text (.DAT) or
+ * the binary format (see binary.h), detected by its magic bytes.
+ */
+void readSystem(const MappedFile &file, Matrix &A, Vector &b);
+
+/**
+ * Read the system AX = B from a file in either format, where the matrix is followed
+ * by any number of right-hand sides (text vector blocks or binary vector sections)
+ * up to the end of the file. A file with no vectors yields one null vector.
+ */
+void readSystem(const MappedFile &file, Matrix &A, std::vector<Vector> &bs);
+
+/// Like readSystem(const MappedFile &, Matrix &, std::vector<Vector> &), keeping A sparse
+void readSystem(const MappedFile &file, SparseMatrix &A, std::vector<Vector> &bs);
+
 std::ifstream openFile(const char *path);
 
-std::ofstream writeFile(const std::string &oname);
+std::ofstream writeFile(const std::string &oname, std::ios::openmode mode = std::ios::out);
 
-std::string getOutName(const char *iname);
+/// Name of the solution file for the input file `iname`
+std::string getOutName(const char *iname, OutputFormat format = OutputFormat::Text);
+
+/// Print an error message (followed by the argument it concerns, if any) to stderr
+inline
+void printError(const char *message, const char *arg = nullptr) {
+    std::cerr << "error: " << message;
+    if (arg) std::cerr << ' ' << arg;
+    std::cerr << '\n';
+}
 
 
 template <typename Vec, typename... Vecs>
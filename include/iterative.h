@@ -0,0 +1,101 @@
+#ifndef LU_ITERATIVE_H
+#define LU_ITERATIVE_H
+
+#include <vector>
+#include "LUDecomposition.h"
+#include "SparseMatrix.h"
+#include "Vector.h"
+
+
+/**
+ * Incomplete LU factorization A ≈ LU, to be used as a preconditioner.
+ *
+ * Rows are eliminated one at a time like in LUDecomposition::decompose (row i is
+ * reduced by the rows above it, IKJ order), but only some entries are kept:
+ * - ILU(0) keeps the pattern of A;
+ * - ILUT(τ, p) drops the entries smaller than τ times the norm of their row of A,
+ *   then keeps the p largest ones in each of the L and U parts of the row.
+ * No pivoting is done.
+ */
+class IncompleteLU {
+public:
+    IncompleteLU() = default;
+
+    /// ILU(0) factorization
+    /// @return  a status which evaluates to `false` if a zero pivot is met
+    LUStatus factorILU0(const SparseMatrix &A);
+
+    /// ILUT(dropTol, fill) factorization
+    /// @return  a status which evaluates to `false` if a zero pivot is met
+    LUStatus factorILUT(const SparseMatrix &A, double dropTol = 1e-4, size_t fill = 10);
+
+    /// Solve LU z = r
+    Vector apply(const Vector &r) const;
+
+    inline size_t size() const { return _LU.size(); }
+    inline size_t nnz() const { return _LU.nnz(); }
+    /// L (without its unit diagonal) and U together, in CSR layout
+    inline const SparseMatrix &factors() const { return _LU; }
+
+private:
+    SparseMatrix _LU;
+    std::vector<index_t> _diag;  ///< position of the diagonal entry of each row in _LU
+};
+
+
+enum class IterativeMethod { GMRES, BiCGSTAB };
+enum class Preconditioner { None, ILU0, ILUT };
+
+struct IterativeOptions {
+    IterativeMethod method = IterativeMethod::GMRES;
+    Preconditioner preconditioner = Preconditioner::ILU0;
+    double tol = 1e-10;  ///< target relative residual ||b - Ax||_2/||b||_2
+    size_t maxIterations = 1000;  ///< iteration cap (matrix-vector products for GMRES, steps for BiCGSTAB)
+    size_t restart = 30;  ///< GMRES restart length
+    double dropTol = 1e-4;  ///< ILUT drop tolerance
+    size_t fill = 10;  ///< ILUT fill per row and triangular part
+};
+
+/// Outcome of an iterative solve
+struct IterativeResult {
+    Vector x;
+    bool converged = false;
+    size_t iterations = 0;
+    double residual = 0.0;  ///< final relative residual ||b - Ax||_2/||b||_2 (recomputed, not the recurrence's)
+};
+
+/**
+ * Restarted GMRES(m) with right preconditioning.
+ * @param M  preconditioner (none if nullptr)
+ * @param x0  initial guess (zero if empty)
+ */
+IterativeResult gmres(const SparseMatrix &A, const Vector &b, const IncompleteLU *M,
+                      const IterativeOptions &options, const Vector &x0 = {});
+
+/**
+ * BiCGSTAB with right preconditioning. On a breakdown (a zero denominator in the recurrences)
+ * it stops with the last iterate, unconverged.
+ * @param M  preconditioner (none if nullptr)
+ * @param x0  initial guess (zero if empty)
+ */
+IterativeResult bicgstab(const SparseMatrix &A, const Vector &b, const IncompleteLU *M,
+                         const IterativeOptions &options, const Vector &x0 = {});
+
+/**
+ * Factor the preconditioner chosen by `options` into M (nothing to do for Preconditioner::None).
+ * @return  a status which evaluates to `false` if a zero pivot is met
+ */
+LUStatus factorPreconditioner(IncompleteLU &M, const SparseMatrix &A, const IterativeOptions &options);
+
+/// Solve Ax = b with the method chosen by `options` and an already factored preconditioner (or nullptr)
+IterativeResult solveIterative(const SparseMatrix &A, const Vector &b, const IncompleteLU *M,
+                               const IterativeOptions &options);
+
+/**
+ * Solve Ax = b iteratively as described by `options` (building the preconditioner first).
+ * @throws SingularMatrixError if the preconditioner meets a zero pivot
+ */
+IterativeResult solveIterative(const SparseMatrix &A, const Vector &b, const IterativeOptions &options);
+
+
+#endif //LU_ITERATIVE_H
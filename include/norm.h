@@ -5,8 +5,19 @@
 #ifndef LU_NORM_H
 #define LU_NORM_H
 
+#include "BTF.h"
+#include "BandLU.h"
+#include "Cholesky.h"
 #include "LUDecomposition.h"
+#include "SchurComplement.h"
+#include "SkylineLU.h"
+#include "TridiagonalLU.h"
+#include "UpdatedLU.h"
+#include "ToeplitzSolver.h"
+#include "SparseLU.h"
+#include "SparseMatrix.h"
 #include "Vector.h"
+#include "structure.h"
 
 enum class NormType {
     L1 = 1,     // L1 norm
@@ -27,6 +38,7 @@ double normInf(const Vector &vec);
 double norm(const Matrix &A, NormType nt);
 double norm1(const Matrix &A);
 double normInf(const Matrix &A);
+double norm(const SparseMatrix &A, NormType nt);
 
 /**
  * Condition number of a matrix, given its inverse
@@ -50,6 +62,60 @@ double conditionNumber(const Matrix &A, NormType nt);
  */
 double conditionNumber(const Matrix &A, const LUDecomposition &luObj, NormType nt);
 
+/// Condition number of a sparse matrix, given its LU decomposition
+double conditionNumber(const SparseMatrix &A, const LUDecomposition &luObj, NormType nt);
+
+/// Systems larger than this get their inverse norm estimated rather than computed
+const size_t EXACT_INVERSE_NORM_MAX_SIZE = 2000;
+
+/**
+ * Norm of the inverse of a matrix, given its sparse LU decomposition, without forming the inverse.
+ * Up to EXACT_INVERSE_NORM_MAX_SIZE the inverse is computed column by column (O(n) memory);
+ * beyond, the norm is estimated with Hager's method as refined by Higham
+ * (a few solves with A and A^T; the estimate is a lower bound, usually exact or close).
+ * @param nt  L1 or Inf
+ */
+double inverseNorm(const SparseLUDecomposition &luObj, NormType nt);
+
+/// Norm of the inverse of a matrix, given the LU decomposition of its block triangular form (see inverseNorm)
+double inverseNorm(const BTFDecomposition &luObj, NormType nt);
+
+/// Norm of the inverse of a band matrix, given its LU decomposition (see inverseNorm)
+double inverseNorm(const BandLUDecomposition &luObj, NormType nt);
+
+/// Norm of the inverse of a tridiagonal matrix, given its LU decomposition (see inverseNorm)
+double inverseNorm(const TridiagonalLUDecomposition &luObj, NormType nt);
+
+/// Norm of the inverse of a block tridiagonal matrix, given its block LU decomposition (see inverseNorm)
+double inverseNorm(const BlockTridiagonalLUDecomposition &luObj, NormType nt);
+
+/// Norm of the inverse of a bordered matrix, given its block LU decomposition (see inverseNorm)
+double inverseNorm(const SchurComplementDecomposition &schurObj, NormType nt);
+
+/// Norm of the inverse of a matrix, given its LU decomposition with low-rank updates (see inverseNorm)
+double inverseNorm(const UpdatedLU &luObj, NormType nt);
+
+/// Norm of the inverse of a Toeplitz matrix, given its inverse generators (see inverseNorm)
+double inverseNorm(const ToeplitzDecomposition &toepObj, NormType nt);
+
+/// Norm of the inverse of a skyline matrix, given its LU decomposition (see inverseNorm)
+double inverseNorm(const SkylineLUDecomposition &luObj, NormType nt);
+
+/// Norm of the inverse of a symmetric skyline matrix, given its LDL^T decomposition (see inverseNorm)
+double inverseNorm(const SkylineLDLTDecomposition &ldlObj, NormType nt);
+
+/// Norm of the inverse of a symmetric positive definite matrix, given its Cholesky decomposition (see inverseNorm)
+double inverseNorm(const CholeskyDecomposition &cholObj, NormType nt);
+
+/// Norm of the inverse of a symmetric matrix, given its LDL^T decomposition (see inverseNorm)
+double inverseNorm(const LDLTDecomposition &ldlObj, NormType nt);
+
+/// Norm of the inverse of a (permuted) triangular matrix (see inverseNorm)
+double inverseNorm(const TriangularDecomposition &triObj, NormType nt);
+
+/// Condition number of a sparse matrix, given its sparse LU decomposition (see inverseNorm)
+double conditionNumber(const SparseMatrix &A, const SparseLUDecomposition &luObj, NormType nt);
+
 /**
  * Condition number of a matrix, given its inverse
  * @param A  matrix
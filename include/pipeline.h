@@ -0,0 +1,57 @@
+#ifndef LU_PIPELINE_H
+#define LU_PIPELINE_H
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "sistema.h"
+#include "writer.h"
+
+
+/// A file to solve, how to pick its solver and how to write its solution
+struct SolveTask {
+    const char *path;
+    OutputFormat format;
+    SolverChoice solver;
+};
+
+struct PipelineOptions {
+    /// Threads factoring and solving. The parse and write stages have a thread each on top of them,
+    /// and the metrics stage metricsWorkers.
+    unsigned factorWorkers = 1;
+    unsigned metricsWorkers = 1;  ///< threads computing the extra solve information
+    size_t queueCapacity = 2;  ///< maximum number of files waiting between two stages
+    size_t memoryBudget = size_t(1) << 30;  ///< bytes of matrix data allowed in flight
+};
+
+/// Activity summary of a pipeline stage
+struct StageStats {
+    const char *name;
+    unsigned workers;
+    size_t items;  ///< number of files that went through the stage
+    double busySeconds;  ///< total time spent working (summed over workers)
+    double occupancy;  ///< busySeconds/(workers*wall time)
+    size_t maxQueued;  ///< largest number of files waiting for this stage
+};
+
+/**
+ * Called (from the writer stage) once a file was processed, in the order of the tasks:
+ * `outName` is the solution file name, or `error` describes what went wrong (and is null otherwise).
+ */
+typedef std::function<void(const char *path, const std::string &outName, const char *error)> PipelineReport;
+
+/**
+ * Solve files through a staged pipeline: parse -> factor & solve -> metrics -> write.
+ * Stages run concurrently and hand files over through bounded queues, so reading
+ * the next file and writing the previous one overlap with factoring the current one.
+ * Before parsing, the parse stage reserves the estimated memory of each file from
+ * the in-flight budget (a file larger than the whole budget is processed alone).
+ * Files may finish factoring out of order (with several factor workers): the write
+ * stage holds them back so as to write and report them in the order of `tasks`.
+ * @return  per-stage statistics, in stage order
+ */
+std::vector<StageStats> runPipeline(const std::vector<SolveTask> &tasks, const PipelineOptions &options,
+                                    const PipelineReport &report);
+
+
+#endif //LU_PIPELINE_H
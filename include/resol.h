@@ -5,12 +5,184 @@
 #ifndef LU_RESOL_H
 #define LU_RESOL_H
 
+#include <vector>
 #include "Vector.h"
 #include "LUDecomposition.h"
+#include "SchurComplement.h"
+#include "SparseLU.h"
+#include "BTF.h"
+#include "BandLU.h"
+#include "Cholesky.h"
+#include "SkylineLU.h"
+#include "Kronecker.h"
+#include "TridiagonalLU.h"
+#include "UpdatedLU.h"
+#include "ToeplitzSolver.h"
+#include "structure.h"
 
-/// Compute the solution of a linear system given the LU decomposition of the matrix
+/**
+ * Compute the solution of a linear system given the LU decomposition of the matrix.
+ * The forward substitution starts at the first non-zero entry of the permuted b.
+ */
 Vector solveLU(const LUDecomposition &luObj, const Vector &b);
 
+/// Compute the solution of the transposed system A^T x = b given the LU decomposition of A
+Vector solveLUTransposed(const LUDecomposition &luObj, const Vector &b);
+
+/**
+ * Compute the solutions of several linear systems sharing the same matrix.
+ * Right-hand sides are processed in blocks, so that each row of the decomposed
+ * matrix is read once per block instead of once per vector.
+ */
+std::vector<Vector> solveLU(const LUDecomposition &luObj, const std::vector<Vector> &bs);
+
+/// Right-hand sides with at most this fraction of non-zero entries are solved by sparse substitution
+const double SPARSE_RHS_MAX_DENSITY = 0.05;
+
+/**
+ * Compute the solution of a linear system given its sparse LU decomposition.
+ * If b is sparse enough (see SPARSE_RHS_MAX_DENSITY), as for b = e_k, the substitutions only
+ * visit the columns of L and U reachable from its non-zero entries (Gilbert-Peierls), so their
+ * cost is proportional to the arithmetic rather than to the size of the factors. Reading b,
+ * writing x and allocating the flags of the reachability search still take O(n): the whole
+ * solve costs O(n + flops).
+ */
+Vector solveLU(const SparseLUDecomposition &luObj, const Vector &b);
+
+/// Compute the solutions of several linear systems given their sparse LU decomposition
+std::vector<Vector> solveLU(const SparseLUDecomposition &luObj, const std::vector<Vector> &bs);
+
+/// Compute the solution of the transposed system A^T x = b given the sparse LU decomposition of A
+Vector solveLUTransposed(const SparseLUDecomposition &luObj, const Vector &b);
+
+/**
+ * Compute the solution of a linear system given the LU decomposition of its block triangular
+ * form: the diagonal blocks are solved last to first, each right-hand side being updated with
+ * the off-diagonal blocks to its right (block back-substitution).
+ */
+Vector solveLU(const BTFDecomposition &luObj, const Vector &b);
+
+/// Compute the solutions of several linear systems given the LU decomposition of their block triangular form
+std::vector<Vector> solveLU(const BTFDecomposition &luObj, const std::vector<Vector> &bs);
+
+/// Compute the solution of the transposed system A^T x = b given the LU decomposition of the block triangular form of A
+Vector solveLUTransposed(const BTFDecomposition &luObj, const Vector &b);
+
+/// Compute the solution of a linear system given the banded LU decomposition of the matrix (O(n (2 kl + ku)))
+Vector solveLU(const BandLUDecomposition &luObj, const Vector &b);
+
+/// Compute the solutions of several linear systems given the banded LU decomposition of their matrix
+std::vector<Vector> solveLU(const BandLUDecomposition &luObj, const std::vector<Vector> &bs);
+
+/// Compute the solution of the transposed system A^T x = b given the banded LU decomposition of A
+Vector solveLUTransposed(const BandLUDecomposition &luObj, const Vector &b);
+
+/// Compute the solution of a linear system given the tridiagonal LU decomposition of the matrix (O(n))
+Vector solveLU(const TridiagonalLUDecomposition &luObj, const Vector &b);
+
+/// Compute the solutions of several linear systems given the tridiagonal LU decomposition of their matrix
+std::vector<Vector> solveLU(const TridiagonalLUDecomposition &luObj, const std::vector<Vector> &bs);
+
+/// Compute the solution of the transposed system A^T x = b given the tridiagonal LU decomposition of A
+Vector solveLUTransposed(const TridiagonalLUDecomposition &luObj, const Vector &b);
+
+/**
+ * Compute the solution of a linear system given the block LU decomposition of its block
+ * tridiagonal matrix: forward through the diagonal blocks of the block L factor, then back
+ * through the couplings of the block U factor.
+ */
+Vector solveLU(const BlockTridiagonalLUDecomposition &luObj, const Vector &b);
+
+/// Compute the solutions of several linear systems given the block LU decomposition of their block tridiagonal matrix
+std::vector<Vector> solveLU(const BlockTridiagonalLUDecomposition &luObj, const std::vector<Vector> &bs);
+
+/// Compute the solution of the transposed system A^T x = b given the block LU decomposition of the block tridiagonal matrix A
+Vector solveLUTransposed(const BlockTridiagonalLUDecomposition &luObj, const Vector &b);
+
+/// Compute the solution of a linear system given the skyline LU decomposition of the matrix
+/// (operations proportional to the size of the profile)
+Vector solveLU(const SkylineLUDecomposition &luObj, const Vector &b);
+
+/// Compute the solutions of several linear systems given the skyline LU decomposition of their matrix
+std::vector<Vector> solveLU(const SkylineLUDecomposition &luObj, const std::vector<Vector> &bs);
+
+/// Compute the solution of the transposed system A^T x = b given the skyline LU decomposition of A
+Vector solveLUTransposed(const SkylineLUDecomposition &luObj, const Vector &b);
+
+/// Compute the solution of a symmetric linear system given the LDL^T decomposition of the matrix
+Vector solveLDLT(const SkylineLDLTDecomposition &ldlObj, const Vector &b);
+
+/// Compute the solutions of several symmetric linear systems given the LDL^T decomposition of their matrix
+std::vector<Vector> solveLDLT(const SkylineLDLTDecomposition &ldlObj, const std::vector<Vector> &bs);
+
+/// Compute the solution of a symmetric positive definite linear system given the Cholesky decomposition of the matrix
+Vector solveCholesky(const CholeskyDecomposition &cholObj, const Vector &b);
+
+/// Compute the solutions of several symmetric positive definite linear systems given the Cholesky decomposition of their matrix
+std::vector<Vector> solveCholesky(const CholeskyDecomposition &cholObj, const std::vector<Vector> &bs);
+
+/// Compute the solution of a symmetric linear system given the Bunch-Kaufman LDL^T decomposition of the matrix
+Vector solveLDLT(const LDLTDecomposition &ldlObj, const Vector &b);
+
+/// Compute the solutions of several symmetric linear systems given the Bunch-Kaufman LDL^T decomposition of their matrix
+std::vector<Vector> solveLDLT(const LDLTDecomposition &ldlObj, const std::vector<Vector> &bs);
+
+/// Compute the solution of a (permuted) triangular linear system by substitution (operations proportional to nnz)
+Vector solveLU(const TriangularDecomposition &triObj, const Vector &b);
+
+/// Compute the solutions of several (permuted) triangular linear systems by substitution
+std::vector<Vector> solveLU(const TriangularDecomposition &triObj, const std::vector<Vector> &bs);
+
+/// Compute the solution of the transposed system A^T x = b for a (permuted) triangular matrix A
+Vector solveLUTransposed(const TriangularDecomposition &triObj, const Vector &b);
+
+/**
+ * Compute the solution of a Toeplitz linear system from the inverse generators of its matrix
+ * (Gohberg-Semencul formula): four triangular Toeplitz products, O(n^2) operations or
+ * O(n log n) through the FFT (see ToeplitzDecomposition::usesFFT())
+ */
+Vector solveLU(const ToeplitzDecomposition &toepObj, const Vector &b);
+
+/// Compute the solutions of several Toeplitz linear systems from the inverse generators of their matrix
+std::vector<Vector> solveLU(const ToeplitzDecomposition &toepObj, const std::vector<Vector> &bs);
+
+/// Compute the solution of the transposed system T^T x = b from the inverse generators of the Toeplitz matrix T
+Vector solveLUTransposed(const ToeplitzDecomposition &toepObj, const Vector &b);
+
+/**
+ * Compute the solution of a Kronecker linear system (A_0 ⊗ A_1 ⊗ ...) x = c given the LU
+ * decompositions of the factors: N (n_0 + n_1 + ...) operations for N unknowns (see KroneckerSystem)
+ */
+Vector solveLU(const KroneckerSystem &kronObj, const Vector &c);
+
+/// Compute the solutions of several Kronecker linear systems given the LU decompositions of the factors of their matrix
+std::vector<Vector> solveLU(const KroneckerSystem &kronObj, const std::vector<Vector> &cs);
+
+/// Compute the solution of the transposed Kronecker system (A_0 ⊗ A_1 ⊗ ...)^T x = c
+Vector solveLUTransposed(const KroneckerSystem &kronObj, const Vector &c);
+
+/**
+ * Compute the solution of a bordered linear system given its block LU decomposition: a solve
+ * with A, one with S and O(nm) operations to combine them (see SchurComplementDecomposition)
+ */
+Vector solveLU(const SchurComplementDecomposition &schurObj, const Vector &b);
+
+/// Compute the solutions of several bordered linear systems given the block LU decomposition of their matrix
+std::vector<Vector> solveLU(const SchurComplementDecomposition &schurObj, const std::vector<Vector> &bs);
+
+/// Compute the solution of the transposed system M^T x = b given the block LU decomposition of the bordered matrix M
+Vector solveLUTransposed(const SchurComplementDecomposition &schurObj, const Vector &b);
+
+/// Compute the solution of a linear system given the LU decomposition of its matrix before low-rank updates
+/// and the updates (Sherman-Morrison-Woodbury formula, O(n^2 + nk) for rank k updates)
+Vector solveLU(const UpdatedLU &luObj, const Vector &b);
+
+/// Compute the solutions of several linear systems given the updated LU decomposition of their matrix
+std::vector<Vector> solveLU(const UpdatedLU &luObj, const std::vector<Vector> &bs);
+
+/// Compute the solution of the transposed system M^T x = b given the updated LU decomposition of M
+Vector solveLUTransposed(const UpdatedLU &luObj, const Vector &b);
+
 /// C-style interface to solve(const LUDecomposition &, const Vector &)
 void resol(double **a, double x[], double b[], int n, int perm[]);
 
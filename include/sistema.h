@@ -5,8 +5,77 @@
 #ifndef LU_SISTEMA_H
 #define LU_SISTEMA_H
 
+#include <memory>
+#include <vector>
+#include "BTF.h"
+#include "BandLU.h"
+#include "Cholesky.h"
 #include "LUDecomposition.h"
+#include "SkylineLU.h"
+#include "TridiagonalLU.h"
+#include "ToeplitzSolver.h"
+#include "SparseLU.h"
+#include "iterative.h"
+#include "norm.h"
+#include "SparseMatrix.h"
 #include "Vector.h"
+#include "structure.h"
+
+
+/// The way a linear system was solved (see SolveResult::method())
+enum class SolveMethod {
+    LU,                  ///< dense LU decomposition with scaled partial pivoting (getLU())
+    SparseLU,            ///< sparse LU decomposition (getSparseLU())
+    BlockTriangular,     ///< LU decomposition of the blocks of the block triangular form (getBTF())
+    Iterative,           ///< preconditioned Krylov method, no factorization
+    Diagonal,            ///< division by the diagonal (getTriangular())
+    LowerTriangular,     ///< forward substitution (getTriangular())
+    UpperTriangular,     ///< back substitution (getTriangular())
+    PermutedTriangular,  ///< substitution in the order making the matrix triangular (getTriangular())
+    Tridiagonal,         ///< tridiagonal LU decomposition with partial pivoting (getTridiagonal())
+    Band,                ///< band LU decomposition with partial pivoting (getBandLU())
+    SkylineLDLT,         ///< LDL^T decomposition in skyline storage, for symmetric positive definite matrices (getSkylineLDLT())
+    SkylineLU,           ///< LU decomposition without pivoting in skyline storage, for diagonally dominant matrices (getSkylineLU())
+    Cholesky,            ///< blocked Cholesky decomposition, for symmetric positive definite matrices (getCholesky())
+    LDLT,                ///< LDL^T decomposition with Bunch-Kaufman pivoting, for symmetric matrices (getLDLT())
+    Toeplitz,            ///< Levinson-Trench inverse generators, or LU when they break down, for Toeplitz matrices (getToeplitz())
+};
+
+/// Human readable name of a solve method
+const char *methodName(SolveMethod method);
+
+/// Symmetric matrices whose envelope takes at most this fraction of n^2 may be factored in skyline storage
+const double SKYLINE_MAX_FRACTION = 0.5;
+
+/// Dense matrices with at least this many rows are checked for reducibility before the dense LU decomposition
+const size_t DENSE_BTF_MIN_SIZE = 50;
+
+/// Which solver solve() picks for a dense matrix
+enum class SolverChoice {
+    Auto,       ///< the cheapest suitable one for the structure of the matrix (see detectStructure)
+    GeneralLU,  ///< LU decomposition with pivoting regardless of the structure (sparse, for large sparse matrices)
+};
+
+
+/**
+ * The factorization a linear system Ax = b was solved with, whatever its kind
+ * (see SolveResult::factorization()).
+ */
+class Factorization {
+public:
+    virtual ~Factorization() = default;
+
+    /// Solutions of Ax = b, one per right-hand side in bs
+    virtual std::vector<Vector> solve(const std::vector<Vector> &bs) const = 0;
+    /// Row permutation (the identity if the factorization doesn't pivot)
+    virtual const Permutation::Vector &perm() const = 0;
+    /// Column permutation (empty if there is none)
+    virtual const Permutation::Vector &colPerm() const = 0;
+    /// 0 if the row and column permutations together are even, 1 if odd
+    virtual bool parity() const = 0;
+    /// Norm of A^-1 (L1 or Inf)
+    virtual double inverseNorm(NormType nt) const = 0;
+};
 
 
 /// Utility class to store the result of solving a linear system
@@ -23,19 +92,81 @@ public:
     */
     const Vector &solution() const;
 
-    inline const LUDecomposition &getLU() const { return _luObj; }
-    inline double tol() const { return _success ? _luObj.tol() : _tol; }
+    /**
+     * Numerical solutions, one per right-hand side (in the same order).
+     * @pre `bool(this)` is `true`.
+     */
+    const std::vector<Vector> &solutions() const;
+
+    /// How the system was solved: which of the getters below holds the factorization
+    inline SolveMethod method() const { return _method; }
+    /// Whether the matrix was factored in sparse storage (getSparseLU()) rather than dense (getLU())
+    inline bool isSparse() const { return _method == SolveMethod::SparseLU; }
+    /// Whether the matrix was factored through its block triangular form (getBTF())
+    inline bool isBlockTriangular() const { return _method == SolveMethod::BlockTriangular; }
+    /// The factorization that solved the system (null for iterative solves, which don't factor the matrix)
+    inline const Factorization *factorization() const { return _factorization.get(); }
+    /**
+     * Dense LU decomposition of the matrix
+     * @throws MatrixError if the system was solved another way (see method()), e.g. in sparse storage
+     */
+    const LUDecomposition &getLU() const;
+    // likewise, the other decompositions (see SolveMethod):
+    const SparseLUDecomposition &getSparseLU() const;
+    const BTFDecomposition &getBTF() const;
+    const BandLUDecomposition &getBandLU() const;
+    const SkylineLUDecomposition &getSkylineLU() const;
+    const SkylineLDLTDecomposition &getSkylineLDLT() const;
+    const TriangularDecomposition &getTriangular() const;
+    const TridiagonalLUDecomposition &getTridiagonal() const;
+    const CholeskyDecomposition &getCholesky() const;
+    const LDLTDecomposition &getLDLT() const;
+    const ToeplitzDecomposition &getToeplitz() const;
+    /// Row permutation of the factorization (the identity if it doesn't pivot). Empty for iterative solves,
+    /// which don't factor the matrix.
+    const Permutation::Vector &perm() const;
+    /// Column permutation of the factorization (empty if there is none, as in the dense case)
+    const Permutation::Vector &colPerm() const;
+    /// Tolerance used: the pivot tolerance, or the target relative residual for iterative solves
+    inline double tol() const { return _tol; }
+    inline const LUStatus &status() const { return _status; }  ///< factorization status
 
+    /// Whether the solutions come from an iterative method (see solve(const SparseMatrix &, const std::vector<Vector> &, const IterativeOptions &))
+    inline bool isIterative() const { return _method == SolveMethod::Iterative; }
+    /// Whether every iterative solve reached the target residual
+    bool converged() const;
+    /// Iterations taken for each right-hand side (iterative solves only)
+    inline const std::vector<size_t> &iterations() const { return _iterations; }
+    /// Final relative residual ||b - Ax||_2/||b||_2 of each right-hand side (iterative solves only)
+    inline const std::vector<double> &iterativeResiduals() const { return _iterativeResiduals; }
 private:
     bool _success = false;
-    LUDecomposition _luObj = {};
-    Vector _solution = {};
+    SolveMethod _method = SolveMethod::LU;
+    std::unique_ptr<const Factorization> _factorization = {};
+    std::vector<Vector> _solutions = {};
     double _tol = numcomp::DEFAULT_TOL; ///< tolerance used
+    LUStatus _status = {};
+    std::vector<size_t> _iterations = {};
+    std::vector<double> _iterativeResiduals = {};
 
-    explicit SolveResult(bool success, LUDecomposition &&luObj, Vector &&solution);
-    explicit SolveResult(double tol) : _tol(tol) {}
+    explicit SolveResult(double tol, LUStatus status) : _tol(tol), _status(status) {}
 
-    friend SolveResult solve(const Matrix &, const Vector &, double tol);
+    /**
+     * Keep the decomposition `dec` of the matrix, as the factorization of `method`, and solve for bs with it.
+     * perm and colPerm are the permutations to report if `dec` doesn't hold its own.
+     */
+    template<typename Decomposition>
+    void setFactorization(SolveMethod method, Decomposition &&dec, const std::vector<Vector> &bs,
+                          Permutation::Vector perm = {}, Permutation::Vector colPerm = {});
+
+    /// Solve with the cheapest solver for the structure of A (see SolverChoice::Auto)
+    static SolveResult solveStructured(const Matrix &A, const std::vector<Vector> &bs, double tol);
+    /// Solve with the dense LU decomposition
+    static SolveResult solveGeneral(const Matrix &A, const std::vector<Vector> &bs, double tol);
+
+    friend SolveResult solve(const Matrix &, const std::vector<Vector> &, double tol, SolverChoice);
+    friend SolveResult solve(const SparseMatrix &, const std::vector<Vector> &, double tol);
+    friend SolveResult solve(const SparseMatrix &, const std::vector<Vector> &, const IterativeOptions &);
 };
 
 
@@ -43,12 +174,65 @@ private:
  * Solve the linear system Ax = b
  * @param A  matrix
  * @param b  vector of independent terms
+ * @param choice  whether to pick the solver after the structure of A (see below) or to force general LU
  * @return  a SolveResult object which evaluates to `true` if
  * the procedure was successful, and `false` otherwise (A is singular).
  * In the former case, result.solution() will be the numerical solution to
  * the system Ax = b.
+ *
+ * An O(n^2) scan of A (see detectStructure) first picks the cheapest suitable solver, in this order:
+ * diagonal and (permuted) triangular matrices need no factorization; tridiagonal matrices get a
+ * tridiagonal LU decomposition, other narrow band matrices a band one (see BAND_MAX_FRACTION); large sparse matrices, a sparse one;
+ * Toeplitz matrices the Levinson-Trench recursion (see ToeplitzDecomposition), unless a solution has
+ * a backward error ||Ax - b||/(||A|| ||x||) above tol, which an ill-conditioned leading submatrix
+ * can cause, in which case the dense LU decomposition takes over; symmetric,
+ * strictly diagonally dominant matrices with a positive diagonal (positive definite, then) and a
+ * small envelope (see SKYLINE_MAX_FRACTION) an LDL^T decomposition in skyline storage; other
+ * symmetric matrices a Cholesky decomposition if it succeeds, else a Bunch-Kaufman LDL^T one;
+ * the other strictly diagonally dominant ones an LU decomposition without pivoting in skyline
+ * storage; reducible matrices with at least DENSE_BTF_MIN_SIZE rows the LU decomposition of the
+ * diagonal blocks of their block triangular form (see BTFDecomposition); anything else the dense
+ * LU decomposition. result.method() tells which.
+ */
+SolveResult solve(const Matrix &A, const Vector &b, double tol = numcomp::DEFAULT_TOL,
+                  SolverChoice choice = SolverChoice::Auto);
+
+/**
+ * Solve the linear systems Ax = b for several right-hand sides b, factoring A once.
+ * @param A  matrix
+ * @param bs  vectors of independent terms (at least one)
+ * @return  like solve(const Matrix &, const Vector &, double, SolverChoice), but with
+ * result.solutions()[k] being the solution for bs[k].
+ * @throws MatrixError if bs is empty
+ */
+SolveResult solve(const Matrix &A, const std::vector<Vector> &bs, double tol = numcomp::DEFAULT_TOL,
+                  SolverChoice choice = SolverChoice::Auto);
+
+/**
+ * Solve the linear systems Ax = b for a sparse matrix A, through its sparse LU decomposition
+ * (see SparseLUDecomposition). The solve functions taking a dense matrix dispatch to this one
+ * when the matrix has at least SPARSE_MIN_SIZE rows and is sparse enough (see preferSparse).
+ * Reducible matrices are factored through their block triangular form instead (see BTFDecomposition).
+ * @throws MatrixError if bs is empty
  */
-SolveResult solve(const Matrix &A, const Vector &b, double tol = numcomp::DEFAULT_TOL);
+SolveResult solve(const SparseMatrix &A, const std::vector<Vector> &bs, double tol = numcomp::DEFAULT_TOL);
+
+/**
+ * Solve the linear systems Ax = b for a sparse matrix A with a preconditioned Krylov method
+ * (see IterativeOptions), without factoring A. The preconditioner is built once for all the
+ * right-hand sides.
+ * @return  a SolveResult object which evaluates to `false` if the preconditioner meets a zero
+ * pivot. Otherwise, it holds the last iterates, and result.converged() tells whether they all
+ * reached `options.tol` within `options.maxIterations`.
+ * @throws MatrixError if bs is empty
+ */
+SolveResult solve(const SparseMatrix &A, const std::vector<Vector> &bs, const IterativeOptions &options);
+
+/// Keep `solve(A, {b0, b1, ...})` meaning a single right-hand side
+inline SolveResult solve(const Matrix &A, std::initializer_list<double> b, double tol = numcomp::DEFAULT_TOL,
+                         SolverChoice choice = SolverChoice::Auto) {
+    return solve(A, Vector(b), tol, choice);
+}
 
 /**
  * Calculate the relative residue for the approximate solution x
@@ -60,15 +244,28 @@ SolveResult solve(const Matrix &A, const Vector &b, double tol = numcomp::DEFAUL
  */
 double residue(const Matrix &A, const Vector &x, const Vector &b);
 
+/// Relative residue for a sparse matrix (see residue(const Matrix &, const Vector &, const Vector &))
+double residue(const SparseMatrix &A, const Vector &x, const Vector &b);
+
 struct ExtraSolveInfo {
     double residue;
     double cond1;
     double condInf;
+    std::vector<double> residues;  ///< residue of each right-hand side's solution
 };
 
 /// Fill an ExtraSolveInfo struct with data from the solve result of Ax = b
 ExtraSolveInfo getExtraSolveInfo(const Matrix &A, const Vector &b, const SolveResult &res);
 
+/**
+ * Fill an ExtraSolveInfo struct with data from the solve result of Ax = b for every b in bs
+ * @throws MatrixError if bs is empty or the result holds another number of solutions
+ */
+ExtraSolveInfo getExtraSolveInfo(const Matrix &A, const std::vector<Vector> &bs, const SolveResult &res);
+
+/// Sparse counterpart of getExtraSolveInfo(const Matrix &, const std::vector<Vector> &, const SolveResult &)
+ExtraSolveInfo getExtraSolveInfo(const SparseMatrix &A, const std::vector<Vector> &bs, const SolveResult &res);
+
 //----- C-style interface -----//
 
 int sistema(double **a, double x[], double b[], int n, double tol);
@@ -0,0 +1,24 @@
+#ifndef LU_STREAM_H
+#define LU_STREAM_H
+
+#include <istream>
+#include <ostream>
+#include "LUDecomposition.h"
+#include "writer.h"
+
+
+/**
+ * Solve Ax = b for a stream of right-hand sides b, reusing a single factorization of A.
+ * Each b is either a text vector in readVector's sparse format or a binary vector
+ * section (see binary.h); both may be mixed. Every solution is written to `out` as
+ * soon as it's computed (in the given format) and the stream is flushed, so this
+ * can serve as a long-running solver process behind a pair of pipes.
+ * @param luObj  LU decomposition of A
+ * @return  the number of right-hand sides solved
+ * @throws BadFormat if some right-hand side is malformed (the previous ones have been answered)
+ */
+size_t streamSolve(const LUDecomposition &luObj, std::istream &in, std::ostream &out,
+                   OutputFormat format = OutputFormat::Text);
+
+
+#endif //LU_STREAM_H
@@ -0,0 +1,87 @@
+#ifndef LU_STRUCTURE_H
+#define LU_STRUCTURE_H
+
+#include "BandMatrix.h"
+#include "LUDecomposition.h"
+#include "Matrix.h"
+#include "Permutation.h"
+#include "SparseMatrix.h"
+#include "numcomp.h"
+
+
+/// Matrices whose band (kl + ku + 1 diagonals) is at most this fraction of n are factored in band storage
+const double BAND_MAX_FRACTION = 0.25;
+
+/// What a single O(n^2) scan of a dense matrix tells about its structure
+struct MatrixStructure {
+    size_t nnz = 0;  ///< number of non-zero entries
+    Bandwidth band;  ///< bandwidth of the non-zero entries
+    size_t profile = 0;  ///< number of entries in the envelope (see SkylineMatrix), diagonal included
+    bool symmetric = true;
+    bool diagonallyDominant = true;  ///< strictly, by rows: |A(i, i)| > sum of |A(i, j)| over j != i
+    bool positiveDiagonal = true;
+    bool toeplitz = true;  ///< constant along each diagonal (see ToeplitzMatrix)
+
+    inline bool isDiagonal() const { return band.lower == 0 and band.upper == 0; }
+    inline bool isLowerTriangular() const { return band.upper == 0; }
+    inline bool isUpperTriangular() const { return band.lower == 0; }
+    inline bool isTridiagonal() const { return band.lower <= 1 and band.upper <= 1; }
+    /// Whether the band is narrow enough for band storage to pay off (see BAND_MAX_FRACTION)
+    bool isNarrowBand(size_t n) const;
+};
+
+/// Scan a matrix for the structure its solver could exploit
+MatrixStructure detectStructure(const Matrix &A);
+
+/**
+ * Look for row and column orders making a matrix lower triangular, i.e. PAQ lower triangular
+ * with row rowOrder[k] and column colOrder[k] of A in position k: repeatedly take a row with
+ * a single non-zero entry in the columns not taken yet (O(n^2) overall).
+ * @return  false if there are none (A isn't a permuted triangular matrix, or is structurally singular)
+ */
+bool findTriangularOrder(const Matrix &A, Permutation::Vector &rowOrder, Permutation::Vector &colOrder);
+
+
+/**
+ * Solver for (permuted) triangular matrices, which need no factorization: A is kept as it is
+ * (in CSR storage), and substitution follows the order in which PAQ is lower triangular.
+ * Diagonal, lower and upper triangular matrices are the special cases where P and Q are the
+ * identity, or both the reversal.
+ */
+class TriangularDecomposition {
+public:
+    /**
+     * Prepare to solve systems with a permuted triangular matrix.
+     * @param tol  numerical tolerance: the matrix is deemed singular if a diagonal entry of PAQ
+     * is smaller than this (in absolute value)
+     * @throws MatrixError if A isn't a permuted triangular matrix (see findTriangularOrder)
+     * @throws SingularMatrixError if A is singular
+     */
+    explicit TriangularDecomposition(const Matrix &A, double tol = numcomp::DEFAULT_TOL);
+    TriangularDecomposition() = default;
+
+    /// Exception-free counterpart of the constructor (only throws MatrixError for non-triangular A)
+    LUStatus tryFactor(const Matrix &A, double tol = numcomp::DEFAULT_TOL);
+    /// Like tryFactor(const Matrix &, double), with known orders making PAQ lower triangular
+    LUStatus tryFactor(const Matrix &A, Permutation::Vector rowOrder, Permutation::Vector colOrder,
+                       double tol = numcomp::DEFAULT_TOL);
+
+    // getters:
+    inline size_t size() const { return _A.size(); }
+    inline const SparseMatrix &matrix() const { return _A; }
+    /// Position in values() of the k-th diagonal entry of PAQ
+    inline const std::vector<index_t> &pivots() const { return _pivots; }
+    inline const Permutation::Vector &rowOrder() const { return _rowOrder; }
+    inline const Permutation::Vector &colOrder() const { return _colOrder; }
+    inline double tol() const { return _tol; }
+    bool parity() const;  ///< 0 if P and Q together make an even permutation, 1 if odd
+
+private:
+    SparseMatrix _A;
+    std::vector<index_t> _pivots;
+    Permutation::Vector _rowOrder, _colOrder;
+    double _tol = numcomp::DEFAULT_TOL;  ///< numerical tolerance
+};
+
+
+#endif //LU_STRUCTURE_H
@@ -0,0 +1,63 @@
+#ifndef LU_WRITER_H
+#define LU_WRITER_H
+
+#include <ostream>
+#include <string>
+#include "aliases.h"
+#include "Vector.h"
+
+
+/// Output file formats for solutions
+enum class OutputFormat {
+    Text,    ///< the classic human-readable SOLUTION_*.DAT format
+    CSV,     ///< index,solution,permutation columns (full round-trip precision)
+    Binary,  ///< a binary vector section (see binary.h) holding the solution
+};
+
+
+/**
+ * Buffered writer that formats numbers itself instead of going through
+ * iostream's formatting machinery. Text output is byte-identical to what
+ * `os << std::setw(w) << index` and `os << std::scientific << value` produce.
+ */
+class OutputWriter {
+public:
+    explicit OutputWriter(std::ostream &os, size_t bufferSize = size_t(1) << 16);
+    ~OutputWriter();  ///< flushes
+
+    OutputWriter(const OutputWriter &) = delete;
+    OutputWriter &operator=(const OutputWriter &) = delete;
+
+    void write(const char *str, size_t length);
+    void write(const char *str);
+    void write(const std::string &str) { write(str.data(), str.size()); }
+    void put(char c);
+
+    /// Unsigned decimal, right-aligned in a field of the given width
+    void writeIndex(size_t value, unsigned width = 0);
+
+    /// Same as printf's "%.<precision>e"
+    void writeScientific(double value, unsigned precision);
+
+    /// Write the buffer's contents to the underlying stream
+    void flush();
+
+    inline std::ostream &stream() { return _os; }
+
+private:
+    std::ostream &_os;
+    std::string _buffer;
+    size_t _used = 0;
+
+    char *reserve(size_t length);  ///< pointer to at least `length` free bytes in the buffer
+};
+
+
+/**
+ * Format `value` like printf's "%.<precision>e" into `out` (which must have
+ * room for at least 32 characters) and return the number of characters written.
+ */
+size_t formatScientific(double value, unsigned precision, char *out);
+
+
+#endif //LU_WRITER_H
@@ -0,0 +1,253 @@
+#include "BTF.h"
+
+#include <algorithm>
+#include <utility>
+#include "errors.h"
+#include "ThreadPool.h"
+
+
+namespace {
+    const index_t NONE = index_t(-1);
+}
+
+std::vector<index_t> maximumTransversal(const SparseMatrix &A_) {
+    const SparseMatrix &A = A_.layout() == SparseLayout::CSC ? A_ : A_.converted(SparseLayout::CSC);
+    const size_t n = A.size();
+    const auto &pointers = A.pointers();
+    const auto &indices = A.indices();
+
+    std::vector<index_t> rowOfCol(n, NONE), colOfRow(n, NONE);
+    std::vector<index_t> cheap(pointers.begin(), pointers.end() - 1);  // next entry to try for a free row
+    std::vector<index_t> visited(n, NONE);  // last search which visited each row
+    std::vector<index_t> stackCol(n), stackRow(n), next(n);
+
+    for (index_t j = 0; j < n; ++j) {
+        // depth-first search for an augmenting path from column j
+        long head = 0;
+        stackCol[0] = j;
+        next[0] = pointers[j];
+        index_t found = NONE;
+        while (head >= 0) {
+            const index_t c = stackCol[head];
+            for (index_t &p = cheap[c]; p < pointers[c + 1]; ++p)
+                if (colOfRow[indices[p]] == NONE) {
+                    found = indices[p];
+                    break;
+                }
+            if (found != NONE) break;
+
+            bool descended = false;
+            for (index_t &q = next[head]; q < pointers[c + 1];) {
+                const index_t r = indices[q++];
+                if (visited[r] == j) continue;
+                visited[r] = j;
+                stackRow[head] = r;
+                stackCol[++head] = colOfRow[r];
+                next[head] = pointers[colOfRow[r]];
+                descended = true;
+                break;
+            }
+            if (not descended) --head;
+        }
+        if (found == NONE) continue;  // column j stays unmatched
+
+        // flip the path: each column on it takes the row that led to the next one
+        index_t r = found;
+        for (long h = head; h >= 0; --h) {
+            rowOfCol[stackCol[h]] = r;
+            colOfRow[r] = stackCol[h];
+            if (h > 0) r = stackRow[h - 1];
+        }
+    }
+
+    return rowOfCol;
+}
+
+BlockTriangularForm blockTriangularForm(const SparseMatrix &A_) {
+    const SparseMatrix &A = A_.layout() == SparseLayout::CSR ? A_ : A_.converted(SparseLayout::CSR);
+    const size_t n = A.size();
+    BlockTriangularForm form;
+
+    // Put the matched entries on the diagonal: node j stands for column j and its matched row
+    std::vector<index_t> rowOfCol = maximumTransversal(A);
+    std::vector<bool> rowMatched(n, false);
+    for (index_t j = 0; j < n; ++j)
+        if (rowOfCol[j] != NONE) {
+            rowMatched[rowOfCol[j]] = true;
+            ++form.rank;
+        }
+    for (index_t j = 0, i = 0; j < n; ++j) {
+        if (rowOfCol[j] != NONE) continue;
+        while (rowMatched[i]) ++i;
+        rowOfCol[j] = i++;
+    }
+
+    // Tarjan's algorithm on the graph j -> k for every entry (rowOfCol[j], k) of A. Components
+    // come out after all those reachable from them, i.e. in reverse topological order.
+    std::vector<index_t> number(n, NONE), low(n), stack, callNode(n), callNext(n);
+    std::vector<bool> onStack(n, false);
+    std::vector<index_t> order;  // nodes by component, in reverse topological order
+    std::vector<index_t> componentEnds;
+    order.reserve(n);
+    index_t counter = 0;
+    for (index_t root = 0; root < n; ++root) {
+        if (number[root] != NONE) continue;
+        long head = 0;
+        callNode[0] = root;
+        callNext[0] = A.pointers()[rowOfCol[root]];
+        number[root] = low[root] = counter++;
+        stack.push_back(root);
+        onStack[root] = true;
+
+        while (head >= 0) {
+            const index_t v = callNode[head];
+            const index_t end = A.pointers()[rowOfCol[v] + 1];
+            bool descended = false;
+            for (index_t &p = callNext[head]; p < end;) {
+                const index_t w = A.indices()[p++];
+                if (number[w] == NONE) {
+                    number[w] = low[w] = counter++;
+                    stack.push_back(w);
+                    onStack[w] = true;
+                    callNode[++head] = w;
+                    callNext[head] = A.pointers()[rowOfCol[w]];
+                    descended = true;
+                    break;
+                }
+                if (onStack[w]) low[v] = std::min(low[v], number[w]);
+            }
+            if (descended) continue;
+
+            if (low[v] == number[v]) {
+                const size_t first = order.size();
+                index_t w;
+                do {
+                    w = stack.back();
+                    stack.pop_back();
+                    onStack[w] = false;
+                    order.push_back(w);
+                } while (w != v);
+                std::sort(order.begin() + first, order.end());  // keep the original order within blocks
+                componentEnds.push_back(order.size());
+            }
+            if (--head >= 0) low[callNode[head]] = std::min(low[callNode[head]], low[v]);
+        }
+    }
+
+    // Blocks in topological order give an upper triangular block structure
+    form.rowPerm.resize(n);
+    form.colPerm.resize(n);
+    form.blocks = {0};
+    index_t k = 0;
+    for (long c = long(componentEnds.size()) - 1; c >= 0; --c) {
+        const index_t first = c > 0 ? componentEnds[c - 1] : 0;
+        for (index_t p = first; p < componentEnds[c]; ++p, ++k) {
+            form.colPerm[k] = order[p];
+            form.rowPerm[k] = rowOfCol[order[p]];
+        }
+        form.blocks.push_back(k);
+    }
+
+    return form;
+}
+
+
+BTFDecomposition::BTFDecomposition(const SparseMatrix &A, double tol) {
+    LUStatus status = tryFactor(A, tol);
+    if (not status) throw SingularMatrixError(tol, "at pivot " + std::to_string(status.pivot));
+}
+
+LUStatus BTFDecomposition::tryFactor(const SparseMatrix &A, double tol) {
+    return tryFactor(A, blockTriangularForm(A), tol);
+}
+
+LUStatus BTFDecomposition::tryFactor(const SparseMatrix &A_, BlockTriangularForm form, double tol) {
+    const SparseMatrix &A = A_.layout() == SparseLayout::CSR ? A_ : A_.converted(SparseLayout::CSR);
+    const size_t n = A.size();
+    _form = std::move(form);
+    _tol = tol;
+    if (_form.rank < n) return LUStatus::singularAt(_form.rank);
+
+    // C = PAQ, in CSR layout
+    std::vector<index_t> colPosition(n);
+    for (index_t k = 0; k < n; ++k) colPosition[_form.colPerm[k]] = k;
+    std::vector<index_t> pointers = {0}, indices;
+    std::vector<double> values;
+    indices.reserve(A.nnz());
+    values.reserve(A.nnz());
+    std::vector<std::pair<index_t, double>> row;
+    for (index_t k = 0; k < n; ++k) {
+        const index_t i = _form.rowPerm[k];
+        row.clear();
+        for (index_t p = A.pointers()[i]; p < A.pointers()[i + 1]; ++p)
+            row.emplace_back(colPosition[A.indices()[p]], A.values()[p]);
+        std::sort(row.begin(), row.end(),
+                  [](const std::pair<index_t, double> &a, const std::pair<index_t, double> &b) {
+                      return a.first < b.first;
+                  });
+        for (const auto &entry : row) {
+            indices.push_back(entry.first);
+            values.push_back(entry.second);
+        }
+        pointers.push_back(indices.size());
+    }
+    _C = SparseMatrix(n, SparseLayout::CSR, std::move(pointers), std::move(indices), std::move(values));
+
+    // Factor the diagonal blocks independently
+    const size_t blocks = _form.blockCount();
+    _isSparse.assign(blocks, 0);
+    _dense.assign(blocks, LUDecomposition());
+    _sparse.assign(blocks, SparseLUDecomposition());
+    std::vector<LUStatus> statuses(blocks);
+    parallelFor(blocks, [&](index_t b) {
+        const index_t first = _form.blocks[b], last = _form.blocks[b + 1];
+        const size_t m = last - first;
+        std::vector<index_t> blockPointers = {0}, blockIndices;
+        std::vector<double> blockValues;
+        for (index_t i = first; i < last; ++i) {
+            for (index_t p = _C.pointers()[i]; p < _C.pointers()[i + 1]; ++p) {
+                const index_t j = _C.indices()[p];
+                if (j >= last) break;  // rows are sorted, and nothing lies left of the block
+                blockIndices.push_back(j - first);
+                blockValues.push_back(_C.values()[p]);
+            }
+            blockPointers.push_back(blockIndices.size());
+        }
+
+        if (m >= SPARSE_MIN_SIZE and preferSparse(m, blockValues.size())) {
+            _isSparse[b] = 1;
+            statuses[b] = _sparse[b].tryFactor(SparseMatrix(m, SparseLayout::CSR, std::move(blockPointers),
+                                                            std::move(blockIndices), std::move(blockValues)), tol);
+        } else {
+            Matrix block(m);
+            for (index_t i = 0; i < m; ++i)
+                for (index_t p = blockPointers[i]; p < blockPointers[i + 1]; ++p)
+                    block[i][blockIndices[p]] = blockValues[p];
+            statuses[b] = _dense[b].tryFactor(block, tol);
+        }
+    });
+    for (index_t b = 0; b < blocks; ++b)
+        if (not statuses[b]) return LUStatus::singularAt(_form.blocks[b] + statuses[b].pivot);
+
+    // Overall pivot order: the block permutations within the block triangular one
+    _rowPerm.resize(n);
+    _colPerm.resize(n);
+    for (index_t b = 0; b < blocks; ++b) {
+        const index_t first = _form.blocks[b], m = _form.blocks[b + 1] - first;
+        for (index_t i = 0; i < m; ++i) {
+            if (_isSparse[b]) {
+                _rowPerm[first + i] = _form.rowPerm[first + _sparse[b].rowPerm()[i]];
+                _colPerm[first + i] = _form.colPerm[first + _sparse[b].colPerm()[i]];
+            } else {
+                _rowPerm[first + i] = _form.rowPerm[first + _dense[b].perm().vector()[i]];
+                _colPerm[first + i] = _form.colPerm[first + i];
+            }
+        }
+    }
+
+    return {};
+}
+
+bool BTFDecomposition::parity() const {
+    return permutationParity(_rowPerm) != permutationParity(_colPerm);
+}
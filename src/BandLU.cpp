@@ -0,0 +1,72 @@
+#include "BandLU.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include "errors.h"
+
+
+BandLUDecomposition::BandLUDecomposition(const BandMatrix &A, double tol) {
+    LUStatus status = tryFactor(A, tol);
+    if (not status) throw SingularMatrixError(tol, "at pivot " + std::to_string(status.pivot));
+}
+
+LUStatus BandLUDecomposition::tryFactor(const BandMatrix &A, double tol) {
+    _LU = A;
+    _tol = tol;
+    return decompose();
+}
+
+LUStatus BandLUDecomposition::decompose() {
+    const size_t n = _LU.size(), kl = _LU.lower(), ku = _LU.upper();
+    _pivots.assign(n, 0);
+
+    // the fill-in slots (the first kl of each column) may hold leftovers of the caller's data
+    auto &data = _LU.data();
+    for (index_t j = 0; j < n; ++j) std::fill_n(data.begin() + j*_LU.ldab(), kl, 0.0);
+
+    size_t lastColumn = 0;  // last column touched by the row interchanges so far
+    for (index_t j = 0; j < n; ++j) {
+        const size_t below = std::min(kl, n - 1 - j);  // sub-diagonal entries in column j
+
+        // Partial pivoting within the band
+        index_t pivotRow = j;
+        double largest = std::abs(_LU.at(j, j));
+        for (index_t i = j + 1; i <= j + below; ++i)
+            if (std::abs(_LU.at(i, j)) > largest) {
+                largest = std::abs(_LU.at(i, j));
+                pivotRow = i;
+            }
+        _pivots[j] = pivotRow;
+        if (largest < _tol) return LUStatus::singularAt(j);
+
+        lastColumn = std::max(lastColumn, std::min(n - 1, pivotRow + ku));
+        if (pivotRow != j)
+            for (index_t k = j; k <= lastColumn; ++k) std::swap(_LU.at(j, k), _LU.at(pivotRow, k));
+
+        // Multipliers, then rank-one update of the trailing band
+        const double pivot = _LU.at(j, j);
+        for (index_t i = j + 1; i <= j + below; ++i) _LU.at(i, j) /= pivot;
+        for (index_t k = j + 1; k <= lastColumn; ++k) {
+            const double u = _LU.at(j, k);
+            if (u == 0.0) continue;
+            for (index_t i = j + 1; i <= j + below; ++i) _LU.at(i, k) -= _LU.at(i, j)*u;
+        }
+    }
+
+    return {};
+}
+
+Permutation::Vector BandLUDecomposition::perm() const {
+    const size_t n = size();
+    Permutation::Vector result(n);
+    for (index_t i = 0; i < n; ++i) result[i] = i;
+    for (index_t j = 0; j < n; ++j) std::swap(result[j], result[_pivots[j]]);
+    return result;
+}
+
+bool BandLUDecomposition::parity() const {
+    bool parity = false;
+    for (index_t j = 0; j < size(); ++j) parity ^= _pivots[j] != j;
+    return parity;
+}
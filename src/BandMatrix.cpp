@@ -0,0 +1,99 @@
+#include "BandMatrix.h"
+
+#include <stdexcept>
+#include "errors.h"
+
+
+Bandwidth bandwidth(const Matrix &A) {
+    const size_t n = A.size();
+    Bandwidth band;
+    for (index_t i = 0; i < n; ++i) {
+        // only the outermost non-zero entries of each row matter
+        index_t first = 0, last = n;
+        while (first < i and A[i][first] == 0.0) ++first;
+        while (last > i + 1 and A[i][last - 1] == 0.0) --last;
+        band.add(i, first);
+        band.add(i, last - 1);
+    }
+    return band;
+}
+
+Bandwidth bandwidth(const SparseMatrix &A) {
+    const size_t n = A.size();
+    const bool csr = A.layout() == SparseLayout::CSR;
+    Bandwidth band;
+    for (index_t k = 0; k < n; ++k)
+        for (index_t p = A.pointers()[k]; p < A.pointers()[k + 1]; ++p) {
+            if (csr) band.add(k, A.indices()[p]);
+            else band.add(A.indices()[p], k);
+        }
+    return band;
+}
+
+
+//-------------------- BandMatrix -------------------//
+
+BandMatrix::BandMatrix(size_t n, size_t kl, size_t ku)
+        : _n(n), _kl(std::min(kl, n ? n - 1 : 0)), _ku(std::min(ku, n ? n - 1 : 0)),
+          _data(n*ldab(), 0.0) {}
+
+BandMatrix BandMatrix::fromDense(const Matrix &A) {
+    const Bandwidth band = bandwidth(A);
+    return fromDense(A, band.lower, band.upper);
+}
+
+BandMatrix BandMatrix::fromDense(const Matrix &A, size_t kl, size_t ku) {
+    const size_t n = A.size();
+    BandMatrix result(n, kl, ku);
+    for (index_t i = 0; i < n; ++i)
+        for (index_t j = 0; j < n; ++j) {
+            if (result.inBand(i, j)) result.at(i, j) = A[i][j];
+            else if (A[i][j] != 0.0) throw MatrixError("non-zero entry outside the band");
+        }
+    return result;
+}
+
+BandMatrix BandMatrix::fromSparse(const SparseMatrix &A) {
+    const Bandwidth band = bandwidth(A);
+    const size_t n = A.size();
+    const bool csr = A.layout() == SparseLayout::CSR;
+    BandMatrix result(n, band.lower, band.upper);
+    for (index_t k = 0; k < n; ++k)
+        for (index_t p = A.pointers()[k]; p < A.pointers()[k + 1]; ++p) {
+            if (csr) result.at(k, A.indices()[p]) = A.values()[p];
+            else result.at(A.indices()[p], k) = A.values()[p];
+        }
+    return result;
+}
+
+double BandMatrix::operator()(index_t i, index_t j) const {
+    if (i >= _n or j >= _n) throw std::out_of_range("band matrix index out of range");
+    return inBand(i, j) ? at(i, j) : 0.0;
+}
+
+void BandMatrix::set(index_t i, index_t j, double value) {
+    if (i >= _n or j >= _n) throw std::out_of_range("band matrix index out of range");
+    if (not inBand(i, j)) throw std::out_of_range("band matrix entry outside the band");
+    at(i, j) = value;
+}
+
+Matrix BandMatrix::toDense() const {
+    Matrix result(_n);
+    for (index_t j = 0; j < _n; ++j) {
+        const index_t first = j > _ku ? j - _ku : 0, last = std::min(_n, j + _kl + 1);
+        for (index_t i = first; i < last; ++i) result[i][j] = at(i, j);
+    }
+    return result;
+}
+
+
+Vector operator*(const BandMatrix &A, const Vector &v) {
+    const size_t n = A.size();
+    if (v.size() != n) throw MatrixError("vector and matrix size are different");
+    Vector result(0.0, n);
+    for (index_t j = 0; j < n; ++j) {
+        const index_t first = j > A.upper() ? j - A.upper() : 0, last = std::min(n, j + A.lower() + 1);
+        for (index_t i = first; i < last; ++i) result[i] += A.at(i, j)*v[j];
+    }
+    return result;
+}
@@ -0,0 +1,173 @@
+#include "Cholesky.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include "errors.h"
+#include "ThreadPool.h"
+
+
+//-------------------- CholeskyDecomposition -------------------//
+
+CholeskyDecomposition::CholeskyDecomposition(const Matrix &A, double tol, bool parallel)
+        : CholeskyDecomposition(PackedMatrix::fromDense(A), tol, parallel) {}
+
+CholeskyDecomposition::CholeskyDecomposition(const PackedMatrix &A, double tol, bool parallel) {
+    LUStatus status = tryFactor(A, tol, parallel);
+    if (not status) throw SingularMatrixError(tol, "at pivot " + std::to_string(status.pivot));
+}
+
+LUStatus CholeskyDecomposition::tryFactor(const Matrix &A, double tol, bool parallel) {
+    return tryFactor(PackedMatrix::fromDense(A), tol, parallel);
+}
+
+LUStatus CholeskyDecomposition::tryFactor(const PackedMatrix &A, double tol, bool parallel) {
+    _L = A;
+    _tol = tol;
+    return decompose(parallel);
+}
+
+LUStatus CholeskyDecomposition::decompose(bool parallel) {
+    const size_t n = _L.size();
+
+    // call f for every row from first on, on the shared pool if worth it
+    auto forEachRow = [&](index_t first, const std::function<void(index_t)> &f) {
+        if (parallel and n - first >= CHOLESKY_PARALLEL_MIN_ROWS) {
+            parallelFor(n - first, [&](index_t r) { f(first + r); });
+        } else {
+            for (index_t i = first; i < n; ++i) f(i);
+        }
+    };
+
+    for (index_t k0 = 0; k0 < n; k0 += CHOLESKY_BLOCK_SIZE) {
+        const index_t k1 = std::min(n, k0 + CHOLESKY_BLOCK_SIZE);
+        // columns k0 to k1 of row i, given those of the rows above (the previous block columns
+        // have already been subtracted from it)
+        auto panelRow = [&](index_t i) {
+            double *row = _L.row(i);
+            for (index_t j = k0; j < std::min(i, k1); ++j) {
+                const double *pivotRow = _L.row(j);
+                row[j] = (row[j] - std::inner_product(row + k0, row + j, pivotRow + k0, 0.0))/pivotRow[j];
+            }
+        };
+
+        // diagonal block
+        for (index_t i = k0; i < k1; ++i) {
+            panelRow(i);
+            double *row = _L.row(i);
+            const double pivot = row[i] - std::inner_product(row + k0, row + i, row + k0, 0.0);
+            if (pivot < _tol) return LUStatus::singularAt(i);
+            row[i] = std::sqrt(pivot);
+        }
+        if (k1 == n) break;
+
+        // the rest of the block column, then its contribution to the trailing rows
+        forEachRow(k1, panelRow);
+        forEachRow(k1, [&](index_t i) {
+            double *row = _L.row(i);
+            for (index_t j = k1; j <= i; ++j)
+                row[j] -= std::inner_product(row + k0, row + k1, _L.row(j) + k0, 0.0);
+        });
+    }
+
+    return {};
+}
+
+
+//-------------------- LDLTDecomposition -------------------//
+
+LDLTDecomposition::LDLTDecomposition(const Matrix &A, double tol)
+        : LDLTDecomposition(PackedMatrix::fromDense(A), tol) {}
+
+LDLTDecomposition::LDLTDecomposition(const PackedMatrix &A, double tol) {
+    LUStatus status = tryFactor(A, tol);
+    if (not status) throw SingularMatrixError(tol, "at pivot " + std::to_string(status.pivot));
+}
+
+LUStatus LDLTDecomposition::tryFactor(const Matrix &A, double tol) {
+    return tryFactor(PackedMatrix::fromDense(A), tol);
+}
+
+LUStatus LDLTDecomposition::tryFactor(const PackedMatrix &A, double tol) {
+    _LDL = A;
+    _tol = tol;
+    const size_t n = A.size();
+    _twoByTwo.assign(n, false);
+    _perm.resize(n);
+    for (index_t i = 0; i < n; ++i) _perm[i] = i;
+    return decompose();
+}
+
+LUStatus LDLTDecomposition::decompose() {
+    const size_t n = _LDL.size();
+    PackedMatrix &a = _LDL;
+    const double alpha = (1.0 + std::sqrt(17.0))/8.0;  // bounds the growth of the entries
+    Vector w(n), v(n);  // columns of the pivot block, below it
+
+    for (index_t k = 0; k < n;) {
+        // largest entry below the diagonal in column k
+        const double absakk = std::abs(a.at(k, k));
+        index_t imax = k;
+        double colmax = 0.0;
+        for (index_t i = k + 1; i < n; ++i)
+            if (std::abs(a.at(i, k)) > colmax) colmax = std::abs(a.at(imax = i, k));
+        if (std::max(absakk, colmax) < _tol) return LUStatus::singularAt(k);
+
+        // Bunch-Kaufman pivot choice
+        size_t step = 1;
+        index_t kp = k;
+        if (absakk < alpha*colmax) {
+            // largest off-diagonal entry in row and column imax of the trailing matrix
+            double rowmax = 0.0;
+            for (index_t j = k; j < imax; ++j) rowmax = std::max(rowmax, std::abs(a.at(imax, j)));
+            for (index_t i = imax + 1; i < n; ++i) rowmax = std::max(rowmax, std::abs(a.at(i, imax)));
+
+            if (absakk*rowmax >= alpha*colmax*colmax) kp = k;
+            else if (std::abs(a.at(imax, imax)) >= alpha*rowmax) kp = imax;
+            else {
+                kp = imax;
+                step = 2;
+            }
+        }
+
+        // bring kp to position kk, symmetrically (the computed columns of L follow their rows)
+        const index_t kk = k + step - 1;
+        if (kp != kk) {
+            for (index_t j = 0; j < kk; ++j) std::swap(a.at(kk, j), a.at(kp, j));
+            for (index_t j = kk + 1; j < kp; ++j) std::swap(a.at(j, kk), a.at(kp, j));
+            for (index_t i = kp + 1; i < n; ++i) std::swap(a.at(i, kk), a.at(i, kp));
+            std::swap(a.at(kk, kk), a.at(kp, kp));
+            std::swap(_perm[kk], _perm[kp]);
+        }
+
+        // eliminate the pivot block from the trailing matrix, by rows
+        if (step == 1) {
+            const double d = a.at(k, k);
+            for (index_t i = k + 1; i < n; ++i) w[i] = a.at(i, k);
+            for (index_t i = k + 1; i < n; ++i) {
+                double *row = a.row(i);
+                const double l = row[k] = w[i]/d;
+                for (index_t j = k + 1; j <= i; ++j) row[j] -= l*w[j];
+            }
+        } else {
+            _twoByTwo[k] = true;
+            const double d11 = a.at(k, k), d21 = a.at(k + 1, k), d22 = a.at(k + 1, k + 1);
+            const double det = d11*d22 - d21*d21;
+            for (index_t i = k + 2; i < n; ++i) {
+                w[i] = a.at(i, k);
+                v[i] = a.at(i, k + 1);
+            }
+            for (index_t i = k + 2; i < n; ++i) {
+                double *row = a.row(i);
+                // (l1, l2) = (w, v) D^-1
+                const double l1 = row[k] = (w[i]*d22 - v[i]*d21)/det;
+                const double l2 = row[k + 1] = (v[i]*d11 - w[i]*d21)/det;
+                for (index_t j = k + 2; j <= i; ++j) row[j] -= l1*w[j] + l2*v[j];
+            }
+        }
+        k += step;
+    }
+
+    return {};
+}
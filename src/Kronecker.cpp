@@ -0,0 +1,76 @@
+#include "Kronecker.h"
+
+#include "errors.h"
+
+
+KroneckerSystem::KroneckerSystem(const std::vector<Matrix> &factors, double tol) {
+    LUStatus status = tryFactor(factors, tol);
+    if (not status)
+        throw SingularMatrixError(tol, "factor " + std::to_string(_failedFactor)
+                                       + " at pivot " + std::to_string(status.pivot));
+}
+
+KroneckerSystem::KroneckerSystem(const Matrix &A, const Matrix &B, double tol)
+        : KroneckerSystem(std::vector<Matrix>{A, B}, tol) {}
+
+LUStatus KroneckerSystem::tryFactor(const std::vector<Matrix> &factors, double tol) {
+    if (factors.empty()) throw MatrixError("Kronecker product of no factors");
+    for (const Matrix &A : factors)
+        if (A.size() == 0) throw MatrixError("empty Kronecker factor");
+    _tol = tol;
+    _size = 1;
+    _factors.assign(factors.size(), LUDecomposition());
+    for (index_t m = 0; m < factors.size(); ++m) {
+        _size *= factors[m].size();
+        LUStatus status = _factors[m].tryFactor(factors[m], tol);
+        if (not status) {
+            _failedFactor = m;
+            return status;
+        }
+    }
+    return {};
+}
+
+
+Vector kroneckerProduct(const std::vector<Matrix> &factors, const Vector &x) {
+    if (factors.empty()) throw MatrixError("Kronecker product of no factors");
+    size_t size = 1;
+    for (const Matrix &A : factors) {
+        if (A.size() == 0) throw MatrixError("empty Kronecker factor");
+        size *= A.size();
+    }
+    if (x.size() != size) throw MatrixError("vector and matrix size are different");
+
+    // along index m, the tensor is a sequence of n_m x inner row-major slabs, each multiplied by A_m
+    Vector result = x;
+    size_t inner = size;
+    for (const Matrix &A : factors) {
+        const size_t n = A.size();
+        inner /= n;
+        Vector slab(n*inner);
+        for (index_t first = 0; first < size; first += n*inner) {
+            slab = 0.0;
+            for (index_t i = 0; i < n; ++i)
+                for (index_t j = 0; j < n; ++j) {
+                    const double a = A[i][j];
+                    if (a == 0.0) continue;
+                    for (index_t r = 0; r < inner; ++r) slab[i*inner + r] += a*result[first + j*inner + r];
+                }
+            result[std::slice(first, n*inner, 1)] = slab;
+        }
+    }
+    return result;
+}
+
+Matrix kroneckerProduct(const Matrix &A, const Matrix &B) {
+    const size_t nA = A.size(), nB = B.size();
+    Matrix result(nA*nB);
+    for (index_t i = 0; i < nA; ++i)
+        for (index_t k = 0; k < nA; ++k) {
+            const double a = A[i][k];
+            if (a == 0.0) continue;
+            for (index_t j = 0; j < nB; ++j)
+                for (index_t l = 0; l < nB; ++l) result[i*nB + j][k*nB + l] = a*B[j][l];
+        }
+    return result;
+}
@@ -9,15 +9,23 @@
 
 LUDecomposition::LUDecomposition(const Matrix &mat, double tol)
         : _mat(mat), _perm(mat.size()), _tol(tol) {
-    decompose();
+    LUStatus status = decompose();
+    if (not status) throw SingularMatrixError(_tol, "at pivot " + std::to_string(status.pivot));
 }
 
-void LUDecomposition::decompose() {
+LUStatus LUDecomposition::tryFactor(const Matrix &mat, double tol) {
+    _mat = mat;
+    _perm = Permutation(mat.size());
+    _tol = tol;
+    return decompose();
+}
+
+LUStatus LUDecomposition::decompose() {
     const size_t n = _mat.size();
 
     for (index_t pivot_index = 0; pivot_index < n; ++pivot_index) {
         // Swap rows if necessary, and get pivot:
-        scaledPartialPivoting(pivot_index);
+        if (not scaledPartialPivoting(pivot_index)) return LUStatus::singularAt(pivot_index);
         const Matrix::Row &pivot_row = _mat[pivot_index];
         const double pivot = pivot_row[pivot_index];
 
@@ -30,6 +38,8 @@ void LUDecomposition::decompose() {
             row[slice] -= multiplier*pivot_row[slice];
         }
     }
+
+    return {};
 }
 
 
@@ -46,7 +56,7 @@ double max_abs(FIter first, FIter last) {
     return max_value;
 }
 
-void LUDecomposition::scaledPartialPivoting(index_t pivot_index) {
+bool LUDecomposition::scaledPartialPivoting(index_t pivot_index) {
     const size_t n = _mat.size();
     struct { double value; index_t index; } max_pivot = {0, pivot_index};
 
@@ -54,14 +64,87 @@ void LUDecomposition::scaledPartialPivoting(index_t pivot_index) {
         const auto &row = _mat[i];
         double max_abs_value = max_abs(begin(row) + pivot_index, end(row));  // scaling factor
         // if max_abs_value is zero, the whole row is, so the matrix is singular:
-        if (max_abs_value < _tol) throw SingularMatrixError(_tol);
+        if (max_abs_value < _tol) return false;
         // update max pivot:
         double scaled_pivot = std::abs(row[pivot_index])/max_abs_value;
         if (scaled_pivot > max_pivot.value) max_pivot = {scaled_pivot, i};
     }
 
+    // a null pivot column (below the diagonal) also means the matrix is singular:
+    if (max_pivot.value == 0.0) return false;
+
     // Swap the indices with the row with maximal pivot:
     _perm.permute(pivot_index, max_pivot.index);
     std::swap(_mat[pivot_index], _mat[max_pivot.index]);  // constant complexity; just swaps pointers
+    return true;
+}
+
+
+LUStatus LUDecomposition::appendRowCol(const Vector &row, const Vector &col, double diag) {
+    const size_t n = _mat.size();
+    if (row.size() != n or col.size() != n) throw MatrixError("vector and matrix size are different");
+    const auto &perm = _perm.vector();
+
+    // L u = P col, by forward substitution (L has a unit diagonal)
+    Vector u(n);
+    for (index_t i = 0; i < n; ++i) {
+        const Matrix::Row &mat_row = _mat[i];
+        double elem = col[perm[i]];
+        for (index_t j = 0; j < i; ++j) elem -= mat_row[j]*u[j];
+        u[i] = elem;
+    }
+    // U^T l = row, by forward substitution on the columns of U
+    Vector l = row;
+    for (index_t i = 0; i < n; ++i) {
+        const Matrix::Row &mat_row = _mat[i];
+        const double li = l[i] /= mat_row[i];
+        if (li == 0.0) continue;
+        auto slice = std::slice(i + 1, n - i - 1, 1);
+        l[slice] -= li*mat_row[slice];
+    }
+    const double pivot = diag - (l*u).sum();
+    // relative to the new row of A', as scaledPartialPivoting() scales the pivots
+    const double scale = std::max(max_abs(begin(row), end(row)), std::abs(diag));
+    if (scale == 0.0 or std::abs(pivot) < _tol*scale) return LUStatus::singularAt(n);
+
+    Matrix mat(n + 1);
+    for (index_t i = 0; i < n; ++i) {
+        mat[i][std::slice(0, n, 1)] = _mat[i];
+        mat[i][n] = u[i];
+    }
+    mat[n][std::slice(0, n, 1)] = l;
+    mat[n][n] = pivot;
+    _mat = std::move(mat);
+    _perm.extend();
+    return {};
 }
 
+LUStatus LUDecomposition::removeLast() {
+    const size_t n = _mat.size();
+    if (n == 0) throw MatrixError("no row and column to remove");
+    const auto &perm = _perm.vector();
+
+    if (perm[n - 1] == n - 1) {
+        // PA keeps the last row of A last: the leading blocks of L and U factor its leading block
+        Matrix mat(n - 1);
+        for (index_t i = 0; i + 1 < n; ++i) mat[i] = _mat[i][std::slice(0, n - 1, 1)];
+        _mat = std::move(mat);
+        _perm.shrink();
+        return {};
+    }
+
+    // A = P^-1 L U, restricted to its leading block
+    Matrix A(n - 1);
+    for (index_t i = 0; i < n; ++i) {
+        if (perm[i] == n - 1) continue;
+        const Matrix::Row &mat_row = _mat[i];
+        Matrix::Row &row = A[perm[i]];
+        for (index_t k = 0; k <= i; ++k) {
+            const double l = k == i ? 1.0 : mat_row[k];
+            if (l == 0.0) continue;
+            auto slice = std::slice(k, n - 1 - k, 1);  // row k of U, from the diagonal on
+            row[slice] += l*Matrix::Row(_mat[k][slice]);
+        }
+    }
+    return tryFactor(A, _tol);
+}
@@ -0,0 +1,68 @@
+#include "MappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "errors.h"
+
+
+MappedFile::MappedFile(const char *path) {
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) throw IOError(path);
+
+    struct stat st = {};
+    if (::fstat(fd, &st) == 0 and S_ISREG(st.st_mode) and st.st_size > 0) {
+        void *addr = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            ::madvise(addr, size_t(st.st_size), MADV_SEQUENTIAL);
+            _data = static_cast<const char *>(addr);
+            _size = size_t(st.st_size);
+            _mapped = true;
+        }
+    }
+
+    if (not _mapped) {
+        // Not mappable (empty file, pipe, ...): read it the old-fashioned way
+        char chunk[1 << 16];
+        ssize_t count;
+        while ((count = ::read(fd, chunk, sizeof chunk)) > 0) _buffer.append(chunk, size_t(count));
+        if (count < 0) {
+            ::close(fd);
+            throw IOError(path);
+        }
+        _data = _buffer.data();
+        _size = _buffer.size();
+    }
+
+    ::close(fd);  // the mapping stays valid after closing the descriptor
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+        release();
+        _mapped = other._mapped;
+        _size = other._size;
+        _buffer = std::move(other._buffer);
+        _data = _mapped ? other._data : _buffer.data();
+        other._data = nullptr;
+        other._size = 0;
+        other._mapped = false;
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    release();
+}
+
+void MappedFile::release() {
+    if (_mapped) ::munmap(const_cast<char *>(_data), _size);
+    _data = nullptr;
+    _size = 0;
+    _mapped = false;
+}
@@ -0,0 +1,45 @@
+#include "PackedMatrix.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include "errors.h"
+
+
+PackedMatrix PackedMatrix::fromDense(const Matrix &A) {
+    const size_t n = A.size();
+    PackedMatrix result(n);
+    for (index_t i = 0; i < n; ++i)
+        std::copy(begin(A[i]), begin(A[i]) + i + 1, result.row(i));
+    return result;
+}
+
+double PackedMatrix::operator()(index_t i, index_t j) const {
+    if (i >= _n or j >= _n) throw std::out_of_range("packed matrix index out of range");
+    return i >= j ? at(i, j) : at(j, i);
+}
+
+Matrix PackedMatrix::toDense() const {
+    Matrix result(_n);
+    for (index_t i = 0; i < _n; ++i) {
+        const double *r = row(i);
+        for (index_t j = 0; j <= i; ++j) result[i][j] = result[j][i] = r[j];
+    }
+    return result;
+}
+
+Vector operator*(const PackedMatrix &A, const Vector &v) {
+    const size_t n = A.size();
+    if (v.size() != n) throw MatrixError("vector and matrix size are different");
+    Vector result(0.0, n);
+    // row i of the lower triangle is both row i (left of the diagonal) and column i (above it)
+    for (index_t i = 0; i < n; ++i) {
+        const double *row = A.row(i);
+        double elem = row[i]*v[i];
+        for (index_t j = 0; j < i; ++j) {
+            elem += row[j]*v[j];
+            result[j] += row[j]*v[i];
+        }
+        result[i] += elem;
+    }
+    return result;
+}
@@ -4,6 +4,9 @@
 
 #include "Permutation.h"
 
+#include <stdexcept>
+#include <vector>
+
 
 Permutation::Permutation(size_t n) : _vec(n) {
     for (index_t i = 0; i < n; ++i) _vec[i] = i;
@@ -14,4 +17,34 @@ void Permutation::permute(index_t a, index_t b) {
         std::swap(_vec[a], _vec[b]);
         _parity = not _parity;
     }
-}
\ No newline at end of file
+}
+
+void Permutation::extend() {
+    const size_t n = _vec.size();
+    Vector vec(n + 1);
+    vec[std::slice(0, n, 1)] = _vec;
+    vec[n] = n;
+    _vec = std::move(vec);
+}
+
+void Permutation::shrink() {
+    const size_t n = _vec.size();
+    if (n == 0 or _vec[n - 1] != n - 1) throw std::invalid_argument("last element of the permutation isn't fixed");
+    _vec = Vector(_vec[std::slice(0, n - 1, 1)]);
+}
+
+
+bool permutationParity(const Permutation::Vector &perm) {
+    // each cycle of length l is l - 1 transpositions
+    std::vector<bool> seen(perm.size(), false);
+    bool parity = false;
+    for (index_t i = 0; i < perm.size(); ++i) {
+        if (seen[i]) continue;
+        for (index_t j = perm[i]; j != i; j = perm[j]) {
+            seen[j] = true;
+            parity = not parity;
+        }
+        seen[i] = true;
+    }
+    return parity;
+}
@@ -0,0 +1,121 @@
+#include "Scanner.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include "errors.h"
+
+
+void Scanner::skipSpace() {
+    while (_pos != _end and isSpace(*_pos)) ++_pos;
+}
+
+bool Scanner::atEnd() {
+    skipSpace();
+    return _pos == _end;
+}
+
+void Scanner::skipToken() {
+    skipSpace();
+    while (_pos != _end and not isSpace(*_pos)) ++_pos;
+}
+
+size_t Scanner::readIndex(const char *what) {
+    skipSpace();
+    const char *start = _pos;
+    size_t value = 0;
+    for (; _pos != _end and unsigned(*_pos - '0') < 10; ++_pos) {
+        size_t digit = size_t(*_pos - '0');
+        if (value > (std::numeric_limits<size_t>::max() - digit)/10) {
+            _pos = start;
+            throw BadFormat(what, offset());
+        }
+        value = value*10 + digit;
+    }
+    if (_pos == start or (_pos != _end and not isSpace(*_pos))) {
+        _pos = start;
+        throw BadFormat(what, offset());
+    }
+    return value;
+}
+
+
+// Powers of ten that are exactly representable as doubles
+static const double exactPowersOf10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+double Scanner::readDouble(const char *what) {
+    skipSpace();
+    const char *start = _pos;
+
+    // Fast path (Clinger): if the decimal mantissa fits in 53 bits and the decimal
+    // exponent is small, a single correctly rounded multiplication/division is exact.
+    const char *p = _pos;
+    bool negative = false;
+    if (p != _end and (*p == '-' or *p == '+')) negative = (*p++ == '-');
+
+    uint64_t mantissa = 0;
+    int digits = 0, exponent = 0;
+    bool anyDigit = false;
+    for (; p != _end and unsigned(*p - '0') < 10; ++p, anyDigit = true) {
+        if (digits < 19) {
+            mantissa = mantissa*10 + unsigned(*p - '0');
+            if (mantissa) ++digits;
+        } else ++exponent;
+    }
+    if (p != _end and *p == '.') {
+        for (++p; p != _end and unsigned(*p - '0') < 10; ++p, anyDigit = true) {
+            if (digits < 19) {
+                mantissa = mantissa*10 + unsigned(*p - '0');
+                if (mantissa) ++digits;
+                --exponent;
+            }
+        }
+    }
+    if (anyDigit and p != _end and (*p == 'e' or *p == 'E')) {
+        const char *q = p + 1;
+        bool negExp = false;
+        if (q != _end and (*q == '-' or *q == '+')) negExp = (*q++ == '-');
+        if (q != _end and unsigned(*q - '0') < 10) {
+            int e = 0;
+            for (; q != _end and unsigned(*q - '0') < 10; ++q)
+                if (e < 100000) e = e*10 + (*q - '0');
+            exponent += negExp ? -e : e;
+            p = q;
+        }
+    }
+
+    if (not anyDigit or digits >= 19 or (p != _end and not isSpace(*p)))
+        return readDoubleSlow(what);  // inf/nan, hexfloats, long mantissas, garbage...
+
+    if (mantissa >> 53 or exponent < -22 or exponent > 22) {
+        _pos = start;
+        return readDoubleSlow(what);
+    }
+
+    double value = double(mantissa);
+    value = exponent < 0 ? value/exactPowersOf10[-exponent] : value*exactPowersOf10[exponent];
+    _pos = p;
+    return negative ? -value : value;
+}
+
+double Scanner::readDoubleSlow(const char *what) {
+    skipSpace();
+    const char *tokenEnd = _pos;
+    while (tokenEnd != _end and not isSpace(*tokenEnd)) ++tokenEnd;
+
+    // strtod needs a null-terminated string, and the mapped range needn't be one
+    char buffer[128];
+    size_t length = size_t(tokenEnd - _pos);
+    if (length == 0 or length >= sizeof buffer) throw BadFormat(what, offset());
+    std::copy(_pos, tokenEnd, buffer);
+    buffer[length] = '\0';
+
+    char *parsedEnd = nullptr;
+    double value = std::strtod(buffer, &parsedEnd);
+    if (parsedEnd != buffer + length) throw BadFormat(what, offset());
+    _pos = tokenEnd;
+    return value;
+}
@@ -0,0 +1,41 @@
+#include "SchurComplement.h"
+
+#include <numeric>
+#include "errors.h"
+#include "resol.h"
+
+
+SchurComplementDecomposition::SchurComplementDecomposition(LUDecomposition &&luA, const std::vector<Vector> &B,
+                                                           std::vector<Vector> C, const Matrix &D, double tol) {
+    LUStatus status = tryFactor(std::move(luA), B, std::move(C), D, tol);
+    if (not status) throw SingularMatrixError(tol, "at pivot " + std::to_string(status.pivot));
+}
+
+LUStatus SchurComplementDecomposition::tryFactor(LUDecomposition &&luA, const std::vector<Vector> &B,
+                                                 std::vector<Vector> C, const Matrix &D, double tol) {
+    const size_t n = luA.decompMatrix().size(), m = D.size();
+    if (B.size() != m or C.size() != m) throw MatrixError("border blocks and trailing block of different sizes");
+    for (index_t k = 0; k < m; ++k)
+        if (B[k].size() != n or C[k].size() != n)
+            throw MatrixError("border blocks and leading block of different sizes");
+
+    _luA = std::move(luA);
+    _C = std::move(C);
+    _tol = tol;
+    _coupling = m > 0 ? solveLU(_luA, B) : std::vector<Vector>();
+    return setD(D);
+}
+
+LUStatus SchurComplementDecomposition::setD(const Matrix &D) {
+    const size_t m = borderSize();
+    if (D.size() != m) throw MatrixError("trailing block of a different size");
+
+    // S = D - C A^-1 B
+    Matrix S = D;
+    for (index_t i = 0; i < m; ++i)
+        for (index_t j = 0; j < m; ++j)
+            S[i][j] -= std::inner_product(begin(_C[i]), end(_C[i]), begin(_coupling[j]), 0.0);
+    LUStatus status = _luS.tryFactor(S, _tol);
+    if (not status) status.pivot += leadingSize();
+    return status;
+}
@@ -0,0 +1,98 @@
+#include "SkylineLU.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include "errors.h"
+
+
+namespace {
+
+    /// Sum of x[k]*y[k] over the stored entries of a row (starting at column xStart) and a column
+    /// (starting at row yStart) of a skyline matrix, for k up to (excluded) end
+    inline double profileDot(const double *x, index_t xStart, const double *y, index_t yStart, index_t end) {
+        const index_t first = std::max(xStart, yStart);
+        if (first >= end) return 0.0;
+        return std::inner_product(x + (first - xStart), x + (end - xStart), y + (first - yStart), 0.0);
+    }
+
+}
+
+
+//-------------------- SkylineLUDecomposition -------------------//
+
+SkylineLUDecomposition::SkylineLUDecomposition(const SkylineMatrix &A, double tol) {
+    LUStatus status = tryFactor(A, tol);
+    if (not status) throw SingularMatrixError(tol, "at pivot " + std::to_string(status.pivot));
+}
+
+LUStatus SkylineLUDecomposition::tryFactor(const SkylineMatrix &A, double tol) {
+    _LU = A.expanded();
+    _tol = tol;
+    return decompose();
+}
+
+LUStatus SkylineLUDecomposition::decompose() {
+    const size_t n = _LU.size();
+    auto &diag = _LU.diagonal();
+    double *const lower = _LU.lowerValues().data(), *const upper = _LU.upperValues().data();
+    const auto &lowerPtr = _LU.lowerPointers(), &upperPtr = _LU.upperPointers();
+
+    // Doolittle by borders: row i of L, then column i of U, then the pivot
+    for (index_t i = 0; i < n; ++i) {
+        const index_t rowStart = _LU.rowStart(i), columnStart = _LU.columnStart(i);
+        double *const row = lower + lowerPtr[i], *const column = upper + upperPtr[i];
+
+        for (index_t j = rowStart; j < i; ++j) {
+            const double dot = profileDot(row, rowStart, upper + upperPtr[j], _LU.columnStart(j), j);
+            row[j - rowStart] = (row[j - rowStart] - dot)/diag[j];
+        }
+        for (index_t j = columnStart; j < i; ++j)
+            column[j - columnStart] -= profileDot(lower + lowerPtr[j], _LU.rowStart(j), column, columnStart, j);
+        diag[i] -= profileDot(row, rowStart, column, columnStart, i);
+
+        if (std::abs(diag[i]) < _tol) return LUStatus::singularAt(i);
+    }
+
+    return {};
+}
+
+
+//-------------------- SkylineLDLTDecomposition -------------------//
+
+SkylineLDLTDecomposition::SkylineLDLTDecomposition(const SkylineMatrix &A, double tol) {
+    LUStatus status = tryFactor(A, tol);
+    if (not status) throw SingularMatrixError(tol, "at pivot " + std::to_string(status.pivot));
+}
+
+LUStatus SkylineLDLTDecomposition::tryFactor(const SkylineMatrix &A, double tol) {
+    if (not A.isSymmetric()) throw MatrixError("LDL^T decomposition needs a symmetric skyline matrix");
+    _LDL = A;
+    _tol = tol;
+    return decompose();
+}
+
+LUStatus SkylineLDLTDecomposition::decompose() {
+    const size_t n = _LDL.size();
+    auto &diag = _LDL.diagonal();
+    double *const lower = _LDL.lowerValues().data();
+    const auto &lowerPtr = _LDL.lowerPointers();
+
+    for (index_t i = 0; i < n; ++i) {
+        const index_t rowStart = _LDL.rowStart(i);
+        double *const row = lower + lowerPtr[i];
+
+        // first row i of L D (the entries left of j are needed as such), then L and D(i)
+        for (index_t j = rowStart; j < i; ++j)
+            row[j - rowStart] -= profileDot(row, rowStart, lower + lowerPtr[j], _LDL.rowStart(j), j);
+        for (index_t j = rowStart; j < i; ++j) {
+            const double ld = row[j - rowStart];
+            row[j - rowStart] = ld/diag[j];
+            diag[i] -= ld*row[j - rowStart];
+        }
+
+        if (std::abs(diag[i]) < _tol) return LUStatus::singularAt(i);
+    }
+
+    return {};
+}
@@ -0,0 +1,97 @@
+#include "SkylineMatrix.h"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include "errors.h"
+
+
+SkylineMatrix::SkylineMatrix(const std::vector<index_t> &rowStarts, const std::vector<index_t> &columnStarts,
+                             bool symmetric) : _symmetric(symmetric), _diagonal(rowStarts.size(), 0.0) {
+    const size_t n = rowStarts.size();
+    _lowerPointers.resize(n + 1);
+    for (index_t i = 0; i < n; ++i) _lowerPointers[i + 1] = _lowerPointers[i] + i - rowStarts[i];
+    _lowerValues.assign(_lowerPointers[n], 0.0);
+    if (symmetric) return;
+    _upperPointers.resize(n + 1);
+    for (index_t j = 0; j < n; ++j) _upperPointers[j + 1] = _upperPointers[j] + j - columnStarts[j];
+    _upperValues.assign(_upperPointers[n], 0.0);
+}
+
+SkylineMatrix SkylineMatrix::fromDense(const Matrix &A, bool symmetric) {
+    return fromSparse(SparseMatrix::fromDense(A), symmetric);
+}
+
+SkylineMatrix SkylineMatrix::fromSparse(const SparseMatrix &A, bool symmetric) {
+    if (symmetric) {
+        const SparseMatrix At = A.transposed();
+        if (At.pointers() != A.pointers() or At.indices() != A.indices() or At.values() != A.values())
+            throw MatrixError("matrix is not symmetric");
+    }
+
+    const size_t n = A.size();
+    const bool csr = A.layout() == SparseLayout::CSR;
+    auto forEachEntry = [&](std::function<void(index_t, index_t, double)> f) {
+        for (index_t k = 0; k < n; ++k)
+            for (index_t p = A.pointers()[k]; p < A.pointers()[k + 1]; ++p) {
+                if (csr) f(k, A.indices()[p], A.values()[p]);
+                else f(A.indices()[p], k, A.values()[p]);
+            }
+    };
+
+    // the envelope: the first entry of each row (left of the diagonal) and column (above it)
+    std::vector<index_t> rowStarts(n), columnStarts(n);
+    for (index_t i = 0; i < n; ++i) rowStarts[i] = columnStarts[i] = i;
+    forEachEntry([&](index_t i, index_t j, double) {
+        if (i > j) rowStarts[i] = std::min(rowStarts[i], j);
+        else columnStarts[j] = std::min(columnStarts[j], i);
+    });
+
+    SkylineMatrix result(rowStarts, columnStarts, symmetric);
+    forEachEntry([&](index_t i, index_t j, double value) {
+        if (not symmetric or i >= j) result.at(i, j) = value;
+    });
+    return result;
+}
+
+double SkylineMatrix::operator()(index_t i, index_t j) const {
+    if (i >= size() or j >= size()) throw std::out_of_range("skyline matrix index out of range");
+    return inProfile(i, j) ? at(i, j) : 0.0;
+}
+
+SkylineMatrix SkylineMatrix::expanded() const {
+    SkylineMatrix result = *this;
+    if (_symmetric) {
+        result._symmetric = false;
+        result._upperPointers = _lowerPointers;
+        result._upperValues = _lowerValues;
+    }
+    return result;
+}
+
+Matrix SkylineMatrix::toDense() const {
+    const size_t n = size();
+    Matrix result(n);
+    for (index_t i = 0; i < n; ++i) {
+        result[i][i] = _diagonal[i];
+        for (index_t j = rowStart(i); j < i; ++j) result[i][j] = at(i, j);
+        for (index_t k = columnStart(i); k < i; ++k) result[k][i] = at(k, i);
+    }
+    return result;
+}
+
+
+Vector operator*(const SkylineMatrix &A, const Vector &v) {
+    const size_t n = A.size();
+    if (v.size() != n) throw MatrixError("vector and matrix size are different");
+    Vector result(0.0, n);
+    for (index_t i = 0; i < n; ++i) {
+        double elem = A.diagonal()[i]*v[i];
+        for (index_t j = A.rowStart(i); j < i; ++j) elem += A.at(i, j)*v[j];
+        result[i] += elem;
+        // column i of the upper part
+        const double vi = v[i];
+        for (index_t k = A.columnStart(i); k < i; ++k) result[k] += A.at(k, i)*vi;
+    }
+    return result;
+}
@@ -0,0 +1,335 @@
+#include "SparseLU.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <utility>
+#include "errors.h"
+
+
+//---------- minimum degree ordering ----------//
+
+Permutation::Vector minimumDegreeOrdering(const SparseMatrix &A) {
+    const size_t n = A.size();
+    const SparseMatrix &B = A.layout() == SparseLayout::CSR ? A : A.converted(SparseLayout::CSR);
+
+    // adjacency lists of the graph of A + A^T (without self loops)
+    std::vector<std::vector<index_t>> adj(n);
+    const auto &pointers = B.pointers();
+    const auto &indices = B.indices();
+    for (index_t i = 0; i < n; ++i)
+        for (index_t p = pointers[i]; p < pointers[i + 1]; ++p) {
+            const index_t j = indices[p];
+            if (i == j) continue;
+            adj[i].push_back(j);
+            adj[j].push_back(i);
+        }
+    for (auto &list : adj) {
+        std::sort(list.begin(), list.end());
+        list.erase(std::unique(list.begin(), list.end()), list.end());
+    }
+
+    // nodes of very high degree would turn every elimination into a huge clique: order them last
+    const size_t denseDegree = std::max<size_t>(16, size_t(10*std::sqrt(double(n))));
+    std::vector<bool> done(n, false);
+    std::vector<index_t> dense;
+    for (index_t i = 0; i < n; ++i)
+        if (adj[i].size() > denseDegree) {
+            done[i] = true;
+            dense.push_back(i);
+        }
+    auto isDone = [&done](index_t j) { return done[j]; };
+    for (auto &list : adj)
+        list.erase(std::remove_if(list.begin(), list.end(), isDone), list.end());
+
+    // minimum degree on the elimination graph, ties broken by index (stale heap entries are skipped)
+    typedef std::pair<size_t, index_t> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+    for (index_t i = 0; i < n; ++i)
+        if (not done[i]) heap.emplace(adj[i].size(), i);
+
+    Permutation::Vector order(n);
+    index_t k = 0;
+    std::vector<index_t> merged;
+    while (not heap.empty()) {
+        const Entry top = heap.top();
+        heap.pop();
+        const index_t p = top.second;
+        if (done[p] or top.first != adj[p].size()) continue;
+
+        order[k++] = p;
+        done[p] = true;
+        // eliminating p makes its neighbours a clique
+        const std::vector<index_t> neighbours = std::move(adj[p]);
+        adj[p] = {};
+        for (index_t u : neighbours) {
+            merged.clear();
+            std::set_union(adj[u].begin(), adj[u].end(), neighbours.begin(), neighbours.end(),
+                           std::back_inserter(merged));
+            merged.erase(std::remove_if(merged.begin(), merged.end(),
+                                        [&](index_t j) { return j == u or done[j]; }),
+                         merged.end());
+            adj[u].swap(merged);
+            heap.emplace(adj[u].size(), u);
+        }
+    }
+    for (index_t i : dense) order[k++] = i;
+
+    return order;
+}
+
+
+//---------- SparseLUDecomposition ----------//
+
+SparseLUDecomposition::SparseLUDecomposition(const SparseMatrix &A, double tol, double threshold) {
+    LUStatus status = tryFactor(A, tol, threshold);
+    if (not status) throw SingularMatrixError(tol, "at pivot " + std::to_string(status.pivot));
+}
+
+namespace {
+    const index_t NONE = index_t(-1);
+
+    /// Growing compressed columns
+    struct ColumnBuilder {
+        std::vector<index_t> pointers = {0};
+        std::vector<index_t> indices;
+        std::vector<double> values;
+
+        void push(index_t i, double value) {
+            indices.push_back(i);
+            values.push_back(value);
+        }
+
+        void endColumn() { pointers.push_back(indices.size()); }
+
+        // Renumber the indices through `map`, sort every column and compress it
+        SparseMatrix finish(size_t n, const std::vector<index_t> &map) {
+            std::vector<std::pair<index_t, double>> column;
+            for (index_t k = 0; k < n; ++k) {
+                column.clear();
+                for (index_t p = pointers[k]; p < pointers[k + 1]; ++p)
+                    column.emplace_back(map.empty() ? indices[p] : map[indices[p]], values[p]);
+                std::sort(column.begin(), column.end(),
+                          [](const std::pair<index_t, double> &a, const std::pair<index_t, double> &b) {
+                              return a.first < b.first;
+                          });
+                for (index_t p = pointers[k]; p < pointers[k + 1]; ++p) {
+                    indices[p] = column[p - pointers[k]].first;
+                    values[p] = column[p - pointers[k]].second;
+                }
+            }
+            return SparseMatrix(n, SparseLayout::CSC, std::move(pointers), std::move(indices), std::move(values));
+        }
+    };
+
+    /**
+     * Non-zero pattern of the solution of L x = b, where L holds the columns computed so far
+     * (with rows in the original numbering) and `pivotOf` maps a pivotal row to its column of L.
+     * The pattern is written to xi[top, n) in topological order and top is returned.
+     */
+    index_t reach(const ColumnBuilder &L, const std::vector<index_t> &pivotOf,
+                  const SparseMatrix &A, index_t col, std::vector<index_t> &xi,
+                  std::vector<index_t> &stack, std::vector<index_t> &next,
+                  std::vector<size_t> &mark, size_t stamp) {
+        const size_t n = A.size();
+        index_t top = n;
+        for (index_t p = A.pointers()[col]; p < A.pointers()[col + 1]; ++p) {
+            const index_t start = A.indices()[p];
+            if (mark[start] == stamp) continue;
+
+            // iterative depth-first search from `start`
+            index_t head = 0;
+            stack[0] = start;
+            mark[start] = stamp;
+            next[0] = pivotOf[start] == NONE ? NONE : L.pointers[pivotOf[start]];
+            while (true) {
+                const index_t j = stack[head];
+                const index_t J = pivotOf[j];
+                bool descended = false;
+                if (J != NONE) {
+                    for (index_t &q = next[head]; q < L.pointers[J + 1]; ++q) {
+                        const index_t i = L.indices[q];
+                        if (mark[i] == stamp) continue;
+                        mark[i] = stamp;
+                        ++q;
+                        stack[++head] = i;
+                        next[head] = pivotOf[i] == NONE ? NONE : L.pointers[pivotOf[i]];
+                        descended = true;
+                        break;
+                    }
+                }
+                if (descended) continue;
+                xi[--top] = j;  // all children done: j goes before them in topological order
+                if (head == 0) break;
+                --head;
+            }
+        }
+        return top;
+    }
+}
+
+LUStatus SparseLUDecomposition::tryFactor(const SparseMatrix &A, double tol, double threshold) {
+    _tol = tol;
+    _threshold = threshold;
+
+    // symbolic analysis: pattern of A by columns, where its values go, and the column ordering
+    if (A.layout() == SparseLayout::CSC) {
+        _A = A;
+        _valuePosition.clear();
+    } else {
+        // tag every entry with its position in A.values() to find where it lands
+        SparseMatrix positions = A;
+        for (index_t p = 0; p < positions.nnz(); ++p) positions.values()[p] = double(p);
+        _A = positions.converted(SparseLayout::CSC);
+        _valuePosition.assign(_A.values().begin(), _A.values().end());
+        for (index_t p = 0; p < _A.nnz(); ++p) _A.values()[p] = A.values()[_valuePosition[p]];
+    }
+    _colPerm = minimumDegreeOrdering(_A);
+
+    return factor();
+}
+
+LUStatus SparseLUDecomposition::factor() {
+    const SparseMatrix &A = _A;
+    const size_t n = A.size();
+    const double tol = _tol, threshold = _threshold;
+    _reusedPivots = false;
+    _factored = false;
+
+    ColumnBuilder L, U;
+    const size_t expected = 4*A.nnz() + n;
+    L.indices.reserve(expected);
+    L.values.reserve(expected);
+    U.indices.reserve(expected);
+    U.values.reserve(expected);
+
+    std::vector<index_t> pivotOf(n, NONE);  // pivot position of each row of A (NONE if not pivotal yet)
+    std::vector<double> x(n, 0.0);
+    std::vector<index_t> xi(n), stack(n), next(n);
+    std::vector<size_t> mark(n, 0);
+
+    for (index_t k = 0; k < n; ++k) {
+        const index_t col = _colPerm[k];
+
+        // x = L \ A(:, col) on the pattern xi[top, n)
+        const index_t top = reach(L, pivotOf, A, col, xi, stack, next, mark, k + 1);
+        for (index_t p = A.pointers()[col]; p < A.pointers()[col + 1]; ++p) x[A.indices()[p]] = A.values()[p];
+        for (index_t px = top; px < n; ++px) {
+            const index_t j = xi[px];
+            const index_t J = pivotOf[j];
+            if (J == NONE) continue;
+            const double xj = x[j];
+            for (index_t p = L.pointers[J] + 1; p < L.pointers[J + 1]; ++p)  // skip the unit diagonal
+                x[L.indices[p]] -= L.values[p]*xj;
+        }
+
+        // entries in pivotal rows go to U; the largest of the others is the candidate pivot
+        index_t pivotRow = NONE;
+        double largest = -1.0;
+        for (index_t px = top; px < n; ++px) {
+            const index_t i = xi[px];
+            if (pivotOf[i] == NONE) {
+                if (std::abs(x[i]) > largest) {
+                    largest = std::abs(x[i]);
+                    pivotRow = i;
+                }
+            } else {
+                U.push(pivotOf[i], x[i]);
+                x[i] = 0.0;
+            }
+        }
+        if (pivotRow == NONE or largest < tol) {
+            for (index_t px = top; px < n; ++px) x[xi[px]] = 0.0;
+            return LUStatus::singularAt(k);
+        }
+        // keep the diagonal if it's large enough
+        if (pivotOf[col] == NONE and mark[col] == k + 1 and std::abs(x[col]) >= threshold*largest)
+            pivotRow = col;
+
+        const double pivot = x[pivotRow];
+        U.push(k, pivot);
+        U.endColumn();
+        pivotOf[pivotRow] = k;
+        L.push(pivotRow, 1.0);
+        for (index_t px = top; px < n; ++px) {
+            const index_t i = xi[px];
+            if (pivotOf[i] == NONE) L.push(i, x[i]/pivot);
+            x[i] = 0.0;
+        }
+        L.endColumn();
+    }
+
+    _rowPerm.resize(n);
+    for (index_t i = 0; i < n; ++i) _rowPerm[pivotOf[i]] = i;
+    _pivotOf = std::move(pivotOf);
+    _L = L.finish(n, _pivotOf);
+    _U = U.finish(n, {});
+    _factored = true;
+    return {};
+}
+
+LUStatus SparseLUDecomposition::refactor(const SparseMatrix &A, double threshold) {
+    const SparseMatrix &B = A.layout() == SparseLayout::CSC ? A : A.converted(SparseLayout::CSC);
+    if (B.size() != _A.size() or B.pointers() != _A.pointers() or B.indices() != _A.indices())
+        throw std::invalid_argument("refactor needs a matrix with the same pattern as the analysed one");
+    _A.values() = B.values();
+    return refactor(threshold);
+}
+
+LUStatus SparseLUDecomposition::refactor(const std::vector<double> &values, double threshold) {
+    if (values.size() != _A.nnz())
+        throw std::invalid_argument("refactor needs as many values as the analysed matrix has entries");
+    if (_valuePosition.empty()) _A.values() = values;
+    else for (index_t p = 0; p < _A.nnz(); ++p) _A.values()[p] = values[_valuePosition[p]];
+    return refactor(threshold);
+}
+
+LUStatus SparseLUDecomposition::refactor(double threshold) {
+    // left-looking numeric factorization on the known patterns of L and U, with rows
+    // numbered by pivot position (the triangular solve needs no search: U's rows are sorted)
+    if (not _factored) return factor();  // no pivot sequence to reuse
+    const size_t n = _A.size();
+    const auto &Ap = _A.pointers(), &Ai = _A.indices();
+    const auto &Av = _A.values();
+    const auto &Lp = _L.pointers(), &Li = _L.indices();
+    const auto &Up = _U.pointers(), &Ui = _U.indices();
+    auto &Lv = _L.values(), &Uv = _U.values();
+
+    std::vector<double> x(n, 0.0);
+    for (index_t k = 0; k < n; ++k) {
+        const index_t col = _colPerm[k];
+        for (index_t p = Ap[col]; p < Ap[col + 1]; ++p) x[_pivotOf[Ai[p]]] = Av[p];
+
+        const index_t diag = Up[k + 1] - 1;
+        for (index_t p = Up[k]; p < diag; ++p) {
+            const index_t j = Ui[p];
+            const double xj = Uv[p] = x[j];
+            x[j] = 0.0;
+            for (index_t q = Lp[j] + 1; q < Lp[j + 1]; ++q) x[Li[q]] -= Lv[q]*xj;
+        }
+
+        // the static pivot must not have become small with respect to the entries below it
+        const double pivot = x[k];
+        x[k] = 0.0;
+        double largest = std::abs(pivot);
+        for (index_t q = Lp[k] + 1; q < Lp[k + 1]; ++q) largest = std::max(largest, std::abs(x[Li[q]]));
+        if (std::abs(pivot) < _tol or std::abs(pivot) < threshold*largest) {
+            for (index_t q = Lp[k] + 1; q < Lp[k + 1]; ++q) x[Li[q]] = 0.0;
+            return factor();  // a pivot degraded: pivot again (keeping the column ordering)
+        }
+
+        Uv[diag] = pivot;
+        for (index_t q = Lp[k] + 1; q < Lp[k + 1]; ++q) {
+            Lv[q] = x[Li[q]]/pivot;
+            x[Li[q]] = 0.0;
+        }
+    }
+
+    _reusedPivots = true;
+    return {};
+}
+
+bool SparseLUDecomposition::parity() const {
+    return permutationParity(_rowPerm) != permutationParity(_colPerm);
+}
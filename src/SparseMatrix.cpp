@@ -0,0 +1,243 @@
+#include "SparseMatrix.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include "errors.h"
+
+
+//-------------------- BasicSparseMatrix -------------------//
+
+template<typename Index>
+BasicSparseMatrix<Index>::BasicSparseMatrix(size_t n, SparseLayout layout)
+        : _n(n), _layout(layout), _pointers(n + 1, 0) {}
+
+template<typename Index>
+BasicSparseMatrix<Index>::BasicSparseMatrix(size_t n, SparseLayout layout, std::vector<Index> &&pointers,
+                                            std::vector<Index> &&indices, std::vector<double> &&values)
+        : _n(n), _layout(layout), _pointers(std::move(pointers)),
+          _indices(std::move(indices)), _values(std::move(values)) {
+    if (_pointers.size() != n + 1 or _pointers.front() != 0 or _pointers.back() != _indices.size()
+        or _indices.size() != _values.size())
+        throw MatrixError("inconsistent compressed sparse matrix data");
+    for (index_t k = 0; k < n; ++k) {
+        if (_pointers[k] > _pointers[k + 1])
+            throw MatrixError("inconsistent compressed sparse matrix data");
+        for (index_t p = _pointers[k]; p < _pointers[k + 1]; ++p)
+            if (_indices[p] >= n or (p > _pointers[k] and _indices[p] <= _indices[p - 1]))
+                throw MatrixError("unsorted or out of range sparse matrix indices");
+    }
+}
+
+template<typename Index>
+BasicSparseMatrix<Index> BasicSparseMatrix<Index>::fromDense(const Matrix &A, SparseLayout layout) {
+    const size_t n = A.size();
+    BasicSparseMatrix result(n, SparseLayout::CSR);
+    for (index_t i = 0; i < n; ++i) {
+        for (index_t j = 0; j < n; ++j) {
+            if (A[i][j] == 0.0) continue;
+            result._indices.push_back(Index(j));
+            result._values.push_back(A[i][j]);
+        }
+        result._pointers[i + 1] = Index(result._indices.size());
+    }
+    return result.converted(layout);
+}
+
+template<typename Index>
+double BasicSparseMatrix<Index>::operator()(index_t i, index_t j) const {
+    if (i >= _n or j >= _n) throw std::out_of_range("matrix subscript out of range");
+    if (_layout == SparseLayout::CSC) std::swap(i, j);
+
+    auto first = _indices.begin() + _pointers[i], last = _indices.begin() + _pointers[i + 1];
+    auto it = std::lower_bound(first, last, Index(j));
+    return (it != last and *it == j) ? _values[it - _indices.begin()] : 0.0;
+}
+
+template<typename Index>
+BasicSparseMatrix<Index> BasicSparseMatrix<Index>::swapped() const {
+    // counting sort by the minor index; scanning by major index keeps the new minor indices sorted
+    BasicSparseMatrix result(_n, _layout);
+    auto &pointers = result._pointers;
+    for (Index idx : _indices) ++pointers[idx + 1];
+    for (index_t k = 0; k < _n; ++k) pointers[k + 1] += pointers[k];
+
+    result._indices.resize(nnz());
+    result._values.resize(nnz());
+    std::vector<Index> next(pointers.begin(), pointers.end() - 1);
+    for (index_t k = 0; k < _n; ++k)
+        for (index_t p = _pointers[k]; p < _pointers[k + 1]; ++p) {
+            Index q = next[_indices[p]]++;
+            result._indices[q] = Index(k);
+            result._values[q] = _values[p];
+        }
+    return result;
+}
+
+template<typename Index>
+BasicSparseMatrix<Index> BasicSparseMatrix<Index>::converted(SparseLayout layout) const {
+    if (layout == _layout) return *this;
+    BasicSparseMatrix result = swapped();
+    result._layout = layout;
+    return result;
+}
+
+template<typename Index>
+BasicSparseMatrix<Index> BasicSparseMatrix<Index>::transposed() const {
+    return swapped();
+}
+
+template<typename Index>
+Matrix BasicSparseMatrix<Index>::toDense() const {
+    Matrix A(_n);
+    for (index_t k = 0; k < _n; ++k)
+        for (index_t p = _pointers[k]; p < _pointers[k + 1]; ++p) {
+            if (_layout == SparseLayout::CSR) A[k][_indices[p]] = _values[p];
+            else A[_indices[p]][k] = _values[p];
+        }
+    return A;
+}
+
+template class BasicSparseMatrix<index_t>;
+template class BasicSparseMatrix<std::uint32_t>;
+
+
+//-------------------- TripletBuilder -------------------//
+
+void TripletBuilder::add(index_t i, index_t j, double value) {
+    if (i >= _n or j >= _n) throw std::out_of_range("matrix subscript out of range");
+    _rows.push_back(i);
+    _cols.push_back(j);
+    _values.push_back(value);
+}
+
+void TripletBuilder::reserve(size_t m) {
+    _rows.reserve(m);
+    _cols.reserve(m);
+    _values.reserve(m);
+}
+
+template<typename Index>
+BasicSparseMatrix<Index> TripletBuilder::build(SparseLayout layout) const {
+    const size_t m = _values.size();
+    if (m > std::numeric_limits<Index>::max() or _n > std::numeric_limits<Index>::max())
+        throw std::overflow_error("too many sparse matrix entries for the index type");
+
+    // stable counting sort by row (entries of each row stay in insertion order)
+    std::vector<size_t> rowStart(_n + 1, 0);
+    for (index_t i : _rows) ++rowStart[i + 1];
+    for (index_t i = 0; i < _n; ++i) rowStart[i + 1] += rowStart[i];
+    std::vector<size_t> order(m);
+    {
+        std::vector<size_t> next(rowStart.begin(), rowStart.end() - 1);
+        for (index_t k = 0; k < m; ++k) order[next[_rows[k]]++] = k;
+    }
+
+    // merge repeated columns in every row (the last entry wins), then sort the row
+    std::vector<Index> pointers(_n + 1, 0), indices;
+    std::vector<double> values;
+    indices.reserve(m);
+    values.reserve(m);
+    std::vector<size_t> position(_n, SIZE_MAX);  // position of column j in the current row
+    std::vector<std::pair<Index, double>> row;
+    for (index_t i = 0; i < _n; ++i) {
+        row.clear();
+        for (index_t k = rowStart[i]; k < rowStart[i + 1]; ++k) {
+            const index_t entry = order[k], j = _cols[entry];
+            if (position[j] == SIZE_MAX) {
+                position[j] = row.size();
+                row.emplace_back(Index(j), _values[entry]);
+            } else row[position[j]].second = _values[entry];
+        }
+        std::sort(row.begin(), row.end(),
+                  [](const std::pair<Index, double> &a, const std::pair<Index, double> &b) {
+                      return a.first < b.first;
+                  });
+        for (const auto &entry : row) {
+            position[entry.first] = SIZE_MAX;
+            if (entry.second == 0.0) continue;
+            indices.push_back(entry.first);
+            values.push_back(entry.second);
+        }
+        pointers[i + 1] = Index(indices.size());
+    }
+
+    BasicSparseMatrix<Index> A(_n, SparseLayout::CSR, std::move(pointers), std::move(indices), std::move(values));
+    return A.converted(layout);
+}
+
+template SparseMatrix TripletBuilder::build<index_t>(SparseLayout) const;
+template SparseMatrix32 TripletBuilder::build<std::uint32_t>(SparseLayout) const;
+
+
+//-------------------- Sparse matrix operations -------------------//
+
+template<typename Index>
+Vector operator*(const BasicSparseMatrix<Index> &A, const Vector &v) {
+    const size_t n = A.size();
+    if (n != v.size())
+        throw MatrixError("matrix-vector multiplication dimension mismatch");
+    const auto &pointers = A.pointers();
+    const auto &indices = A.indices();
+    const auto &values = A.values();
+
+    Vector result(0.0, n);
+    if (A.layout() == SparseLayout::CSR) {
+        for (index_t i = 0; i < n; ++i) {
+            double elem = 0.0;
+            for (index_t p = pointers[i]; p < pointers[i + 1]; ++p) elem += values[p]*v[indices[p]];
+            result[i] = elem;
+        }
+    } else {
+        for (index_t j = 0; j < n; ++j) {
+            const double vj = v[j];
+            for (index_t p = pointers[j]; p < pointers[j + 1]; ++p) result[indices[p]] += values[p]*vj;
+        }
+    }
+    return result;
+}
+
+namespace {
+    // Max absolute sum of the rows (columns) of A if `major` is true (false) for its layout
+    template<typename Index>
+    double maxAbsSum(const BasicSparseMatrix<Index> &A, bool major) {
+        const size_t n = A.size();
+        const auto &pointers = A.pointers();
+        const auto &indices = A.indices();
+        const auto &values = A.values();
+
+        if (major) {
+            double maxSum = 0.0;
+            for (index_t k = 0; k < n; ++k) {
+                double sum = 0.0;
+                for (index_t p = pointers[k]; p < pointers[k + 1]; ++p) sum += std::abs(values[p]);
+                maxSum = std::max(maxSum, sum);
+            }
+            return maxSum;
+        }
+
+        Vector sums(0.0, n);
+        for (index_t p = 0; p < A.nnz(); ++p) sums[indices[p]] += std::abs(values[p]);
+        return n > 0 ? sums.max() : 0.0;
+    }
+}
+
+template<typename Index>
+double norm1(const BasicSparseMatrix<Index> &A) {
+    // Max column absolute sum
+    return maxAbsSum(A, A.layout() == SparseLayout::CSC);
+}
+
+template<typename Index>
+double normInf(const BasicSparseMatrix<Index> &A) {
+    // Max row absolute sum
+    return maxAbsSum(A, A.layout() == SparseLayout::CSR);
+}
+
+template Vector operator*(const SparseMatrix &, const Vector &);
+template Vector operator*(const SparseMatrix32 &, const Vector &);
+template double norm1(const SparseMatrix &);
+template double norm1(const SparseMatrix32 &);
+template double normInf(const SparseMatrix &);
+template double normInf(const SparseMatrix32 &);
@@ -0,0 +1,110 @@
+#include "ThreadPool.h"
+
+#include <atomic>
+
+
+ThreadPool::ThreadPool(unsigned nThreads) {
+    _workers.reserve(nThreads);
+    for (unsigned k = 0; k < nThreads; ++k)
+        _workers.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _cv.notify_all();
+    for (auto &worker : _workers) worker.join();
+}
+
+void ThreadPool::post(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _tasks.push_back(std::move(task));
+    }
+    _cv.notify_one();
+}
+
+void ThreadPool::workerLoop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cv.wait(lock, [this] { return _stop or not _tasks.empty(); });
+            if (_tasks.empty()) return;  // stopping and nothing left to do
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+        }
+        task();
+    }
+}
+
+
+static bool sharedPoolConfigured = false;
+static unsigned sharedPoolSize = 0;
+
+ThreadPool &ThreadPool::shared() {
+    static ThreadPool pool(sharedPoolConfigured ? sharedPoolSize : hardwareConcurrency());
+    return pool;
+}
+
+void ThreadPool::configureShared(unsigned nThreads) {
+    sharedPoolConfigured = true;
+    sharedPoolSize = nThreads;
+}
+
+unsigned ThreadPool::hardwareConcurrency() {
+    unsigned count = std::thread::hardware_concurrency();
+    return count ? count : 1;
+}
+
+
+//---------- parallelFor ----------//
+
+namespace {
+    // State shared between the caller and its helper tasks. Helpers may start after
+    // the caller returned, hence the shared ownership; they then find no work left.
+    struct ParallelForState {
+        std::function<void(index_t)> f;
+        size_t n;
+        std::atomic<size_t> next{0};
+        size_t done = 0;
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable cv;
+
+        void work() {
+            for (index_t i; (i = next++) < n;) {
+                std::exception_ptr caught;
+                try { f(i); }
+                catch (...) { caught = std::current_exception(); }
+
+                std::lock_guard<std::mutex> lock(mutex);
+                if (caught and not error) error = caught;
+                if (++done == n) cv.notify_all();
+            }
+        }
+    };
+}
+
+void parallelFor(ThreadPool &pool, size_t n, const std::function<void(index_t)> &f) {
+    if (n == 0) return;
+    if (n == 1 or pool.size() == 0) {
+        for (index_t i = 0; i < n; ++i) f(i);
+        return;
+    }
+
+    auto state = std::make_shared<ParallelForState>();
+    state->f = f;
+    state->n = n;
+
+    const size_t helpers = std::min<size_t>(pool.size(), n - 1);
+    for (index_t k = 0; k < helpers; ++k)
+        pool.post([state]() { state->work(); });
+    state->work();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->cv.wait(lock, [&state] { return state->done == state->n; });
+    if (state->error) std::rethrow_exception(state->error);
+}
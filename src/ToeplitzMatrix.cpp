@@ -0,0 +1,126 @@
+#include "ToeplitzMatrix.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <vector>
+#include "errors.h"
+
+
+namespace {
+    typedef std::vector<std::complex<double>> ComplexVector;
+
+    /// In-place iterative radix-2 FFT (the inverse one unscaled), a.size() being a power of 2
+    void fourierTransform(ComplexVector &a, bool inverse) {
+        const size_t n = a.size();
+        // bit-reversal permutation
+        for (index_t i = 1, j = 0; i < n; ++i) {
+            size_t bit = n >> 1u;
+            for (; j & bit; bit >>= 1u) j ^= bit;
+            j ^= bit;
+            if (i < j) std::swap(a[i], a[j]);
+        }
+        const double pi = std::acos(-1.0);
+        for (size_t length = 2; length <= n; length <<= 1u) {
+            const double angle = 2*pi/double(length)*(inverse ? 1 : -1);
+            const std::complex<double> root(std::cos(angle), std::sin(angle));
+            for (index_t start = 0; start < n; start += length) {
+                std::complex<double> w(1.0);
+                for (index_t k = 0; k < length/2; ++k) {
+                    const std::complex<double> u = a[start + k], v = a[start + k + length/2]*w;
+                    a[start + k] = u + v;
+                    a[start + k + length/2] = u - v;
+                    w *= root;
+                }
+            }
+        }
+    }
+}
+
+
+//-------------------- ToeplitzMatrix -------------------//
+
+ToeplitzMatrix::ToeplitzMatrix(Vector column, Vector row) : _column(std::move(column)), _row(std::move(row)) {
+    if (_column.size() != _row.size()) throw MatrixError("Toeplitz matrix first row and column of different sizes");
+    if (_column.size() > 0 and _column[0] != _row[0])
+        throw MatrixError("Toeplitz matrix first row and column with different first entries");
+}
+
+ToeplitzMatrix ToeplitzMatrix::fromDense(const Matrix &A) {
+    const size_t n = A.size();
+    Vector column(n), row(n);
+    for (index_t k = 0; k < n; ++k) {
+        column[k] = A[k][0];
+        row[k] = A[0][k];
+    }
+    for (index_t i = 1; i < n; ++i)
+        for (index_t j = 1; j < n; ++j)
+            if (A[i][j] != A[i - 1][j - 1]) throw MatrixError("matrix is not Toeplitz");
+    return ToeplitzMatrix(std::move(column), std::move(row));
+}
+
+double ToeplitzMatrix::operator()(index_t i, index_t j) const {
+    if (i >= size() or j >= size()) throw std::out_of_range("Toeplitz matrix index out of range");
+    return i >= j ? _column[i - j] : _row[j - i];
+}
+
+ToeplitzMatrix ToeplitzMatrix::transposed() const {
+    return ToeplitzMatrix(_row, _column);
+}
+
+Matrix ToeplitzMatrix::toDense() const {
+    const size_t n = size();
+    Matrix result(n);
+    for (index_t i = 0; i < n; ++i)
+        for (index_t j = 0; j < n; ++j) result[i][j] = i >= j ? _column[i - j] : _row[j - i];
+    return result;
+}
+
+
+Vector operator*(const ToeplitzMatrix &A, const Vector &v) {
+    const size_t n = A.size();
+    if (v.size() != n) throw MatrixError("vector and matrix size are different");
+    if (n < TOEPLITZ_FFT_MIN_SIZE) {
+        Vector result(n);
+        for (index_t i = 0; i < n; ++i) {
+            double elem = 0.0;
+            for (index_t j = 0; j < n; ++j) elem += (i >= j ? A.column()[i - j] : A.row()[j - i])*v[j];
+            result[i] = elem;
+        }
+        return result;
+    }
+
+    // (Av)_i = (s * v)_(i + n - 1), s = (t_-(n-1), ..., t_0, ..., t_(n-1))
+    Vector s(2*n - 1);
+    for (index_t m = 0; m < 2*n - 1; ++m) s[m] = A.diagonal(long(m) - long(n - 1));
+    const Vector product = convolution(s, v, 2*n - 1, true);
+    return product[std::slice(n - 1, n, 1)];
+}
+
+Vector convolution(const Vector &a, const Vector &b, size_t length, bool fft) {
+    Vector result(0.0, length);
+    if (a.size() == 0 or b.size() == 0) return result;
+
+    if (not fft) {
+        for (index_t k = 0; k < length; ++k) {
+            const index_t first = k >= b.size() ? k - (b.size() - 1) : 0, last = std::min(k + 1, a.size());
+            double elem = 0.0;
+            for (index_t j = first; j < last; ++j) elem += a[j]*b[k - j];
+            result[k] = elem;
+        }
+        return result;
+    }
+
+    size_t m = 1;
+    while (m < a.size() + b.size() - 1) m <<= 1u;
+    ComplexVector fa(m), fb(m);
+    std::copy(begin(a), end(a), fa.begin());
+    std::copy(begin(b), end(b), fb.begin());
+    fourierTransform(fa, false);
+    fourierTransform(fb, false);
+    for (index_t k = 0; k < m; ++k) fa[k] *= fb[k];
+    fourierTransform(fa, true);
+    for (index_t k = 0; k < std::min(length, m); ++k) result[k] = fa[k].real()/double(m);
+    return result;
+}
@@ -0,0 +1,60 @@
+#include "ToeplitzSolver.h"
+
+#include <cmath>
+#include "errors.h"
+
+
+ToeplitzDecomposition::ToeplitzDecomposition(const ToeplitzMatrix &T, double tol, size_t fftMinSize) {
+    LUStatus status = tryFactor(T, tol, fftMinSize);
+    if (not status) throw SingularMatrixError(tol, "at pivot " + std::to_string(status.pivot));
+}
+
+LUStatus ToeplitzDecomposition::tryFactor(const ToeplitzMatrix &T, double tol, size_t fftMinSize) {
+    _n = T.size();
+    _tol = tol;
+    _fftMinSize = fftMinSize;
+    _fallback = not levinson(T);
+    if (not _fallback) {
+        _lu = LUDecomposition();
+        return {};
+    }
+    _x = _y = Vector();
+    return _lu.tryFactor(T.toDense(), tol);
+}
+
+bool ToeplitzDecomposition::levinson(const ToeplitzMatrix &T) {
+    const size_t n = _n;
+    if (n == 0) return true;
+    double scale = 0.0;
+    for (index_t k = 0; k < n; ++k) scale = std::max({scale, std::abs(T.column()[k]), std::abs(T.row()[k])});
+    if (std::abs(T.column()[0]) < LEVINSON_MIN_PIVOT*scale) return false;
+
+    // f and b solve T_k f = e_0 and T_k b = e_(k-1) for the leading k by k submatrix T_k
+    Vector f(0.0, n), b(0.0, n), previous(n);
+    f[0] = b[0] = 1.0/T.column()[0];
+    for (index_t k = 1; k < n; ++k) {
+        // T_(k+1) (f, 0) = e_0 + ef e_k and T_(k+1) (0, b) = eb e_0 + e_k
+        double ef = 0.0, eb = 0.0;
+        for (index_t j = 0; j < k; ++j) {
+            ef += T.column()[k - j]*f[j];
+            eb += T.row()[j + 1]*b[j];
+        }
+        const double pivot = 1.0 - ef*eb;
+        if (std::abs(pivot) < LEVINSON_MIN_PIVOT) return false;
+
+        // f <- ((f, 0) - ef (0, b))/pivot, b <- ((0, b) - eb (f, 0))/pivot
+        previous = f;
+        for (index_t j = 0; j <= k; ++j) {
+            const double shifted = j > 0 ? b[j - 1] : 0.0;
+            f[j] = (previous[j] - ef*shifted)/pivot;
+        }
+        for (long j = k; j >= 0; --j) {
+            const double shifted = j > 0 ? b[j - 1] : 0.0;
+            b[j] = (shifted - eb*previous[j])/pivot;
+        }
+    }
+
+    _x = std::move(f);
+    _y = std::move(b);
+    return true;
+}
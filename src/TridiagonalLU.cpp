@@ -0,0 +1,186 @@
+#include "TridiagonalLU.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+#include "errors.h"
+#include "resol.h"
+#include "ThreadPool.h"
+
+
+//-------------------- TridiagonalLUDecomposition -------------------//
+
+TridiagonalLUDecomposition::TridiagonalLUDecomposition(const TridiagonalMatrix &A, double tol) {
+    LUStatus status = tryFactor(A, tol);
+    if (not status) throw SingularMatrixError(tol, "at pivot " + std::to_string(status.pivot));
+}
+
+LUStatus TridiagonalLUDecomposition::tryFactor(const TridiagonalMatrix &A, double tol) {
+    _dl = A.lower();
+    _d = A.diagonal();
+    _du = A.upper();
+    _du2.assign(_d.size() > 1 ? _d.size() - 2 : 0, 0.0);
+    _swapped.assign(_d.size(), false);
+    _tol = tol;
+    return decompose();
+}
+
+LUStatus TridiagonalLUDecomposition::decompose() {
+    const size_t n = size();
+
+    for (index_t i = 0; i + 1 < n; ++i) {
+        if (std::max(std::abs(_d[i]), std::abs(_dl[i])) < _tol) return LUStatus::singularAt(i);
+        if (std::abs(_d[i]) >= std::abs(_dl[i])) {
+            // no interchange
+            const double multiplier = _dl[i] /= _d[i];
+            _d[i + 1] -= multiplier*_du[i];
+        } else {
+            // swap rows i and i + 1: the second super-diagonal fills in
+            _swapped[i] = true;
+            const double multiplier = _d[i]/_dl[i];
+            _d[i] = _dl[i];
+            _dl[i] = multiplier;
+            const double upper = _du[i];
+            _du[i] = _d[i + 1];
+            _d[i + 1] = upper - multiplier*_d[i + 1];
+            if (i + 2 < n) {
+                _du2[i] = _du[i + 1];
+                _du[i + 1] *= -multiplier;
+            }
+        }
+    }
+    if (n > 0 and std::abs(_d[n - 1]) < _tol) return LUStatus::singularAt(n - 1);
+
+    return {};
+}
+
+Permutation::Vector TridiagonalLUDecomposition::perm() const {
+    Permutation::Vector perm(size());
+    for (index_t i = 0; i < size(); ++i) perm[i] = i;
+    for (index_t i = 0; i + 1 < size(); ++i)
+        if (_swapped[i]) std::swap(perm[i], perm[i + 1]);
+    return perm;
+}
+
+bool TridiagonalLUDecomposition::parity() const {
+    bool parity = false;
+    for (char swapped : _swapped) parity ^= swapped != 0;
+    return parity;
+}
+
+
+//-------------------- BlockTridiagonalLUDecomposition -------------------//
+
+BlockTridiagonalLUDecomposition::BlockTridiagonalLUDecomposition(const BlockTridiagonalMatrix &A, double tol) {
+    LUStatus status = tryFactor(A, tol);
+    if (not status) throw SingularMatrixError(tol, "at pivot " + std::to_string(status.pivot));
+}
+
+LUStatus BlockTridiagonalLUDecomposition::tryFactor(const BlockTridiagonalMatrix &A, double tol) {
+    const size_t blocks = A.blockCount(), m = A.blockSize();
+    _blockSize = m;
+    _tol = tol;
+    _pivotBlocks.assign(blocks, LUDecomposition());
+    _lower.assign(blocks > 0 ? blocks - 1 : 0, Matrix());
+    _coupling.assign(blocks > 0 ? blocks - 1 : 0, Matrix());
+
+    for (index_t k = 0; k < blocks; ++k) {
+        // D_k - L_(k-1) X_(k-1), L_(k-1) being block (k, k - 1)
+        Matrix pivot = A.diagonal(k);
+        if (k > 0) {
+            _lower[k - 1] = A.lower(k - 1);
+            pivot -= _lower[k - 1]*_coupling[k - 1];
+        }
+        LUStatus status = _pivotBlocks[k].tryFactor(pivot, tol);
+        if (not status) return LUStatus::singularAt(k*m + status.pivot);
+        if (k + 1 == blocks) break;
+
+        // X_k, column by column
+        const Matrix &upper = A.upper(k);
+        std::vector<Vector> columns(m, Vector(m));
+        for (index_t j = 0; j < m; ++j)
+            for (index_t i = 0; i < m; ++i) columns[j][i] = upper[i][j];
+        columns = solveLU(_pivotBlocks[k], columns);
+        Matrix &coupling = _coupling[k] = Matrix(m);
+        for (index_t j = 0; j < m; ++j)
+            for (index_t i = 0; i < m; ++i) coupling[i][j] = columns[j][i];
+    }
+
+    return {};
+}
+
+
+//-------------------- Cyclic reduction -------------------//
+
+Vector solveCyclicReduction(const TridiagonalMatrix &A, const Vector &b, double tol) {
+    const size_t n = A.size();
+    if (b.size() != n) throw std::invalid_argument("vector and matrix size are different");
+
+    // equation i: lower[i] x[i - s] + diag[i] x[i] + upper[i] x[i + s] = rhs[i], s doubling at each level
+    std::vector<double> lower(n, 0.0), diag = A.diagonal(), upper(n, 0.0);
+    std::copy(A.lower().begin(), A.lower().end(), lower.begin() + 1);
+    std::copy(A.upper().begin(), A.upper().end(), upper.begin());
+    Vector rhs = b;
+
+    // call f for the equations first, first + step, ... (< n), in parallel chunks if there are many
+    auto forEachEquation = [n](index_t first, size_t step, const std::function<void(index_t)> &f) {
+        const size_t count = first < n ? (n - first + step - 1)/step : 0;
+        if (count < CYCLIC_REDUCTION_PARALLEL_MIN_SIZE) {
+            for (index_t i = first; i < n; i += step) f(i);
+            return;
+        }
+        const size_t chunk = CYCLIC_REDUCTION_PARALLEL_MIN_SIZE/4, chunks = (count + chunk - 1)/chunk;
+        parallelFor(chunks, [&](index_t c) {
+            const index_t last = std::min(count, (c + 1)*chunk);
+            for (index_t k = c*chunk; k < last; ++k) f(first + k*step);
+        });
+    };
+
+    // reduction: at stride s, equations 2s - 1, 4s - 1, ... eliminate their neighbours at distance
+    // s (which no other equation of the level touches), and get coupled to those at distance 2s
+    size_t s = 1;
+    for (; 2*s <= n; s *= 2) {
+        std::atomic<bool> singular(false);
+        forEachEquation(2*s - 1, 2*s, [&](index_t i) {
+            const index_t prev = i - s, next = i + s;
+            if (std::abs(diag[prev]) < tol or (next < n and std::abs(diag[next]) < tol)) {
+                singular = true;
+                return;
+            }
+            const double alpha = -lower[i]/diag[prev];
+            diag[i] += alpha*upper[prev];
+            rhs[i] += alpha*rhs[prev];
+            lower[i] = alpha*lower[prev];
+            if (next < n) {
+                const double gamma = -upper[i]/diag[next];
+                diag[i] += gamma*lower[next];
+                rhs[i] += gamma*rhs[next];
+                upper[i] = gamma*upper[next];
+            } else {
+                upper[i] = 0.0;
+            }
+        });
+        if (singular) throw SingularMatrixError(tol, "in cyclic reduction");
+    }
+
+    // back substitution: at stride s, equations s - 1, 3s - 1, ... only involve unknowns found
+    // at the larger strides
+    Vector x(0.0, n);
+    for (; s > 0; s /= 2) {
+        std::atomic<bool> singular(false);
+        forEachEquation(s - 1, 2*s, [&](index_t i) {
+            if (std::abs(diag[i]) < tol) {
+                singular = true;
+                return;
+            }
+            double elem = rhs[i];
+            if (i >= s) elem -= lower[i]*x[i - s];
+            if (i + s < n) elem -= upper[i]*x[i + s];
+            x[i] = elem/diag[i];
+        });
+        if (singular) throw SingularMatrixError(tol, "in cyclic reduction");
+    }
+    return x;
+}
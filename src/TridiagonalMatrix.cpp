@@ -0,0 +1,134 @@
+#include "TridiagonalMatrix.h"
+
+#include <stdexcept>
+#include "errors.h"
+
+
+//-------------------- TridiagonalMatrix -------------------//
+
+TridiagonalMatrix::TridiagonalMatrix(size_t n)
+        : _lower(n > 0 ? n - 1 : 0, 0.0), _diagonal(n, 0.0), _upper(n > 0 ? n - 1 : 0, 0.0) {}
+
+TridiagonalMatrix::TridiagonalMatrix(std::vector<double> lower, std::vector<double> diagonal,
+                                     std::vector<double> upper)
+        : _lower(std::move(lower)), _diagonal(std::move(diagonal)), _upper(std::move(upper)) {
+    const size_t offDiagonal = _diagonal.empty() ? 0 : _diagonal.size() - 1;
+    if (_lower.size() != offDiagonal or _upper.size() != offDiagonal)
+        throw MatrixError("inconsistent tridiagonal matrix diagonals");
+}
+
+TridiagonalMatrix TridiagonalMatrix::fromDense(const Matrix &A) {
+    const size_t n = A.size();
+    TridiagonalMatrix result(n);
+    for (index_t i = 0; i < n; ++i)
+        for (index_t j = 0; j < n; ++j) {
+            const double value = A[i][j];
+            if (j + 1 == i) result._lower[j] = value;
+            else if (j == i) result._diagonal[i] = value;
+            else if (j == i + 1) result._upper[i] = value;
+            else if (value != 0.0) throw MatrixError("matrix is not tridiagonal");
+        }
+    return result;
+}
+
+double TridiagonalMatrix::operator()(index_t i, index_t j) const {
+    if (i >= size() or j >= size()) throw std::out_of_range("tridiagonal matrix index out of range");
+    if (j + 1 == i) return _lower[j];
+    if (j == i) return _diagonal[i];
+    if (j == i + 1) return _upper[i];
+    return 0.0;
+}
+
+Matrix TridiagonalMatrix::toDense() const {
+    const size_t n = size();
+    Matrix result(n);
+    for (index_t i = 0; i < n; ++i) {
+        result[i][i] = _diagonal[i];
+        if (i + 1 < n) {
+            result[i + 1][i] = _lower[i];
+            result[i][i + 1] = _upper[i];
+        }
+    }
+    return result;
+}
+
+
+Vector operator*(const TridiagonalMatrix &A, const Vector &v) {
+    const size_t n = A.size();
+    if (v.size() != n) throw MatrixError("vector and matrix size are different");
+    Vector result(n);
+    for (index_t i = 0; i < n; ++i) {
+        double elem = A.diagonal()[i]*v[i];
+        if (i > 0) elem += A.lower()[i - 1]*v[i - 1];
+        if (i + 1 < n) elem += A.upper()[i]*v[i + 1];
+        result[i] = elem;
+    }
+    return result;
+}
+
+
+//-------------------- BlockTridiagonalMatrix -------------------//
+
+BlockTridiagonalMatrix::BlockTridiagonalMatrix(size_t blocks, size_t blockSize)
+        : _blockSize(blockSize), _lower(blocks > 0 ? blocks - 1 : 0, Matrix(blockSize)),
+          _diagonal(blocks, Matrix(blockSize)), _upper(blocks > 0 ? blocks - 1 : 0, Matrix(blockSize)) {}
+
+BlockTridiagonalMatrix::BlockTridiagonalMatrix(std::vector<Matrix> lower, std::vector<Matrix> diagonal,
+                                               std::vector<Matrix> upper)
+        : _blockSize(diagonal.empty() ? 0 : diagonal.front().size()), _lower(std::move(lower)),
+          _diagonal(std::move(diagonal)), _upper(std::move(upper)) {
+    const size_t offDiagonal = _diagonal.empty() ? 0 : _diagonal.size() - 1;
+    if (_lower.size() != offDiagonal or _upper.size() != offDiagonal)
+        throw MatrixError("inconsistent block tridiagonal matrix diagonals");
+    for (const auto *blocks : {&_lower, &_diagonal, &_upper})
+        for (const Matrix &block : *blocks)
+            if (block.size() != _blockSize) throw MatrixError("block tridiagonal matrix blocks of different sizes");
+}
+
+BlockTridiagonalMatrix BlockTridiagonalMatrix::fromDense(const Matrix &A, size_t blockSize) {
+    const size_t n = A.size();
+    if (blockSize == 0 or n%blockSize != 0) throw MatrixError("block size doesn't divide the matrix size");
+    BlockTridiagonalMatrix result(n/blockSize, blockSize);
+    for (index_t i = 0; i < n; ++i)
+        for (index_t j = 0; j < n; ++j) {
+            const double value = A[i][j];
+            const index_t bi = i/blockSize, bj = j/blockSize, r = i%blockSize, c = j%blockSize;
+            if (bj + 1 == bi) result._lower[bj][r][c] = value;
+            else if (bj == bi) result._diagonal[bi][r][c] = value;
+            else if (bj == bi + 1) result._upper[bi][r][c] = value;
+            else if (value != 0.0) throw MatrixError("matrix is not block tridiagonal");
+        }
+    return result;
+}
+
+Matrix BlockTridiagonalMatrix::toDense() const {
+    const size_t blocks = blockCount(), m = _blockSize;
+    Matrix result(size());
+    auto place = [&](const Matrix &block, index_t bi, index_t bj) {
+        for (index_t r = 0; r < m; ++r)
+            for (index_t c = 0; c < m; ++c) result[bi*m + r][bj*m + c] = block[r][c];
+    };
+    for (index_t k = 0; k < blocks; ++k) {
+        place(_diagonal[k], k, k);
+        if (k + 1 < blocks) {
+            place(_lower[k], k + 1, k);
+            place(_upper[k], k, k + 1);
+        }
+    }
+    return result;
+}
+
+
+Vector operator*(const BlockTridiagonalMatrix &A, const Vector &v) {
+    const size_t blocks = A.blockCount(), m = A.blockSize();
+    if (v.size() != A.size()) throw MatrixError("vector and matrix size are different");
+    auto part = [&](index_t k) { return Vector(v[std::slice(k*m, m, 1)]); };
+    Vector result(A.size());
+    for (index_t k = 0; k < blocks; ++k) {
+        Vector elem = A.diagonal(k)*part(k);
+        if (k > 0) elem += A.lower(k - 1)*part(k - 1);
+        if (k + 1 < blocks) elem += A.upper(k)*part(k + 1);
+        result[std::slice(k*m, m, 1)] = elem;
+    }
+    return result;
+}
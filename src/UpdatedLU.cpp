@@ -0,0 +1,86 @@
+#include "UpdatedLU.h"
+
+#include <numeric>
+#include "errors.h"
+#include "norm.h"
+#include "resol.h"
+
+
+UpdatedLU::UpdatedLU(const Matrix &A, double tol, size_t maxRank, double maxResidue) {
+    LUStatus status = tryFactor(A, tol, maxRank, maxResidue);
+    if (not status) throw SingularMatrixError(tol, "at pivot " + std::to_string(status.pivot));
+}
+
+LUStatus UpdatedLU::tryFactor(const Matrix &A, double tol, size_t maxRank, double maxResidue) {
+    _A = A;
+    _U.clear();
+    _V.clear();
+    _Z.clear();
+    _C = Matrix();
+    _luC = LUDecomposition();
+    _refactorizations = 0;
+    _maxRank = maxRank;
+    _maxResidue = maxResidue;
+    _tol = tol;
+    return _luA.tryFactor(_A, tol);
+}
+
+LUStatus UpdatedLU::update(const Vector &u, const Vector &v) {
+    return update(std::vector<Vector>{u}, std::vector<Vector>{v});
+}
+
+LUStatus UpdatedLU::update(const std::vector<Vector> &U, const std::vector<Vector> &V) {
+    const size_t n = size();
+    if (U.size() != V.size()) throw MatrixError("low-rank factors of different ranks");
+    for (index_t j = 0; j < U.size(); ++j)
+        if (U[j].size() != n or V[j].size() != n) throw MatrixError("vector and matrix size are different");
+
+    _U.insert(_U.end(), U.begin(), U.end());
+    _V.insert(_V.end(), V.begin(), V.end());
+    if (rank() > _maxRank) return refactor();
+
+    // Z gets the new columns; C = I + V^T Z gets the new rows and columns
+    const std::vector<Vector> Z = solveLU(_luA, U);
+    _Z.insert(_Z.end(), Z.begin(), Z.end());
+    const size_t k = rank(), old = k - U.size();
+    Matrix C(k);
+    for (index_t i = 0; i < k; ++i)
+        for (index_t j = 0; j < k; ++j)
+            C[i][j] = i < old and j < old ? _C[i][j]
+                    : (i == j ? 1.0 : 0.0) + std::inner_product(begin(_V[i]), end(_V[i]), begin(_Z[j]), 0.0);
+    _C = std::move(C);
+    // not(<=): a NaN residue (b = 0, so M is singular) refactors too
+    if (not _luC.tryFactor(_C, _tol) or not(residue() <= _maxResidue)) return refactor();
+    return {};
+}
+
+LUStatus UpdatedLU::refactor() {
+    _A = matrix();
+    _U.clear();
+    _V.clear();
+    _Z.clear();
+    _C = Matrix();
+    _luC = LUDecomposition();
+    ++_refactorizations;
+    return _luA.tryFactor(_A, _tol);
+}
+
+Matrix UpdatedLU::matrix() const {
+    Matrix M = _A;
+    for (index_t j = 0; j < rank(); ++j)
+        for (index_t i = 0; i < size(); ++i)
+            if (_U[j][i] != 0.0) M[i] += _U[j][i]*_V[j];
+    return M;
+}
+
+double UpdatedLU::residue() const {
+    // M x = A x + U (V^T x), without forming M
+    auto product = [this](const Vector &x) {
+        Vector result = _A*x;
+        for (index_t j = 0; j < rank(); ++j) result += _U[j]*std::inner_product(begin(_V[j]), end(_V[j]), begin(x), 0.0);
+        return result;
+    };
+    const Vector b = product(Vector(1.0, size()));
+    const Vector residual = product(solveLU(*this, b)) - b;
+    return normInf(residual)/normInf(b);
+}
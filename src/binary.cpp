@@ -0,0 +1,258 @@
+#include "binary.h"
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <vector>
+#include "errors.h"
+
+
+constexpr char BinaryHeader::MAGIC[8];
+constexpr uint32_t BinaryHeader::BYTE_ORDER_MARK;
+
+static_assert(sizeof(BinaryHeader) == 64, "binary header must take 64 bytes");
+static_assert(sizeof(BinaryTriplet) == 24 and sizeof(BinaryPair) == 16, "unexpected padding");
+
+/// sections start at multiples of this
+const size_t SECTION_ALIGNMENT = 64;
+
+
+//---------- MatrixView ----------//
+
+double MatrixView::operator()(index_t i, index_t j) const {
+    if (i >= _n or j >= _n) throw std::out_of_range("matrix subscript out of range");
+    return _data[i*_n + j];
+}
+
+Vector operator*(const MatrixView &A, const Vector &v) {
+    const size_t n = A.size();
+    if (n != v.size())
+        throw MatrixError("matrix-vector multiplication dimension mismatch");
+
+    Vector result(n);
+    for (index_t i = 0; i < n; ++i) {
+        const double *row = A[i];
+        double elem = 0.0;
+        for (index_t j = 0; j < n; ++j) elem += row[j]*v[j];
+        result[i] = elem;
+    }
+    return result;
+}
+
+
+//---------- reading ----------//
+
+static uint64_t fnv1a(const char *data, size_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t k = 0; k < size; ++k) {
+        hash ^= uint8_t(data[k]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static size_t padded(size_t size) {
+    return (size + SECTION_ALIGNMENT - 1)/SECTION_ALIGNMENT*SECTION_ALIGNMENT;
+}
+
+bool isBinary(const char *first, const char *last) {
+    return size_t(last - first) >= sizeof(BinaryHeader::MAGIC)
+           and std::memcmp(first, BinaryHeader::MAGIC, sizeof(BinaryHeader::MAGIC)) == 0;
+}
+
+/// Validate a section header (found at `offset`) and return its payload size
+static size_t checkHeader(const BinaryHeader &header, BinaryKind kind, size_t offset) {
+    if (std::memcmp(header.magic, BinaryHeader::MAGIC, sizeof header.magic) != 0)
+        throw BadFormat("bad binary magic", offset);
+    if (header.version != BINARY_VERSION) throw BadFormat("unsupported binary format version", offset);
+    if (header.byteOrder != BinaryHeader::BYTE_ORDER_MARK) throw BadFormat("foreign byte order", offset);
+    if (header.kind != kind) throw BadFormat("unexpected binary section kind", offset);
+    if (header.dtype != BinaryDType::Float64) throw BadFormat("unsupported data type", offset);
+
+    if (header.n > UINT32_MAX) throw BadFormat("dimension too large", offset);
+    if (kind == BinaryKind::Matrix and header.n != 0 and header.n > UINT64_MAX/header.n)
+        throw BadFormat("dimension too large", offset);
+    size_t entrySize;
+    uint64_t denseEntries = kind == BinaryKind::Matrix ? header.n*header.n : header.n;
+    switch (header.layout) {
+        case BinaryLayout::Dense:
+            if (header.nnz != denseEntries) throw BadFormat("bad dense entry count", offset);
+            entrySize = sizeof(double);
+            break;
+        case BinaryLayout::Triplets:
+            if (header.nnz > denseEntries) throw BadFormat("number of elements larger than the dimension", offset);
+            entrySize = kind == BinaryKind::Matrix ? sizeof(BinaryTriplet) : sizeof(BinaryPair);
+            break;
+        default:
+            throw BadFormat("unknown binary layout", offset);
+    }
+
+    // nnz*entrySize must neither wrap around nor exceed what a mapping can hold
+    if (header.nnz > (SIZE_MAX - sizeof(BinaryHeader))/entrySize) throw BadFormat("too many entries", offset);
+    if (header.payloadBytes != header.nnz*entrySize) throw BadFormat("bad binary payload size", offset);
+    return size_t(header.payloadBytes);
+}
+
+/// Validate the section header at `offset` and return it, together with a pointer to its payload
+static const BinaryHeader &mapSection(const MappedFile &file, size_t offset, BinaryKind kind,
+                                      bool verify, const char *&payload) {
+    if (offset % SECTION_ALIGNMENT != 0 or offset > file.size()
+        or file.size() - offset < sizeof(BinaryHeader))
+        throw BadFormat("truncated binary section header", offset);
+    const char *start = file.begin() + offset;
+    const auto &header = *reinterpret_cast<const BinaryHeader *>(start);
+    const size_t payloadBytes = checkHeader(header, kind, offset);
+    if (payloadBytes > file.size() - offset - sizeof(BinaryHeader))
+        throw BadFormat("truncated binary payload", offset);
+
+    payload = start + sizeof(BinaryHeader);
+    if (verify and fnv1a(payload, payloadBytes) != header.checksum)
+        throw BadFormat("binary checksum mismatch", offset);
+    return header;
+}
+
+BinaryMatrix mapBinaryMatrix(const MappedFile &file, size_t offset, bool verify) {
+    const char *payload;
+    const BinaryHeader &header = mapSection(file, offset, BinaryKind::Matrix, verify, payload);
+    const bool dense = header.layout == BinaryLayout::Dense;
+    return {
+            header.layout, size_t(header.n), size_t(header.nnz),
+            dense ? reinterpret_cast<const double *>(payload) : nullptr,
+            dense ? nullptr : reinterpret_cast<const BinaryTriplet *>(payload),
+            offset + padded(sizeof(BinaryHeader) + header.payloadBytes)
+    };
+}
+
+BinaryVector mapBinaryVector(const MappedFile &file, size_t offset, bool verify) {
+    const char *payload;
+    const BinaryHeader &header = mapSection(file, offset, BinaryKind::Vector, verify, payload);
+    const bool dense = header.layout == BinaryLayout::Dense;
+    return {
+            header.layout, size_t(header.n), size_t(header.nnz),
+            dense ? reinterpret_cast<const double *>(payload) : nullptr,
+            dense ? nullptr : reinterpret_cast<const BinaryPair *>(payload),
+            offset + padded(sizeof(BinaryHeader) + header.payloadBytes)
+    };
+}
+
+Vector readBinaryVector(std::istream &is) {
+    BinaryHeader header;
+    if (not is.read(reinterpret_cast<char *>(&header), sizeof header))
+        throw BadFormat("truncated binary section header");
+    const size_t payloadBytes = checkHeader(header, BinaryKind::Vector, 0);
+
+    std::vector<char> payload(padded(sizeof header + payloadBytes) - sizeof header);
+    if (not is.read(payload.data(), std::streamsize(payload.size())))
+        throw BadFormat("truncated binary payload");
+    if (fnv1a(payload.data(), payloadBytes) != header.checksum)
+        throw BadFormat("binary checksum mismatch");
+
+    BinaryVector section = {
+            header.layout, size_t(header.n), size_t(header.nnz),
+            reinterpret_cast<const double *>(payload.data()),
+            reinterpret_cast<const BinaryPair *>(payload.data()),
+            0
+    };
+    return section.toVector();
+}
+
+MatrixView BinaryMatrix::view() const {
+    if (layout != BinaryLayout::Dense) throw ValueError("only dense binary matrices can be viewed");
+    return {dense, n};
+}
+
+Matrix BinaryMatrix::toMatrix() const {
+    Matrix mat(n);
+    if (layout == BinaryLayout::Dense) {
+        for (index_t i = 0; i < n; ++i)
+            std::copy(dense + i*n, dense + (i + 1)*n, begin(mat[i]));
+    } else {
+        for (const BinaryTriplet *entry = triplets; entry != triplets + nnz; ++entry) {
+            if (entry->i >= n or entry->j >= n) throw BadFormat("matrix index out of range in binary section");
+            mat[entry->i][entry->j] = entry->value;
+        }
+    }
+    return mat;
+}
+
+SparseMatrix BinaryMatrix::toSparse() const {
+    TripletBuilder builder(n);
+    if (layout == BinaryLayout::Dense) {
+        for (index_t i = 0; i < n; ++i)
+            for (index_t j = 0; j < n; ++j)
+                if (dense[i*n + j] != 0.0) builder.add(i, j, dense[i*n + j]);
+    } else {
+        builder.reserve(nnz);
+        for (const BinaryTriplet *entry = triplets; entry != triplets + nnz; ++entry) {
+            if (entry->i >= n or entry->j >= n) throw BadFormat("matrix index out of range in binary section");
+            builder.add(entry->i, entry->j, entry->value);
+        }
+    }
+    return builder.build<index_t>();
+}
+
+Vector BinaryVector::toVector() const {
+    if (layout == BinaryLayout::Dense) return Vector(dense, n);
+    Vector vec(0.0, n);
+    for (const BinaryPair *entry = pairs; entry != pairs + nnz; ++entry) {
+        if (entry->i >= n) throw BadFormat("vector index out of range in binary section");
+        vec[entry->i] = entry->value;
+    }
+    return vec;
+}
+
+
+//---------- writing ----------//
+
+static void writeSection(std::ostream &os, BinaryKind kind, BinaryLayout layout, size_t n,
+                         size_t nnz, const char *payload, size_t payloadBytes) {
+    BinaryHeader header = {};
+    std::memcpy(header.magic, BinaryHeader::MAGIC, sizeof header.magic);
+    header.version = BINARY_VERSION;
+    header.byteOrder = BinaryHeader::BYTE_ORDER_MARK;
+    header.kind = kind;
+    header.layout = layout;
+    header.dtype = BinaryDType::Float64;
+    header.n = n;
+    header.nnz = nnz;
+    header.payloadBytes = payloadBytes;
+    header.checksum = fnv1a(payload, payloadBytes);
+
+    static const char zeros[SECTION_ALIGNMENT] = {};
+    os.write(reinterpret_cast<const char *>(&header), sizeof header);
+    os.write(payload, std::streamsize(payloadBytes));
+    os.write(zeros, std::streamsize(padded(sizeof header + payloadBytes) - sizeof header - payloadBytes));
+    if (not os) throw IOError("error while writing binary data");
+}
+
+void writeBinaryMatrix(std::ostream &os, const Matrix &A, BinaryLayout layout) {
+    const size_t n = A.size();
+    if (layout == BinaryLayout::Dense) {
+        std::vector<double> data(n*n);
+        for (index_t i = 0; i < n; ++i) std::copy(begin(A[i]), end(A[i]), data.begin() + i*n);
+        writeSection(os, BinaryKind::Matrix, layout, n, n*n,
+                     reinterpret_cast<const char *>(data.data()), data.size()*sizeof(double));
+    } else {
+        std::vector<BinaryTriplet> entries;
+        for (index_t i = 0; i < n; ++i)
+            for (index_t j = 0; j < n; ++j)
+                if (A[i][j] != 0.0) entries.push_back({i, j, A[i][j]});
+        writeSection(os, BinaryKind::Matrix, layout, n, entries.size(),
+                     reinterpret_cast<const char *>(entries.data()), entries.size()*sizeof(BinaryTriplet));
+    }
+}
+
+void writeBinaryVector(std::ostream &os, const Vector &b, BinaryLayout layout) {
+    const size_t n = b.size();
+    if (layout == BinaryLayout::Dense) {
+        writeSection(os, BinaryKind::Vector, layout, n, n,
+                     reinterpret_cast<const char *>(n ? &b[0] : nullptr), n*sizeof(double));
+    } else {
+        std::vector<BinaryPair> entries;
+        for (index_t i = 0; i < n; ++i)
+            if (b[i] != 0.0) entries.push_back({i, b[i]});
+        writeSection(os, BinaryKind::Vector, layout, n, entries.size(),
+                     reinterpret_cast<const char *>(entries.data()), entries.size()*sizeof(BinaryPair));
+    }
+}
@@ -20,3 +20,6 @@ std::string SingularMatrixError::getDetails(const std::string &details, double t
     oss << "tol = " << std::scientific << tol;
     return oss.str();
 }
+
+BadFormat::BadFormat(const char *specific, size_t offset)
+        : BaseException(base, std::string(specific ? specific : "") + " at byte " + std::to_string(offset)) {}
@@ -2,12 +2,12 @@
 // Created by Paolo on 17/05/2019.
 //
 
-#include <errors.h>
 #include "extra.h"
 
 double determinant(const Matrix &A) {
-    try { return determinant(LUDecomposition(A)); } 
-    catch (SingularMatrixError &) { return 0.0; }
+    LUDecomposition luObj;
+    if (not luObj.tryFactor(A)) return 0.0;
+    return determinant(luObj);
 }
 
 double determinant(const LUDecomposition &luObj) {
@@ -18,3 +18,23 @@ double determinant(const LUDecomposition &luObj) {
         prod *= U(i, i);
     return prod*(luObj.perm().parity() ? -1 : 1);
 }
+
+double determinant(const CholeskyDecomposition &cholObj) {
+    const PackedMatrix &L = cholObj.factor();
+    double prod = 1.0;
+    for (index_t i = 0; i < L.size(); ++i)
+        prod *= L.at(i, i);
+    return prod*prod;
+}
+
+double determinant(const LDLTDecomposition &ldlObj) {
+    const PackedMatrix &D = ldlObj.factors();
+    double prod = 1.0;
+    for (index_t k = 0; k < D.size(); ++k) {
+        if (ldlObj.isTwoByTwo(k)) {
+            prod *= D.at(k, k)*D.at(k + 1, k + 1) - D.at(k + 1, k)*D.at(k + 1, k);
+            ++k;
+        } else prod *= D.at(k, k);
+    }
+    return prod;
+}
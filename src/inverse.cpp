@@ -19,14 +19,29 @@ Matrix identity(size_t n) {
     return Id;
 }
 
-Matrix inverse(const LUDecomposition &luObj) {
-    const size_t n = luObj.decompMatrix().size();
-    Matrix Inv(n);
-    for (index_t i = 0; i < n; ++i) {
-        Vector column = solveLU(luObj, e(i, n));
-        for (index_t j = 0; j < n; ++j) Inv[j][i] = column[j];
+namespace {
+    // Inverse of an n by n matrix, column by column from the solutions for e_0, ..., e_(n-1)
+    template<typename Solve>
+    Matrix inverseByColumns(size_t n, Solve solve) {
+        Matrix Inv(n);
+        for (index_t i = 0; i < n; ++i) {
+            Vector column = solve(e(i, n));
+            for (index_t j = 0; j < n; ++j) Inv[j][i] = column[j];
+        }
+        return Inv;
     }
-    return Inv;
+}
+
+Matrix inverse(const LUDecomposition &luObj) {
+    return inverseByColumns(luObj.decompMatrix().size(), [&](const Vector &b) { return solveLU(luObj, b); });
+}
+
+Matrix inverse(const CholeskyDecomposition &cholObj) {
+    return inverseByColumns(cholObj.size(), [&](const Vector &b) { return solveCholesky(cholObj, b); });
+}
+
+Matrix inverse(const LDLTDecomposition &ldlObj) {
+    return inverseByColumns(ldlObj.size(), [&](const Vector &b) { return solveLDLT(ldlObj, b); });
 }
 
 Matrix inverse(const Matrix &A) {
@@ -11,19 +11,23 @@
 #include "norm.h"
 #include "errors.h"
 #include "sistema.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+#include "binary.h"
 
 
-std::string getOutName(const char *iname);
-
 Vector readVector(std::istream &is, size_t n) {
+    // a missing vector is read as the null vector
     size_t k = 0;
-    is >> k;
+    if (not(is >> k) and not is.eof()) throw BadFormat("couldn't parse vector");
 
     Vector vec(0.0, n);
     for (; k > 0; --k) {
-        index_t i;
+        index_t i = n;
         is >> i;
+        if (is and i >= n) throw BadFormat("vector index out of range");
         is >> vec[i];
+        if (is.fail()) throw BadFormat("couldn't parse vector");
     }
 
     return vec;
@@ -46,21 +50,321 @@ Matrix readMatrix(std::istream &is) {
     return mat;
 }
 
+Vector readVector(Scanner &scanner, size_t n) {
+    static const char *const what = "couldn't parse vector";
+    // a missing vector is read as the null vector
+    size_t k = scanner.atEnd() ? 0 : scanner.readIndex(what);
+
+    Vector vec(0.0, n);
+    for (; k > 0; --k) {
+        index_t i = scanner.readIndex(what);
+        if (i >= n) throw BadFormat("vector index out of range", scanner.offset());
+        vec[i] = scanner.readDouble(what);  // index already checked
+    }
+
+    return vec;
+}
+
+//---------- parallel triplet parsing ----------//
+
+namespace {
+
+    const char *const MATRIX_PARSE_ERROR = "couldn't parse matrix";
+
+    /// Inputs smaller than this are parsed sequentially
+    const size_t PARALLEL_PARSE_MIN_BYTES = size_t(1) << 22;
+    const size_t PARSE_CHUNK_BYTES = size_t(1) << 20;
+
+    struct Triplet {
+        index_t i, j;
+        double value;
+    };
+
+    /// Split [first, last) in about nChunks pieces that start at the beginning of a line
+    std::vector<const char *> splitLines(const char *first, const char *last, size_t nChunks) {
+        std::vector<const char *> bounds = {first};
+        const size_t chunkSize = size_t(last - first)/nChunks + 1;
+        for (const char *pos = first + chunkSize; pos < last; pos += chunkSize) {
+            while (pos != last and *pos != '\n') ++pos;
+            if (pos == last) break;
+            if (++pos <= bounds.back()) continue;
+            bounds.push_back(pos);
+        }
+        bounds.push_back(last);
+        return bounds;
+    }
+
+    size_t countTokens(const char *first, const char *last) {
+        size_t count = 0;
+        bool inToken = false;
+        for (; first != last; ++first) {
+            bool space = isSpace(*first);
+            count += not space and not inToken;
+            inToken = not space;
+        }
+        return count;
+    }
+
+    /// Parse m triplets of an n by n matrix, passing each to set(i, j, value)
+    template<typename Setter>
+    void readTripletsSequential(Scanner &scanner, size_t n, size_t m, Setter set) {
+        for (; m > 0; --m) {
+            index_t i = scanner.readIndex(MATRIX_PARSE_ERROR);
+            index_t j = scanner.readIndex(MATRIX_PARSE_ERROR);
+            if (i >= n or j >= n) throw BadFormat("matrix index out of range", scanner.offset());
+            set(i, j, scanner.readDouble(MATRIX_PARSE_ERROR));  // indices already checked
+        }
+    }
+
+    /// Triplets parsed in parallel: for each chunk (in file order), its entries split by row stripes
+    struct ParsedTriplets {
+        size_t stripes;
+        std::vector<std::vector<std::vector<Triplet>>> chunks;
+    };
+
+    /**
+     * Parse the m triplets following the scanner's position on the shared thread pool.
+     * The input is cut at line boundaries; a first pass counts the tokens of each chunk
+     * so that every chunk knows which triplets start inside it. Parsed entries are then
+     * grouped by row stripes; applying them chunk after chunk makes repeated (i, j)
+     * entries resolve exactly as in a sequential read (the last one wins).
+     */
+    ParsedTriplets parseTripletsParallel(Scanner &scanner, size_t n, size_t m) {
+        const char *const last = scanner.end();
+        const size_t nChunks = std::max<size_t>(
+                size_t(last - scanner.position())/PARSE_CHUNK_BYTES,
+                4*(ThreadPool::shared().size() + 1));
+        const auto bounds = splitLines(scanner.position(), last, nChunks);
+        const size_t chunks = bounds.size() - 1;
+
+        // global index of the first token of each chunk:
+        std::vector<size_t> firstToken(chunks + 1, 0);
+        parallelFor(chunks, [&](index_t c) { firstToken[c + 1] = countTokens(bounds[c], bounds[c + 1]); });
+        for (index_t c = 0; c < chunks; ++c) firstToken[c + 1] += firstToken[c];
+        const size_t tokensNeeded = 3*m;
+        if (firstToken.back() < tokensNeeded) {
+            scanner.seek(last);
+            throw BadFormat(MATRIX_PARSE_ERROR, scanner.offset());
+        }
+
+        const size_t stripes = std::min<size_t>(n, 4*(ThreadPool::shared().size() + 1));
+        const size_t stripeHeight = n/stripes + 1;
+        std::vector<std::vector<std::vector<Triplet>>> parsed(chunks);
+        std::vector<std::exception_ptr> errors(chunks);
+        const char *matrixEnd = scanner.position();
+
+        parallelFor(chunks, [&](index_t c) {
+            const size_t lastToken = std::min(firstToken[c + 1], tokensNeeded);
+            size_t token = firstToken[c];
+            if (token >= lastToken) return;
+            auto &buckets = parsed[c];
+            buckets.resize(stripes);
+
+            try {
+                Scanner local(scanner.begin(), last);
+                local.seek(bounds[c]);
+                // skip the tail of a triplet that started in the previous chunk:
+                for (; token%3 != 0; ++token) local.skipToken();
+                bool parsedAny = false;
+                for (; token < lastToken; token += 3, parsedAny = true) {
+                    index_t i = local.readIndex(MATRIX_PARSE_ERROR);
+                    index_t j = local.readIndex(MATRIX_PARSE_ERROR);
+                    if (i >= n or j >= n) throw BadFormat("matrix index out of range", local.offset());
+                    double value = local.readDouble(MATRIX_PARSE_ERROR);
+                    buckets[i/stripeHeight].push_back({i, j, value});
+                }
+                // only the chunk holding the start of the last triplet gets here:
+                if (parsedAny and token >= tokensNeeded) matrixEnd = local.position();
+            } catch (...) {
+                errors[c] = std::current_exception();
+            }
+        });
+
+        // report the error closest to the start of the file:
+        for (const auto &error : errors)
+            if (error) std::rethrow_exception(error);
+
+        scanner.seek(matrixEnd);
+        return {stripes, std::move(parsed)};
+    }
+
+    void readTripletsParallel(Scanner &scanner, Matrix &mat, size_t m, Bandwidth *bandwidth) {
+        const ParsedTriplets parsed = parseTripletsParallel(scanner, mat.size(), m);
+        std::vector<Bandwidth> stripeBands(bandwidth ? parsed.stripes : 0);
+        parallelFor(parsed.stripes, [&](index_t stripe) {
+            for (const auto &buckets : parsed.chunks) {
+                if (buckets.empty()) continue;
+                for (const Triplet &entry : buckets[stripe]) {
+                    mat[entry.i][entry.j] = entry.value;
+                    if (bandwidth and entry.value != 0.0) stripeBands[stripe].add(entry.i, entry.j);
+                }
+            }
+        });
+        for (const Bandwidth &band : stripeBands) bandwidth->merge(band);
+    }
+
+    void readTripletsParallel(Scanner &scanner, TripletBuilder &builder, size_t m) {
+        const ParsedTriplets parsed = parseTripletsParallel(scanner, builder.size(), m);
+        builder.reserve(m);
+        for (index_t stripe = 0; stripe < parsed.stripes; ++stripe)
+            for (const auto &buckets : parsed.chunks) {
+                if (buckets.empty()) continue;
+                for (const Triplet &entry : buckets[stripe]) builder.add(entry.i, entry.j, entry.value);
+            }
+    }
+
+    /// Read the header "n m" of a matrix in triplet format
+    void readMatrixHeader(Scanner &scanner, size_t &n, size_t &m) {
+        n = scanner.readIndex(MATRIX_PARSE_ERROR);
+        m = scanner.readIndex(MATRIX_PARSE_ERROR);
+        if (m > n * n)
+            throw BadFormat("number of elements larger than n^2 while reading matrix", scanner.offset());
+    }
+
+    bool parseInParallel(const Scanner &scanner, size_t m) {
+        const size_t remaining = size_t(scanner.end() - scanner.position());
+        return m > 0 and remaining >= PARALLEL_PARSE_MIN_BYTES and ThreadPool::shared().size() > 1;
+    }
+
+}
+
+
+namespace {
+
+    Matrix readDenseMatrix(Scanner &scanner, Bandwidth *bandwidth) {
+        size_t n, m;
+        readMatrixHeader(scanner, n, m);
+
+        Matrix mat(n);
+        if (parseInParallel(scanner, m))
+            readTripletsParallel(scanner, mat, m, bandwidth);
+        else
+            readTripletsSequential(scanner, n, m, [&mat, bandwidth](index_t i, index_t j, double value) {
+                mat[i][j] = value;
+                if (bandwidth and value != 0.0) bandwidth->add(i, j);
+            });
+
+        return mat;
+    }
+
+}
+
+
+Matrix readMatrix(Scanner &scanner) {
+    return readDenseMatrix(scanner, nullptr);
+}
+
+Matrix readMatrix(Scanner &scanner, Bandwidth &bandwidth) {
+    bandwidth = Bandwidth();
+    return readDenseMatrix(scanner, &bandwidth);
+}
+
+SparseMatrix readSparseMatrix(Scanner &scanner) {
+    size_t n, m;
+    readMatrixHeader(scanner, n, m);
+
+    TripletBuilder builder(n);
+    if (parseInParallel(scanner, m))
+        readTripletsParallel(scanner, builder, m);
+    else {
+        builder.reserve(m);
+        readTripletsSequential(scanner, n, m, [&builder](index_t i, index_t j, double value) {
+            builder.add(i, j, value);
+        });
+    }
+
+    return builder.build<index_t>();
+}
+
+SkylineMatrix readSkylineMatrix(Scanner &scanner, bool symmetric) {
+    return SkylineMatrix::fromSparse(readSparseMatrix(scanner), symmetric);
+}
+
+void printInfoNumber(double infoNum, OutputWriter &out, unsigned precision, const char *title) {
+    out.write(title);
+    out.write(": ", 2);
+    out.writeScientific(infoNum, precision);
+    out.write("\n\n", 2);
+}
+
 void printInfoNumber(double infoNum, std::ostream &os, const char *title) {
-    os << title << ": " << std::scientific << infoNum << "\n\n";
+    OutputWriter out(os);
+    printInfoNumber(infoNum, out, unsigned(os.precision()), title);
 }
 
 
+void printResult(const SolveResult &result, const ExtraSolveInfo &info, std::ostream &os, OutputFormat format) {
+    const auto &xs = result.solutions();
+    const auto &perm = result.perm();
+    const size_t n = xs.front().size();
+    OutputWriter out(os);
 
-void printResult(const SolveResult &result, const ExtraSolveInfo &info, std::ostream &os) {
-    os.precision(PRECISION);
+    switch (format) {
+        case OutputFormat::Text:
+            if (xs.size() == 1) {
+                printVector(xs.front(), out, PRECISION);
+                printInfoNumber(info.residue, out, PRECISION, "residue");
+            } else for (index_t r = 0; r < xs.size(); ++r) {
+                const std::string number = std::to_string(r + 1);
+                printVector(xs[r], out, PRECISION, ("solution " + number).c_str());
+                printInfoNumber(info.residues[r], out, PRECISION, ("residue " + number).c_str());
+            }
+            out.write("method: ");
+            out.write(methodName(result.method()));
+            out.write("\n\n", 2);
+            if (result.isIterative()) {
+                // no factorization: report the convergence instead of the condition numbers and permutations
+                for (index_t r = 0; r < xs.size(); ++r) {
+                    const std::string number = xs.size() == 1 ? "" : " " + std::to_string(r + 1);
+                    out.write(("iterations" + number + ": ").c_str());
+                    out.writeIndex(result.iterations()[r]);
+                    out.write("\n\n", 2);
+                    printInfoNumber(result.iterativeResiduals()[r], out, PRECISION,
+                                    ("relative residual" + number).c_str());
+                }
+                break;
+            }
+            printInfoNumber(info.cond1, out, PRECISION, "condition number μ_1");
+            printInfoNumber(info.condInf, out, PRECISION, "condition number μ_Inf");
+            printVector(perm, out, PRECISION, "permutation vector");
+            if (result.colPerm().size() != 0)
+                printVector(result.colPerm(), out, PRECISION, "column permutation vector");
+            break;
 
-    printVector(result.solution(), os);
-    printInfoNumber(info.residue, os, "residue");
-    printInfoNumber(info.cond1, os, "condition number μ_1");
-    printInfoNumber(info.condInf, os, "condition number μ_Inf");
-    printVector(result.getLU().perm().vector(), os, "permutation vector");
+        case OutputFormat::CSV:
+            out.write("index");
+            if (xs.size() == 1) out.write(",solution");
+            else for (index_t r = 0; r < xs.size(); ++r) {
+                out.write(",solution_");
+                out.writeIndex(r + 1);
+            }
+            if (not result.isIterative()) out.write(",permutation");
+            out.write(result.colPerm().size() != 0 ? ",column_permutation\n" : "\n");
+            for (index_t i = 0; i < n; ++i) {
+                out.writeIndex(i);
+                for (const Vector &x : xs) {
+                    out.put(',');
+                    out.writeScientific(x[i], ROUND_TRIP_PRECISION);
+                }
+                if (not result.isIterative()) {
+                    out.put(',');
+                    out.writeIndex(perm[i]);
+                }
+                if (result.colPerm().size() != 0) {
+                    out.put(',');
+                    out.writeIndex(result.colPerm()[i]);
+                }
+                out.put('\n');
+            }
+            break;
 
+        case OutputFormat::Binary:
+            out.flush();
+            for (const Vector &x : xs) writeBinaryVector(out.stream(), x);
+            break;
+    }
+
+    out.flush();
     os.flush();
 }
 
@@ -72,18 +376,131 @@ std::string getFileName(const std::string &path) {
     return "";
 }
 
-std::string solveFile(const char *filePath) {
-    std::ifstream inputFile = openFile(filePath);
+void peekDimensions(const MappedFile &file, size_t &n, size_t &m) {
+    if (isBinary(file)) {
+        BinaryMatrix binA = mapBinaryMatrix(file, 0, false);
+        n = binA.n;
+        m = binA.nnz;
+    } else {
+        Scanner scanner(file);
+        n = scanner.readIndex(MATRIX_PARSE_ERROR);
+        m = scanner.readIndex(MATRIX_PARSE_ERROR);
+    }
+}
 
-    Matrix &&A = readMatrix(inputFile);
-    Vector &&b = readVector(inputFile, A.size());
-    auto result = solve(A, b);
-    if (not result) throw SingularMatrixError(result.tol());
-    ExtraSolveInfo info = getExtraSolveInfo(A, b, result);
+void readSystem(const MappedFile &file, Matrix &A, Vector &b) {
+    if (isBinary(file)) {
+        BinaryMatrix binA = mapBinaryMatrix(file);
+        A = binA.toMatrix();
+        // a missing vector is read as the null vector
+        if (binA.end >= file.size()) b = Vector(0.0, A.size());
+        else {
+            BinaryVector binB = mapBinaryVector(file, binA.end);
+            if (binB.n != A.size()) throw BadFormat("vector and matrix size are different", binA.end);
+            b = binB.toVector();
+        }
+    } else {
+        Scanner scanner(file);
+        A = readMatrix(scanner);
+        b = readVector(scanner, A.size());
+    }
+}
+
+namespace {
+    // Read the right-hand sides following a matrix of dimension n, starting at `offset`
+    void readVectors(const MappedFile &file, size_t offset, size_t n, std::vector<Vector> &bs) {
+        bs.clear();
+        if (isBinary(file)) {
+            while (offset < file.size()) {
+                BinaryVector binB = mapBinaryVector(file, offset);
+                if (binB.n != n) throw BadFormat("vector and matrix size are different", offset);
+                bs.push_back(binB.toVector());
+                offset = binB.end;
+            }
+        } else {
+            Scanner scanner(file);
+            scanner.seek(file.data() + offset);
+            while (not scanner.atEnd()) bs.push_back(readVector(scanner, n));
+        }
+        // a missing vector is read as the null vector
+        if (bs.empty()) bs.emplace_back(0.0, n);
+    }
+}
+
+void readSystem(const MappedFile &file, Matrix &A, std::vector<Vector> &bs) {
+    size_t offset;
+    if (isBinary(file)) {
+        BinaryMatrix binA = mapBinaryMatrix(file);
+        A = binA.toMatrix();
+        offset = binA.end;
+    } else {
+        Scanner scanner(file);
+        A = readMatrix(scanner);
+        offset = scanner.offset();
+    }
+    readVectors(file, offset, A.size(), bs);
+}
+
+void readSystem(const MappedFile &file, SparseMatrix &A, std::vector<Vector> &bs) {
+    size_t offset;
+    if (isBinary(file)) {
+        BinaryMatrix binA = mapBinaryMatrix(file);
+        A = binA.toSparse();
+        offset = binA.end;
+    } else {
+        Scanner scanner(file);
+        A = readSparseMatrix(scanner);
+        offset = scanner.offset();
+    }
+    readVectors(file, offset, A.size(), bs);
+}
+
+namespace {
+    template<typename MatrixType>
+    SolveResult solveSystem(const MatrixType &A, const std::vector<Vector> &bs, const IterativeOptions *,
+                            SolverChoice choice) {
+        return solve(A, bs, numcomp::DEFAULT_TOL, choice);
+    }
+
+    // sparse matrices always get a general (sparse) LU decomposition, or an iterative solver
+    SolveResult solveSystem(const SparseMatrix &A, const std::vector<Vector> &bs, const IterativeOptions *iterative,
+                            SolverChoice) {
+        return iterative ? solve(A, bs, *iterative) : solve(A, bs);
+    }
+
+    template<typename MatrixType>
+    std::string solveFile(const char *filePath, const MappedFile &inputFile, OutputFormat format,
+                          const IterativeOptions *iterative, SolverChoice choice) {
+        MatrixType A;
+        std::vector<Vector> bs;
+        readSystem(inputFile, A, bs);
+
+        auto result = solveSystem(A, bs, iterative, choice);
+        if (not result)
+            throw SingularMatrixError(result.tol(), std::string(result.isIterative() ? "in the preconditioner " : "") +
+                                                    "at pivot " + std::to_string(result.status().pivot));
+        ExtraSolveInfo info = getExtraSolveInfo(A, bs, result);
+
+        return writeSolution(filePath, result, info, format);
+    }
+}
+
+std::string solveFile(const char *filePath, OutputFormat format, const IterativeOptions *iterative,
+                      SolverChoice choice) {
+    MappedFile inputFile(filePath);
+    // keep the matrix sparse unless it's dense enough for dense storage to pay off
+    // (iterative methods only need products with A, so they always keep it sparse)
+    size_t n, m;
+    peekDimensions(inputFile, n, m);
+    if (iterative or preferSparse(n, m)) return solveFile<SparseMatrix>(filePath, inputFile, format, iterative, choice);
+    return solveFile<Matrix>(filePath, inputFile, format, iterative, choice);
+}
 
-    auto oname = getOutName(filePath);
-    auto outFile = writeFile(oname);
-    printResult(result, info, outFile);
+std::string writeSolution(const char *filePath, const SolveResult &result, const ExtraSolveInfo &info,
+                          OutputFormat format) {
+    auto oname = getOutName(filePath, format);
+    auto outFile = writeFile(oname, format == OutputFormat::Binary ? std::ios::binary : std::ios::openmode());
+    printResult(result, info, outFile, format);
     return oname;
 }
 
@@ -94,16 +511,17 @@ std::ifstream openFile(const char *path) {
 }
 
 
-std::ofstream writeFile(const std::string &oname) {
-    std::ofstream outFile(oname);
+std::ofstream writeFile(const std::string &oname, std::ios::openmode mode) {
+    std::ofstream outFile(oname, mode | std::ios::out);
     if (not outFile.is_open()) throw IOError(oname.c_str());
     return outFile;
 }
 
 
-std::string getOutName(const char *iname) {
+std::string getOutName(const char *iname, OutputFormat format) {
+    static const char *const extensions[] = {".DAT", ".CSV", ".BIN"};
     std::ostringstream oss;
-    oss << "SOLUTION_" << getFileName(iname) << ".DAT";
+    oss << "SOLUTION_" << getFileName(iname) << extensions[int(format)];
     std::string outName = oss.str();
     return outName;
 }
@@ -0,0 +1,320 @@
+#include "iterative.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include "errors.h"
+#include "norm.h"
+
+
+//---------- IncompleteLU ----------//
+
+LUStatus IncompleteLU::factorILU0(const SparseMatrix &A) {
+    _LU = A.converted(SparseLayout::CSR);
+    const size_t n = _LU.size();
+    const auto &pointers = _LU.pointers();
+    const auto &indices = _LU.indices();
+    auto &values = _LU.values();
+
+    _diag.assign(n, 0);
+    std::vector<index_t> position(n, index_t(-1));  // position of column j in the current row
+    for (index_t i = 0; i < n; ++i) {
+        for (index_t p = pointers[i]; p < pointers[i + 1]; ++p) position[indices[p]] = p;
+        if (position[i] == index_t(-1)) return LUStatus::singularAt(i);  // no room for a pivot
+        _diag[i] = position[i];
+
+        // Subtract multiples of the rows above from row i, within the pattern of row i
+        for (index_t p = pointers[i]; p < _diag[i]; ++p) {
+            const index_t k = indices[p];
+            const double multiplier = values[p] /= values[_diag[k]];
+            for (index_t q = _diag[k] + 1; q < pointers[k + 1]; ++q) {
+                const index_t at = position[indices[q]];
+                if (at != index_t(-1)) values[at] -= multiplier*values[q];
+            }
+        }
+
+        for (index_t p = pointers[i]; p < pointers[i + 1]; ++p) position[indices[p]] = index_t(-1);
+        if (values[_diag[i]] == 0.0) return LUStatus::singularAt(i);
+    }
+
+    return {};
+}
+
+LUStatus IncompleteLU::factorILUT(const SparseMatrix &A_, double dropTol, size_t fill) {
+    const SparseMatrix &A = A_.layout() == SparseLayout::CSR ? A_ : A_.converted(SparseLayout::CSR);
+    const size_t n = A.size();
+    std::vector<index_t> pointers = {0}, indices;
+    std::vector<double> values;
+    _diag.assign(n, 0);
+
+    Vector w(0.0, n);  // current row, expanded
+    std::vector<bool> inRow(n, false);
+    std::vector<index_t> pattern;
+    std::priority_queue<index_t, std::vector<index_t>, std::greater<index_t>> pending;  // columns < i to eliminate
+    std::vector<std::pair<double, index_t>> lower, upper;
+
+    for (index_t i = 0; i < n; ++i) {
+        pattern.clear();
+        double rowNorm = 0.0;
+        for (index_t p = A.pointers()[i]; p < A.pointers()[i + 1]; ++p) {
+            const index_t j = A.indices()[p];
+            w[j] = A.values()[p];
+            inRow[j] = true;
+            pattern.push_back(j);
+            if (j < i) pending.push(j);
+            rowNorm += w[j]*w[j];
+        }
+        const double rowTol = dropTol*std::sqrt(rowNorm);
+
+        // Subtract multiples of the rows above, in increasing column order (fill-in included)
+        while (not pending.empty()) {
+            const index_t k = pending.top();
+            pending.pop();
+            const double multiplier = w[k] /= values[_diag[k]];
+            if (std::abs(multiplier) < rowTol) {
+                w[k] = 0.0;
+                continue;
+            }
+            for (index_t q = _diag[k] + 1; q < pointers[k + 1]; ++q) {
+                const index_t j = indices[q];
+                if (not inRow[j]) {
+                    inRow[j] = true;
+                    w[j] = 0.0;
+                    pattern.push_back(j);
+                    if (j < i) pending.push(j);
+                }
+                w[j] -= multiplier*values[q];
+            }
+        }
+
+        // Drop the small entries, then keep the `fill` largest of each triangular part
+        lower.clear();
+        upper.clear();
+        const double pivot = inRow[i] ? w[i] : 0.0;
+        for (index_t j : pattern) {
+            if (j != i and std::abs(w[j]) >= rowTol and w[j] != 0.0) (j < i ? lower : upper).emplace_back(std::abs(w[j]), j);
+            inRow[j] = false;
+        }
+        for (auto *part : {&lower, &upper}) {
+            if (part->size() > fill) {
+                std::nth_element(part->begin(), part->begin() + fill, part->end(),
+                                 std::greater<std::pair<double, index_t>>());
+                part->resize(fill);
+            }
+            std::sort(part->begin(), part->end(),
+                      [](const std::pair<double, index_t> &a, const std::pair<double, index_t> &b) {
+                          return a.second < b.second;
+                      });
+        }
+
+        if (pivot == 0.0) return LUStatus::singularAt(i);
+        for (const auto &entry : lower) {
+            indices.push_back(entry.second);
+            values.push_back(w[entry.second]);
+        }
+        _diag[i] = indices.size();
+        indices.push_back(i);
+        values.push_back(pivot);
+        for (const auto &entry : upper) {
+            indices.push_back(entry.second);
+            values.push_back(w[entry.second]);
+        }
+        pointers.push_back(indices.size());
+    }
+
+    _LU = SparseMatrix(n, SparseLayout::CSR, std::move(pointers), std::move(indices), std::move(values));
+    return {};
+}
+
+Vector IncompleteLU::apply(const Vector &r) const {
+    const size_t n = size();
+    const auto &pointers = _LU.pointers();
+    const auto &indices = _LU.indices();
+    const auto &values = _LU.values();
+
+    Vector z(n);
+    for (index_t i = 0; i < n; ++i) {
+        double elem = r[i];
+        for (index_t p = pointers[i]; p < _diag[i]; ++p) elem -= values[p]*z[indices[p]];
+        z[i] = elem;
+    }
+    for (long i = n - 1; i >= 0; --i) {
+        double elem = z[i];
+        for (index_t p = _diag[i] + 1; p < pointers[i + 1]; ++p) elem -= values[p]*z[indices[p]];
+        z[i] = elem/values[_diag[i]];
+    }
+    return z;
+}
+
+
+//---------- Krylov solvers ----------//
+
+namespace {
+    inline double dot(const Vector &a, const Vector &b) {
+        double sum = 0.0;
+        for (index_t i = 0; i < a.size(); ++i) sum += a[i]*b[i];
+        return sum;
+    }
+
+    inline Vector precondition(const IncompleteLU *M, const Vector &v) {
+        return M ? M->apply(v) : v;
+    }
+
+    // Set up x and the norm of b; returns false if b is null (x = 0 then solves exactly)
+    bool start(const SparseMatrix &A, const Vector &b, const Vector &x0, IterativeResult &result, double &bNorm) {
+        if (b.size() != A.size() or (x0.size() != 0 and x0.size() != A.size()))
+            throw std::invalid_argument("vector and matrix size are different");
+        result.x = x0.size() != 0 ? x0 : Vector(0.0, A.size());
+        bNorm = norm2(b);
+        if (bNorm > 0.0) return true;
+        result.x = 0.0;
+        result.converged = true;
+        return false;
+    }
+
+    void finish(const SparseMatrix &A, const Vector &b, double bNorm, double tol, IterativeResult &result) {
+        result.residual = norm2(b - A*result.x)/bNorm;
+        result.converged = result.residual <= tol;
+    }
+}
+
+IterativeResult gmres(const SparseMatrix &A, const Vector &b, const IncompleteLU *M,
+                      const IterativeOptions &options, const Vector &x0) {
+    IterativeResult result;
+    double bNorm;
+    if (not start(A, b, x0, result, bNorm)) return result;
+    const size_t n = A.size();
+    const size_t m = std::max<size_t>(1, std::min(options.restart, n));
+
+    std::vector<Vector> V(m + 1, Vector(n));
+    std::vector<Vector> H(m + 1, Vector(0.0, m));  // Hessenberg matrix, reduced to upper triangular
+    Vector cs(m), sn(m), g(m + 1), y(m);
+
+    while (result.iterations < options.maxIterations) {
+        Vector r = b - A*result.x;
+        const double beta = norm2(r);
+        if (beta <= options.tol*bNorm) break;
+
+        V[0] = r/beta;
+        g = 0.0;
+        g[0] = beta;
+        size_t k = 0;  // dimension of the Krylov subspace built
+        bool done = false;
+        while (k < m and result.iterations < options.maxIterations and not done) {
+            const index_t j = k++;
+            Vector w = A*precondition(M, V[j]);
+            ++result.iterations;
+
+            // modified Gram-Schmidt
+            for (index_t i = 0; i <= j; ++i) {
+                H[i][j] = dot(w, V[i]);
+                w -= H[i][j]*V[i];
+            }
+            const double h = norm2(w);
+            if (h != 0.0) V[j + 1] = w/h;
+
+            // apply the previous rotations to the new column, then zero H[j + 1][j]
+            for (index_t i = 0; i < j; ++i) {
+                const double t = cs[i]*H[i][j] + sn[i]*H[i + 1][j];
+                H[i + 1][j] = -sn[i]*H[i][j] + cs[i]*H[i + 1][j];
+                H[i][j] = t;
+            }
+            const double denominator = std::hypot(H[j][j], h);
+            cs[j] = H[j][j]/denominator;
+            sn[j] = h/denominator;
+            H[j][j] = denominator;
+            g[j + 1] = -sn[j]*g[j];
+            g[j] *= cs[j];
+
+            done = h == 0.0 or std::abs(g[j + 1]) <= options.tol*bNorm;
+        }
+
+        // x += M^-1 V y, where H y = g
+        for (long i = long(k) - 1; i >= 0; --i) {
+            double elem = g[i];
+            for (index_t l = i + 1; l < k; ++l) elem -= H[i][l]*y[l];
+            y[i] = elem/H[i][i];
+        }
+        Vector u(0.0, n);
+        for (index_t i = 0; i < k; ++i) u += y[i]*V[i];
+        result.x += precondition(M, u);
+    }
+
+    finish(A, b, bNorm, options.tol, result);
+    return result;
+}
+
+IterativeResult bicgstab(const SparseMatrix &A, const Vector &b, const IncompleteLU *M,
+                         const IterativeOptions &options, const Vector &x0) {
+    IterativeResult result;
+    double bNorm;
+    if (not start(A, b, x0, result, bNorm)) return result;
+    const size_t n = A.size();
+
+    Vector r = b - A*result.x;
+    const Vector rHat = r;
+    Vector p(0.0, n), v(0.0, n);
+    double rho = 1.0, alpha = 1.0, omega = 1.0;
+
+    while (result.iterations < options.maxIterations and norm2(r) > options.tol*bNorm) {
+        const double rhoNew = dot(rHat, r);
+        if (rhoNew == 0.0) break;  // breakdown
+        if (result.iterations == 0) p = r;
+        else p = r + ((rhoNew/rho)*(alpha/omega))*(p - omega*v);
+        ++result.iterations;
+
+        const Vector pHat = precondition(M, p);
+        v = A*pHat;
+        const double rHatV = dot(rHat, v);
+        if (rHatV == 0.0) break;  // breakdown: the last iterate is kept
+        alpha = rhoNew/rHatV;
+        const Vector s = r - alpha*v;
+        if (norm2(s) <= options.tol*bNorm) {
+            result.x += alpha*pHat;
+            break;
+        }
+
+        const Vector sHat = precondition(M, s);
+        const Vector t = A*sHat;
+        const double tt = dot(t, t);
+        if (tt == 0.0) {  // breakdown: keep the half step
+            result.x += alpha*pHat;
+            break;
+        }
+        omega = dot(t, s)/tt;
+        result.x += alpha*pHat + omega*sHat;
+        r = s - omega*t;
+        rho = rhoNew;
+        if (omega == 0.0) break;  // breakdown
+    }
+
+    finish(A, b, bNorm, options.tol, result);
+    return result;
+}
+
+LUStatus factorPreconditioner(IncompleteLU &M, const SparseMatrix &A, const IterativeOptions &options) {
+    switch (options.preconditioner) {
+        case Preconditioner::None: return {};
+        case Preconditioner::ILU0: return M.factorILU0(A);
+        case Preconditioner::ILUT: return M.factorILUT(A, options.dropTol, options.fill);
+    }
+    throw ValueError("unknown preconditioner");
+}
+
+IterativeResult solveIterative(const SparseMatrix &A, const Vector &b, const IncompleteLU *M,
+                               const IterativeOptions &options) {
+    switch (options.method) {
+        case IterativeMethod::GMRES: return gmres(A, b, M, options);
+        case IterativeMethod::BiCGSTAB: return bicgstab(A, b, M, options);
+    }
+    throw ValueError("unknown iterative method");
+}
+
+IterativeResult solveIterative(const SparseMatrix &A, const Vector &b, const IterativeOptions &options) {
+    IncompleteLU M;
+    const LUStatus status = factorPreconditioner(M, A, options);
+    if (not status)
+        throw SingularMatrixError(0.0, "in the incomplete factorization at pivot " + std::to_string(status.pivot));
+    return solveIterative(A, b, options.preconditioner == Preconditioner::None ? nullptr : &M, options);
+}
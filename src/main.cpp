@@ -1,22 +1,25 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
 #include <iostream>
+#include <mutex>
 #include <numeric>
+#include <vector>
 #include <LUDecomposition.h>
 #include <norm.h>
 #include <resol.h>
 #include "io.h"
+#include "errors.h"
+#include "ThreadPool.h"
+#include "pipeline.h"
+#include "stream.h"
 
 
 inline
-void printError(const char *message, const char *arg = nullptr) {
-    std::cerr << "error: " << message;
-    if (arg) std::cerr << ' ' << arg;
-    std::cerr << '\n';
-}
-
-inline
-void handleArg(const char *arg) {
-    auto oName = solveFile(arg);
-    std::cout << "written solution of " << arg << " to " << oName << std::endl;
+void handleArg(const SolveTask &task, const IterativeOptions *iterative) {
+    auto oName = solveFile(task.path, task.format, iterative, task.solver);
+    std::cout << "written solution of " << task.path << " to " << oName << std::endl;
 }
 
 inline void handleArg2(const char *arg) {
@@ -36,14 +39,212 @@ inline void handleArg2(const char *arg) {
     printColumns(outFile, eps, results);
 }
 
+//---------- batch mode ----------//
+
+/// Estimated cost of solving a file: factorization and inverse dominate (O(n^3)), then parsing (O(m))
+double estimateCost(const char *path) {
+    try {
+        size_t n, m;
+        peekDimensions(MappedFile(path), n, m);
+        return double(n)*double(n)*double(n) + double(m);
+    } catch (std::exception &) {
+        return 0.0;  // errors get reported when the file is actually processed
+    }
+}
+
+/// Sort tasks by decreasing estimated cost
+void sortLargestFirst(std::vector<SolveTask> &tasks) {
+    std::vector<std::pair<double, SolveTask>> costs;
+    for (const SolveTask &task : tasks) costs.push_back({estimateCost(task.path), task});
+    std::stable_sort(costs.begin(), costs.end(),
+                     [](const std::pair<double, SolveTask> &lhs, const std::pair<double, SolveTask> &rhs) {
+                         return lhs.first > rhs.first;
+                     });
+    for (index_t k = 0; k < tasks.size(); ++k) tasks[k] = costs[k].second;
+}
+
+/**
+ * Solve files concurrently on the shared thread pool, largest first (the pool hands
+ * out indices in increasing order). Messages are printed as files complete.
+ */
+void solveBatch(std::vector<SolveTask> &tasks, const IterativeOptions *iterative) {
+    sortLargestFirst(tasks);
+
+    std::mutex outputMutex;
+    parallelFor(tasks.size(), [&](index_t k) {
+        const SolveTask &task = tasks[k];
+        try {
+            auto oName = solveFile(task.path, task.format, iterative, task.solver);
+            std::lock_guard<std::mutex> lock(outputMutex);
+            std::cout << "written solution of " << task.path << " to " << oName << std::endl;
+        } catch (std::exception &e) {
+            std::lock_guard<std::mutex> lock(outputMutex);
+            printError(e.what());
+        }
+    });
+}
+
+
+/**
+ * Solve files through the staged pipeline (see pipeline.h), largest first,
+ * and print each stage's occupancy to stderr at the end.
+ */
+void solvePipelined(std::vector<SolveTask> &tasks, const PipelineOptions &options) {
+    sortLargestFirst(tasks);
+
+    auto stats = runPipeline(tasks, options, [](const char *path, const std::string &outName, const char *error) {
+        if (error) printError(error);
+        else std::cout << "written solution of " << path << " to " << outName << std::endl;
+    });
+
+    for (const StageStats &stage : stats) {
+        std::cerr << "stage " << stage.name << ": " << stage.items << " files, " << stage.workers
+                  << " worker(s), " << std::fixed << std::setprecision(1) << 100*stage.occupancy
+                  << "% occupancy, at most " << stage.maxQueued << " queued\n";
+    }
+}
+
+
+/**
+ * Factor the matrix of a system file once, then answer right-hand sides read
+ * from stdin with solutions written to stdout (see streamSolve).
+ */
+int solveStream(const char *matrixPath, OutputFormat format) {
+    std::ios::sync_with_stdio(false);
+    try {
+        MappedFile file(matrixPath);
+        Matrix A;
+        Vector b;  // ignored
+        readSystem(file, A, b);
+        LUDecomposition luObj(A);
+        streamSolve(luObj, std::cin, std::cout, format);
+        return 0;
+    } catch (std::exception &e) {
+        printError(e.what());
+        return 1;
+    }
+}
+
+
 //---------- main ----------//
 
+/// Parse a --format=... option; returns false if `arg` isn't one
+bool parseFormat(const char *arg, OutputFormat &format) {
+    static const char prefix[] = "--format=";
+    if (std::strncmp(arg, prefix, sizeof prefix - 1) != 0) return false;
+    const char *name = arg + sizeof prefix - 1;
+    if (std::strcmp(name, "text") == 0) format = OutputFormat::Text;
+    else if (std::strcmp(name, "csv") == 0) format = OutputFormat::CSV;
+    else if (std::strcmp(name, "binary") == 0) format = OutputFormat::Binary;
+    else throw ValueError("unknown output format (expected text, csv or binary)");
+    return true;
+}
+
+/// Parse a --<name>=N option with positive N; returns false if `arg` isn't one
+bool parsePositive(const char *arg, const char *name, size_t &value) {
+    const size_t length = std::strlen(name);
+    if (std::strncmp(arg, "--", 2) != 0 or std::strncmp(arg + 2, name, length) != 0 or arg[2 + length] != '=')
+        return false;
+    char *end;
+    long long parsed = std::strtoll(arg + 3 + length, &end, 10);
+    if (*end != '\0' or parsed < 1) throw ValueError((std::string("--") + name + " expects a positive integer").c_str());
+    value = size_t(parsed);
+    return true;
+}
+
+/// Parse a --<name>=X option with positive X; returns false if `arg` isn't one
+bool parsePositive(const char *arg, const char *name, double &value) {
+    const size_t length = std::strlen(name);
+    if (std::strncmp(arg, "--", 2) != 0 or std::strncmp(arg + 2, name, length) != 0 or arg[2 + length] != '=')
+        return false;
+    char *end;
+    value = std::strtod(arg + 3 + length, &end);
+    if (*end != '\0' or not(value > 0)) throw ValueError((std::string("--") + name + " expects a positive number").c_str());
+    return true;
+}
+
+/// Parse the options of the iterative mode (--iterative=..., --precond=..., --tol=..., --maxit=..., --restart=...);
+/// returns false if `arg` isn't one
+bool parseIterative(const char *arg, IterativeOptions &options, bool &iterative) {
+    static const char methodPrefix[] = "--iterative=", precondPrefix[] = "--precond=";
+    if (std::strncmp(arg, methodPrefix, sizeof methodPrefix - 1) == 0) {
+        const char *name = arg + sizeof methodPrefix - 1;
+        if (std::strcmp(name, "gmres") == 0) options.method = IterativeMethod::GMRES;
+        else if (std::strcmp(name, "bicgstab") == 0) options.method = IterativeMethod::BiCGSTAB;
+        else throw ValueError("unknown iterative method (expected gmres or bicgstab)");
+        iterative = true;
+        return true;
+    }
+    if (std::strncmp(arg, precondPrefix, sizeof precondPrefix - 1) == 0) {
+        const char *name = arg + sizeof precondPrefix - 1;
+        if (std::strcmp(name, "none") == 0) options.preconditioner = Preconditioner::None;
+        else if (std::strcmp(name, "ilu0") == 0) options.preconditioner = Preconditioner::ILU0;
+        else if (std::strcmp(name, "ilut") == 0) options.preconditioner = Preconditioner::ILUT;
+        else throw ValueError("unknown preconditioner (expected none, ilu0 or ilut)");
+        return true;
+    }
+    return parsePositive(arg, "tol", options.tol) or parsePositive(arg, "maxit", options.maxIterations)
+           or parsePositive(arg, "restart", options.restart);
+}
+
 int main(int argc, char *argv[]) {
-    if (argc <= 1) std::cout << "no files to process" << std::endl;
+    OutputFormat format = OutputFormat::Text;
+    size_t jobs = 1, budgetMB = 0;
+    bool pipelined = false, streaming = false, iterative = false, generalLU = false;
+    IterativeOptions iterativeOptions;
+    const char *factorPath = nullptr;
+    std::vector<SolveTask> tasks;
     for (int i = 1; i < argc; ++i) {
-        try { handleArg(argv[i]); }
+        try {
+            if (std::strcmp(argv[i], "--pipeline") == 0) pipelined = true;
+            else if (std::strcmp(argv[i], "--general-lu") == 0) generalLU = true;
+            else if (std::strcmp(argv[i], "--stream") == 0) streaming = true;
+            else if (std::strcmp(argv[i], "--factor") == 0 and i + 1 < argc) factorPath = argv[++i];
+            else if (std::strncmp(argv[i], "--factor=", 9) == 0) factorPath = argv[i] + 9;
+            else if (not parseFormat(argv[i], format) and not parsePositive(argv[i], "jobs", jobs)
+                     and not parsePositive(argv[i], "budget", budgetMB)
+                     and not parseIterative(argv[i], iterativeOptions, iterative))
+                tasks.push_back({argv[i], format, SolverChoice::Auto});
+        }
         catch (std::exception &e) { printError(e.what()); }
     }
-}
+    if (generalLU)
+        for (SolveTask &task : tasks) task.solver = SolverChoice::GeneralLU;
+
+    if (streaming or factorPath) {
+        if (not streaming or not factorPath or not tasks.empty()) {
+            printError("streaming mode takes exactly --factor <matrix file> --stream");
+            return 1;
+        }
+        return solveStream(factorPath, format);
+    }
+
+    if (tasks.empty()) std::cout << "no files to process" << std::endl;
+    const IterativeOptions *iterativeMode = iterative ? &iterativeOptions : nullptr;
+
+    if (pipelined) {
+        if (iterative) {
+            printError("the pipeline only supports direct solves (drop --iterative)");
+            return 1;
+        }
+        PipelineOptions options;
+        options.factorWorkers = unsigned(jobs);  // the other stages run on threads of their own
+        if (budgetMB) options.memoryBudget = budgetMB << 20;
+        ThreadPool::configureShared(unsigned(jobs) - 1);  // for the parallel parser
+        solvePipelined(tasks, options);
+        return 0;
+    }
 
+    if (jobs > 1) {
+        // The calling thread works too, so this caps the total thread count at `jobs`
+        // (also counting the parallelism inside each file's processing).
+        ThreadPool::configureShared(unsigned(jobs) - 1);
+        solveBatch(tasks, iterativeMode);
+        return 0;
+    }
 
+    for (const SolveTask &task : tasks) {
+        try { handleArg(task, iterativeMode); }
+        catch (std::exception &e) { printError(e.what()); }
+    }
+}
@@ -0,0 +1,73 @@
+/// @file
+/// Converter from text (.DAT) system files to the binary format (see binary.h)
+
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include "binary.h"
+#include "errors.h"
+#include "io.h"
+
+
+/// Output path: the input path with its extension replaced by .BIN
+std::string getBinaryName(const std::string &iname) {
+    size_t slash = iname.find_last_of("/\\");
+    size_t dot = iname.find_last_of('.');
+    if (dot == std::string::npos or (slash != std::string::npos and dot < slash)) dot = iname.size();
+    return iname.substr(0, dot) + ".BIN";
+}
+
+/// Convert one file, choosing the smallest layout unless one is forced
+std::string convertFile(const char *path, const char *layoutOption) {
+    MappedFile inputFile(path);
+    if (isBinary(inputFile)) throw ValueError("file is already in binary format");
+    Matrix A;
+    std::vector<Vector> bs;
+    readSystem(inputFile, A, bs);
+
+    const size_t n = A.size();
+    size_t nnz = 0;
+    for (index_t i = 0; i < n; ++i)
+        for (index_t j = 0; j < n; ++j) nnz += A[i][j] != 0.0;
+
+    BinaryLayout layout = nnz*sizeof(BinaryTriplet) < n*n*sizeof(double)
+                          ? BinaryLayout::Triplets : BinaryLayout::Dense;
+    if (layoutOption and std::strcmp(layoutOption, "--dense") == 0) layout = BinaryLayout::Dense;
+    if (layoutOption and std::strcmp(layoutOption, "--triplets") == 0) layout = BinaryLayout::Triplets;
+
+    std::string oname = getBinaryName(path);
+    std::ofstream outFile(oname, std::ios::binary);
+    if (not outFile.is_open()) throw IOError(oname.c_str());
+    writeBinaryMatrix(outFile, A, layout);
+    for (const Vector &b : bs) writeBinaryVector(outFile, b, layout);
+    return oname;
+}
+
+//---------- main ----------//
+
+int main(int argc, char *argv[]) {
+    const char *const usage = "usage: convert.x [--dense | --triplets] FILE.DAT...";
+    const char *layoutOption = nullptr;
+    int status = 0;
+    if (argc <= 1) std::cout << usage << std::endl;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--", 2) == 0) {
+            if (std::strcmp(argv[i], "--dense") != 0 and std::strcmp(argv[i], "--triplets") != 0) {
+                printError("unknown option", argv[i]);
+                std::cerr << usage << std::endl;
+                return 1;
+            }
+            layoutOption = argv[i];
+            continue;
+        }
+        try {
+            auto oName = convertFile(argv[i], layoutOption);
+            std::cout << "converted " << argv[i] << " to " << oName << std::endl;
+        } catch (std::exception &e) {
+            printError(e.what(), argv[i]);
+            status = 1;
+        }
+    }
+    return status;
+}
@@ -8,6 +8,7 @@
 #include <functional>
 #include "errors.h"
 #include "inverse.h"
+#include "resol.h"
 
 
 VectorNorm getVectorNorm(NormType nt) {
@@ -65,6 +66,14 @@ double normInf(const Matrix &A) {
     return maxSum;
 }
 
+double norm(const SparseMatrix &A, NormType nt) {
+    switch (nt) {
+        case NormType::L1: return norm1(A);
+        case NormType::Inf: return normInf(A);
+        default: throw ValueError("unknown matrix norm");
+    }
+}
+
 double conditionNumber(const Matrix &A, const Matrix &AInv, NormType nt) {
     auto matNorm = getMatrixNorm(nt);
     return matNorm(A)*matNorm(AInv);
@@ -77,3 +86,137 @@ double conditionNumber(const Matrix &A, const LUDecomposition &luObj, NormType n
 double conditionNumber(const Matrix &A, NormType nt) {
     return conditionNumber(A, LUDecomposition(A), nt);
 }
+
+double conditionNumber(const SparseMatrix &A, const LUDecomposition &luObj, NormType nt) {
+    return norm(A, nt)*norm(inverse(luObj), nt);
+}
+
+namespace {
+    // ||A^-1||_1 of an n by n matrix A, given the solvers of Ax = b and A^T x = b
+    template<typename SolveA, typename SolveAT>
+    double inverseNorm1(size_t n, SolveA solveA, SolveAT solveAT) {
+        if (n == 0) return 0.0;
+
+        if (n <= EXACT_INVERSE_NORM_MAX_SIZE) {
+            // max column absolute sum, one column of the inverse at a time
+            double maxSum = 0.0;
+            Vector e(0.0, n);
+            for (index_t j = 0; j < n; ++j) {
+                e[j] = 1.0;
+                maxSum = std::max(maxSum, norm1(solveA(e)));
+                e[j] = 0.0;
+            }
+            return maxSum;
+        }
+
+        Vector x(1.0/double(n), n);
+        double estimate = 0.0;
+        for (int iteration = 0; iteration < 5; ++iteration) {
+            const Vector y = solveA(x);
+            const double newEstimate = norm1(y);
+            if (iteration > 0 and newEstimate <= estimate) break;
+            estimate = newEstimate;
+
+            Vector signs(n);
+            for (index_t i = 0; i < n; ++i) signs[i] = y[i] >= 0.0 ? 1.0 : -1.0;
+            const Vector z = solveAT(signs);
+            index_t jMax = 0;
+            for (index_t j = 1; j < n; ++j)
+                if (std::abs(z[j]) > std::abs(z[jMax])) jMax = j;
+            if (iteration > 0 and std::abs(z[jMax]) <= (z*x).sum()) break;
+            x = 0.0;
+            x[jMax] = 1.0;
+        }
+
+        // Higham's alternative estimate, to guard against unlucky starting vectors
+        Vector alt(n);
+        for (index_t i = 0; i < n; ++i)
+            alt[i] = (i%2 == 0 ? 1.0 : -1.0)*(1.0 + double(i)/double(n - 1));
+        const double altEstimate = 2.0*norm1(solveA(alt))/(3.0*double(n));
+        return std::max(estimate, altEstimate);
+    }
+
+    // ||A^-1||_1 if transposed is false, ||A^-T||_1 = ||A^-1||_Inf otherwise
+    template<typename Decomposition>
+    double inverseNorm1(const Decomposition &luObj, bool transposed) {
+        auto solveA = [&](const Vector &b) {
+            return transposed ? solveLUTransposed(luObj, b) : solveLU(luObj, b);
+        };
+        auto solveAT = [&](const Vector &b) {
+            return transposed ? solveLU(luObj, b) : solveLUTransposed(luObj, b);
+        };
+        return inverseNorm1(luObj.size(), solveA, solveAT);
+    }
+
+    template<typename Decomposition>
+    double decompositionInverseNorm(const Decomposition &luObj, NormType nt) {
+        switch (nt) {
+            case NormType::L1: return inverseNorm1(luObj, false);
+            case NormType::Inf: return inverseNorm1(luObj, true);
+            default: throw ValueError("unknown matrix norm");
+        }
+    }
+}
+
+double inverseNorm(const SparseLUDecomposition &luObj, NormType nt) {
+    return decompositionInverseNorm(luObj, nt);
+}
+
+double conditionNumber(const SparseMatrix &A, const SparseLUDecomposition &luObj, NormType nt) {
+    return norm(A, nt)*inverseNorm(luObj, nt);
+}
+
+double inverseNorm(const BTFDecomposition &luObj, NormType nt) {
+    return decompositionInverseNorm(luObj, nt);
+}
+
+double inverseNorm(const BandLUDecomposition &luObj, NormType nt) {
+    return decompositionInverseNorm(luObj, nt);
+}
+
+double inverseNorm(const TridiagonalLUDecomposition &luObj, NormType nt) {
+    return decompositionInverseNorm(luObj, nt);
+}
+
+double inverseNorm(const BlockTridiagonalLUDecomposition &luObj, NormType nt) {
+    return decompositionInverseNorm(luObj, nt);
+}
+
+double inverseNorm(const SchurComplementDecomposition &schurObj, NormType nt) {
+    return decompositionInverseNorm(schurObj, nt);
+}
+
+double inverseNorm(const UpdatedLU &luObj, NormType nt) {
+    return decompositionInverseNorm(luObj, nt);
+}
+
+double inverseNorm(const ToeplitzDecomposition &toepObj, NormType nt) {
+    return decompositionInverseNorm(toepObj, nt);
+}
+
+double inverseNorm(const SkylineLUDecomposition &luObj, NormType nt) {
+    return decompositionInverseNorm(luObj, nt);
+}
+
+double inverseNorm(const SkylineLDLTDecomposition &ldlObj, NormType nt) {
+    if (nt != NormType::L1 and nt != NormType::Inf) throw ValueError("unknown matrix norm");
+    // A^-1 is symmetric: both norms are the same
+    auto solveA = [&](const Vector &b) { return solveLDLT(ldlObj, b); };
+    return inverseNorm1(ldlObj.size(), solveA, solveA);
+}
+
+double inverseNorm(const CholeskyDecomposition &cholObj, NormType nt) {
+    if (nt != NormType::L1 and nt != NormType::Inf) throw ValueError("unknown matrix norm");
+    auto solveA = [&](const Vector &b) { return solveCholesky(cholObj, b); };
+    return inverseNorm1(cholObj.size(), solveA, solveA);
+}
+
+double inverseNorm(const LDLTDecomposition &ldlObj, NormType nt) {
+    if (nt != NormType::L1 and nt != NormType::Inf) throw ValueError("unknown matrix norm");
+    auto solveA = [&](const Vector &b) { return solveLDLT(ldlObj, b); };
+    return inverseNorm1(ldlObj.size(), solveA, solveA);
+}
+
+double inverseNorm(const TriangularDecomposition &triObj, NormType nt) {
+    return decompositionInverseNorm(triObj, nt);
+}
@@ -6,7 +6,6 @@
 
 #include "Matrix.h"
 #include "LUDecomposition.h"
-#include "errors.h"
 
 void copy(const Matrix &mat, double **a) {
     const size_t n = mat.size();
@@ -16,15 +15,15 @@ void copy(const Matrix &mat, double **a) {
 }
 
 int lu(double **a, int n, int perm[], double tol) {
-    try {
-        LUDecomposition luObj(Matrix{a, size_t(n)}, tol);
-        const auto &luPerm = luObj.perm();
-        copy(luObj.decompMatrix(), a);
-        std::copy(begin(luPerm.vector()), end(luPerm.vector()), perm);
-        return (luPerm.parity() ? -1 : 1);
-    } catch (SingularMatrixError &) {
+    LUDecomposition luObj;
+    if (not luObj.tryFactor(Matrix{a, size_t(n)}, tol)) {
         freemat(a, n);
         return 0;
     }
+
+    const auto &luPerm = luObj.perm();
+    copy(luObj.decompMatrix(), a);
+    std::copy(begin(luPerm.vector()), end(luPerm.vector()), perm);
+    return (luPerm.parity() ? -1 : 1);
 }
 
@@ -0,0 +1,201 @@
+#include "pipeline.h"
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <thread>
+#include "BoundedQueue.h"
+#include "MappedFile.h"
+#include "errors.h"
+#include "io.h"
+#include "sistema.h"
+
+
+namespace {
+
+    typedef std::chrono::steady_clock Clock;
+
+    /// Counting semaphore over bytes of memory
+    class MemoryBudget {
+    public:
+        explicit MemoryBudget(size_t limit) : _limit(limit) {}
+
+        /// Block until `bytes` fit in the budget (or nothing else is in flight)
+        void acquire(size_t bytes) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cv.wait(lock, [&] { return _used == 0 or _used + bytes <= _limit; });
+            _used += bytes;
+        }
+
+        void release(size_t bytes) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _used -= bytes;
+            _cv.notify_all();
+        }
+
+    private:
+        const size_t _limit;
+        size_t _used = 0;
+        std::mutex _mutex;
+        std::condition_variable _cv;
+    };
+
+    /// A file travelling through the pipeline
+    struct Item {
+        SolveTask task;
+        index_t index = 0;  ///< position in the task list
+        size_t bytes = 0;  ///< reserved from the memory budget
+        Matrix A;
+        std::vector<Vector> bs;  ///< right-hand sides
+        std::unique_ptr<SolveResult> result;
+        ExtraSolveInfo info = {};
+        std::string outName;  ///< solution file name
+        std::string error;  ///< non-empty if some stage failed
+    };
+
+    typedef std::unique_ptr<Item> ItemPtr;
+    typedef BoundedQueue<ItemPtr> Queue;
+
+    /// Memory needed by a system of dimension n (matrix, LU copy and inverse for the metrics)
+    size_t estimateBytes(size_t n) {
+        return 3*n*n*sizeof(double) + 4*n*sizeof(double);
+    }
+
+    /// Bookkeeping of a stage's workers
+    struct Stage {
+        const char *name;
+        unsigned workers;
+        std::atomic<size_t> items{0};
+        std::atomic<long long> busyNanos{0};
+        std::atomic<unsigned> running{0};
+
+        Stage(const char *name, unsigned workers) : name(name), workers(workers ? workers : 1) {}
+
+        /**
+         * Start this stage's workers: each one runs process(item) on the items popped
+         * from `in` (unless an earlier stage failed on them), then finish(item) in any
+         * case, and forwards them to `out` (if any).
+         */
+        template<typename Process, typename Finish>
+        void launch(std::vector<std::thread> &threads, Queue &in, Queue *out, Process process, Finish finish) {
+            running = workers;
+            for (unsigned k = 0; k < workers; ++k)
+                threads.emplace_back([this, &in, out, process, finish]() {
+                    ItemPtr item;
+                    while (in.pop(item)) {
+                        handle(*item, process, finish);
+                        if (out) out->push(std::move(item));
+                    }
+                    if (--running == 0 and out) out->close();  // the last worker out closes the door
+                });
+        }
+
+        /**
+         * Like launch, for a last stage with a single worker taking the items in the order of
+         * their index: those popped early wait in a reorder buffer until their turn.
+         */
+        template<typename Process, typename Finish>
+        void launchInOrder(std::vector<std::thread> &threads, Queue &in, Process process, Finish finish) {
+            workers = running = 1;
+            threads.emplace_back([this, &in, process, finish]() {
+                std::map<index_t, ItemPtr> early;
+                index_t next = 0;
+                ItemPtr item;
+                while (in.pop(item)) {
+                    early.emplace(item->index, std::move(item));
+                    for (auto it = early.begin(); it != early.end() and it->first == next; ++next) {
+                        handle(*it->second, process, finish);
+                        it = early.erase(it);
+                    }
+                }
+                running = 0;
+            });
+        }
+
+        template<typename Process>
+        void launch(std::vector<std::thread> &threads, Queue &in, Queue *out, Process process) {
+            launch(threads, in, out, process, [](Item &) {});
+        }
+
+    private:
+        /// process(item) (unless an earlier stage failed on it) and finish(item), timed
+        template<typename Process, typename Finish>
+        void handle(Item &item, const Process &process, const Finish &finish) {
+            auto start = Clock::now();
+            if (item.error.empty()) {
+                try { process(item); }
+                catch (std::exception &e) { item.error = e.what(); }
+            }
+            busyNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+            ++items;
+            finish(item);
+        }
+    };
+
+}
+
+
+std::vector<StageStats> runPipeline(const std::vector<SolveTask> &tasks, const PipelineOptions &options,
+                                    const PipelineReport &report) {
+    MemoryBudget budget(options.memoryBudget);
+    Queue toParse(tasks.size() + 1), toFactor(options.queueCapacity),
+            toMetrics(options.queueCapacity), toWrite(options.queueCapacity);
+
+    Stage parse("parse", 1), factor("factor", options.factorWorkers),
+            metrics("metrics", options.metricsWorkers), write("write", 1);
+
+    auto wallStart = Clock::now();
+    std::vector<std::thread> threads;
+
+    parse.launch(threads, toParse, &toFactor, [&budget](Item &item) {
+        MappedFile file(item.task.path);
+        size_t n, m;
+        peekDimensions(file, n, m);
+        item.bytes = estimateBytes(n);
+        budget.acquire(item.bytes);
+        readSystem(file, item.A, item.bs);
+    });
+
+    factor.launch(threads, toFactor, &toMetrics, [](Item &item) {
+        item.result.reset(new SolveResult(solve(item.A, item.bs, numcomp::DEFAULT_TOL, item.task.solver)));
+        if (not *item.result)
+            throw SingularMatrixError(item.result->tol(),
+                                      "at pivot " + std::to_string(item.result->status().pivot));
+    });
+
+    metrics.launch(threads, toMetrics, &toWrite, [](Item &item) {
+        item.info = getExtraSolveInfo(item.A, item.bs, *item.result);
+        item.A = Matrix();  // not needed anymore
+    });
+
+    write.launchInOrder(threads, toWrite, [](Item &item) {
+        item.outName = writeSolution(item.task.path, *item.result, item.info, item.task.format);
+    }, [&budget, &report](Item &item) {
+        budget.release(item.bytes);
+        item.result.reset();
+        item.bs.clear();
+        report(item.task.path, item.outName, item.error.empty() ? nullptr : item.error.c_str());
+    });
+
+    for (index_t k = 0; k < tasks.size(); ++k) {
+        ItemPtr item(new Item);
+        item->task = tasks[k];
+        item->index = k;
+        toParse.push(std::move(item));
+    }
+    toParse.close();
+    for (auto &thread : threads) thread.join();
+
+    const double wallSeconds = std::chrono::duration<double>(Clock::now() - wallStart).count();
+    std::vector<StageStats> stats;
+    Queue *queues[] = {&toParse, &toFactor, &toMetrics, &toWrite};
+    Stage *stages[] = {&parse, &factor, &metrics, &write};
+    for (index_t k = 0; k < 4; ++k) {
+        const Stage &stage = *stages[k];
+        double busy = double(stage.busyNanos)*1e-9;
+        stats.push_back({stage.name, stage.workers, stage.items, busy,
+                         wallSeconds > 0 ? busy/(stage.workers*wallSeconds) : 0.0, queues[k]->maxSize()});
+    }
+    return stats;
+}
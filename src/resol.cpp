@@ -1,5 +1,10 @@
 #include "resol.h"
 
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include "ThreadPool.h"
+
 
 //---------- IMPLEMENTATION ----------//
 
@@ -7,10 +12,14 @@
 Vector solveLower(const Matrix &L, const Vector &b, const Permutation::Vector &perm) {
     const size_t n = L.size();
 
-    Vector y(n);
-    for (index_t i = 0; i < n; ++i) {
+    // y is zero up to the first non-zero entry of the permuted b (e.g. for b = e_k)
+    index_t first = 0;
+    while (first < n and b[perm[first]] == 0.0) ++first;
+
+    Vector y(0.0, n);
+    for (index_t i = first; i < n; ++i) {
         double &elem = y[i] = b[perm[i]];
-        for (index_t j = 0; j < i; ++j) elem -= L[i][j]*y[j];
+        for (index_t j = first; j < i; ++j) elem -= L[i][j]*y[j];
     }
 
     return y;
@@ -41,6 +50,895 @@ Vector solveLU(const LUDecomposition &luObj, const Vector &b) {
     return solveUpper(decompMat, y);
 }
 
+Vector solveLUTransposed(const LUDecomposition &luObj, const Vector &b) {
+    // A^T = U^T L^T P
+    const Matrix &LU = luObj.decompMatrix();
+    const auto &perm = luObj.perm().vector();
+    const size_t n = LU.size();
+    if (b.size() != n) throw std::invalid_argument("vector and matrix size are different");
+
+    // U^T w = b
+    Vector w(n);
+    for (index_t i = 0; i < n; ++i) {
+        double elem = b[i];
+        for (index_t j = 0; j < i; ++j) elem -= LU[j][i]*w[j];
+        w[i] = elem/LU[i][i];
+    }
+
+    // L^T v = w
+    for (long i = n - 1; i >= 0; --i)
+        for (index_t j = i + 1; j < n; ++j) w[i] -= LU[j][i]*w[j];
+
+    Vector x(n);
+    for (index_t i = 0; i < n; ++i) x[perm[i]] = w[i];
+    return x;
+}
+
+namespace {
+    /// Number of right-hand sides substituted together
+    constexpr size_t RHS_BLOCK = 32;
+
+    // Forward and backward substitution on the k right-hand sides stored
+    // interleaved in Y (row-major, n x k): Y[i*k + r] is the i-th entry of the r-th vector
+    void solveBlock(const Matrix &LU, double *Y, size_t k) {
+        const size_t n = LU.size();
+
+        // skip the leading rows where every right-hand side is zero
+        index_t first = 0;
+        while (first < n and std::all_of(Y + first*k, Y + (first + 1)*k, [](double y) { return y == 0.0; })) ++first;
+
+        for (index_t i = first; i < n; ++i) {
+            double *yi = Y + i*k;
+            const double *row = &LU[i][0];
+            for (index_t j = first; j < i; ++j) {
+                const double l = row[j];
+                if (l == 0.0) continue;
+                const double *yj = Y + j*k;
+                for (index_t r = 0; r < k; ++r) yi[r] -= l*yj[r];
+            }
+        }
+
+        for (long i = n - 1; i >= 0; --i) {
+            double *xi = Y + i*k;
+            const double *row = &LU[i][0];
+            for (index_t j = i + 1; j < n; ++j) {
+                const double u = row[j];
+                if (u == 0.0) continue;
+                const double *xj = Y + j*k;
+                for (index_t r = 0; r < k; ++r) xi[r] -= u*xj[r];
+            }
+            const double d = row[i];
+            for (index_t r = 0; r < k; ++r) xi[r] /= d;
+        }
+    }
+}
+
+std::vector<Vector> solveLU(const LUDecomposition &luObj, const std::vector<Vector> &bs) {
+    const Matrix &decompMat = luObj.decompMatrix();
+    const auto &perm = luObj.perm().vector();
+    const size_t n = decompMat.size();
+    for (const auto &b : bs)
+        if (b.size() != n) throw std::invalid_argument("vector and matrix size are different");
+
+    std::vector<Vector> xs(bs.size());
+    if (bs.size() == 1) {
+        xs.front() = solveLU(luObj, bs.front());
+        return xs;
+    }
+
+    std::vector<double> Y;
+    for (index_t first = 0; first < bs.size(); first += RHS_BLOCK) {
+        const size_t k = std::min(RHS_BLOCK, bs.size() - first);
+        Y.assign(n*k, 0.0);
+        for (index_t i = 0; i < n; ++i)
+            for (index_t r = 0; r < k; ++r) Y[i*k + r] = bs[first + r][perm[i]];
+
+        solveBlock(decompMat, Y.data(), k);
+
+        for (index_t r = 0; r < k; ++r) {
+            Vector &x = xs[first + r];
+            x.resize(n);
+            for (index_t i = 0; i < n; ++i) x[i] = Y[i*k + r];
+        }
+    }
+    return xs;
+}
+
+
+namespace {
+    /**
+     * Non-zero pattern of the solution of T y = b, where T is a triangular factor in CSC layout
+     * (unit lower with the diagonal first, or upper with the diagonal last) and `pattern` holds
+     * the non-zero entries of b on input: these are the nodes reachable from them in the graph
+     * of T. On output, `pattern` is sorted in substitution order (increasing for L, decreasing
+     * for U), so that the result is the same as that of a full column sweep. `mark` is a
+     * workspace of T.size() flags, all false on input and again on output (only the entries in
+     * `pattern` are touched), so that both substitutions can share it.
+     */
+    void reach(const SparseMatrix &T, bool lower, std::vector<index_t> &pattern, std::vector<bool> &mark) {
+        for (index_t j : pattern) mark[j] = true;
+        std::vector<index_t> stack = pattern;
+        while (not stack.empty()) {
+            const index_t j = stack.back();
+            stack.pop_back();
+            const index_t begin = T.pointers()[j] + lower, end = T.pointers()[j + 1] - not lower;
+            for (index_t p = begin; p < end; ++p) {
+                const index_t i = T.indices()[p];
+                if (mark[i]) continue;
+                mark[i] = true;
+                pattern.push_back(i);
+                stack.push_back(i);
+            }
+        }
+        for (index_t j : pattern) mark[j] = false;
+        if (lower) std::sort(pattern.begin(), pattern.end());
+        else std::sort(pattern.begin(), pattern.end(), std::greater<index_t>());
+    }
+}
+
+Vector solveLU(const SparseLUDecomposition &luObj, const Vector &b) {
+    const size_t n = luObj.size();
+    if (b.size() != n) throw std::invalid_argument("vector and matrix size are different");
+    const SparseMatrix &L = luObj.lower(), &U = luObj.upper();
+    const auto &rowPerm = luObj.rowPerm();
+    const auto &colPerm = luObj.colPerm();
+
+    Vector y(n);
+    std::vector<index_t> pattern;
+    for (index_t k = 0; k < n; ++k)
+        if ((y[k] = b[rowPerm[k]]) != 0.0) pattern.push_back(k);
+
+    if (double(pattern.size()) <= SPARSE_RHS_MAX_DENSITY*double(n)) {
+        // Few non-zeros (e.g. b = e_k): only visit the columns reachable from them
+        std::vector<bool> mark(n, false);
+        reach(L, true, pattern, mark);
+        for (index_t j : pattern) {
+            const double yj = y[j];
+            if (yj == 0.0) continue;
+            for (index_t p = L.pointers()[j] + 1; p < L.pointers()[j + 1]; ++p)
+                y[L.indices()[p]] -= L.values()[p]*yj;
+        }
+
+        reach(U, false, pattern, mark);
+        for (index_t j : pattern) {
+            const index_t last = U.pointers()[j + 1] - 1;
+            const double zj = y[j] /= U.values()[last];
+            if (zj == 0.0) continue;
+            for (index_t p = U.pointers()[j]; p < last; ++p)
+                y[U.indices()[p]] -= U.values()[p]*zj;
+        }
+
+        Vector x(0.0, n);
+        for (index_t k : pattern) x[colPerm[k]] = y[k];
+        return x;
+    }
+
+    // Ly = Pb, column by column (the unit diagonal comes first)
+    for (index_t j = 0; j < n; ++j) {
+        const double yj = y[j];
+        if (yj == 0.0) continue;
+        for (index_t p = L.pointers()[j] + 1; p < L.pointers()[j + 1]; ++p)
+            y[L.indices()[p]] -= L.values()[p]*yj;
+    }
+
+    // Uz = y, column by column (the diagonal comes last)
+    for (long j = n - 1; j >= 0; --j) {
+        const index_t last = U.pointers()[j + 1] - 1;
+        const double zj = y[j] /= U.values()[last];
+        if (zj == 0.0) continue;
+        for (index_t p = U.pointers()[j]; p < last; ++p)
+            y[U.indices()[p]] -= U.values()[p]*zj;
+    }
+
+    Vector x(n);
+    for (index_t k = 0; k < n; ++k) x[colPerm[k]] = y[k];
+    return x;
+}
+
+std::vector<Vector> solveLU(const SparseLUDecomposition &luObj, const std::vector<Vector> &bs) {
+    std::vector<Vector> xs;
+    xs.reserve(bs.size());
+    for (const Vector &b : bs) xs.push_back(solveLU(luObj, b));
+    return xs;
+}
+
+Vector solveLUTransposed(const SparseLUDecomposition &luObj, const Vector &b) {
+    // A^T = Q U^T L^T P
+    const size_t n = luObj.size();
+    if (b.size() != n) throw std::invalid_argument("vector and matrix size are different");
+    const SparseMatrix &L = luObj.lower(), &U = luObj.upper();
+    const auto &rowPerm = luObj.rowPerm();
+    const auto &colPerm = luObj.colPerm();
+
+    Vector y(n);
+    for (index_t k = 0; k < n; ++k) y[k] = b[colPerm[k]];
+
+    // U^T w = Q^T b: row j of U^T is column j of U
+    for (index_t j = 0; j < n; ++j) {
+        const index_t last = U.pointers()[j + 1] - 1;
+        double elem = y[j];
+        for (index_t p = U.pointers()[j]; p < last; ++p) elem -= U.values()[p]*y[U.indices()[p]];
+        y[j] = elem/U.values()[last];
+    }
+
+    // L^T v = w
+    for (long j = n - 1; j >= 0; --j) {
+        double elem = y[j];
+        for (index_t p = L.pointers()[j] + 1; p < L.pointers()[j + 1]; ++p)
+            elem -= L.values()[p]*y[L.indices()[p]];
+        y[j] = elem;
+    }
+
+    Vector x(n);
+    for (index_t k = 0; k < n; ++k) x[rowPerm[k]] = y[k];
+    return x;
+}
+
+
+namespace {
+    // Solve with diagonal block k of a BTF decomposition
+    Vector solveBlock(const BTFDecomposition &luObj, index_t k, const Vector &b, bool transposed) {
+        if (luObj.isSparseBlock(k))
+            return transposed ? solveLUTransposed(luObj.sparseBlock(k), b) : solveLU(luObj.sparseBlock(k), b);
+        return transposed ? solveLUTransposed(luObj.denseBlock(k), b) : solveLU(luObj.denseBlock(k), b);
+    }
+}
+
+Vector solveLU(const BTFDecomposition &luObj, const Vector &b) {
+    // PAQ = C, so C Q^T x = Pb
+    const size_t n = luObj.size();
+    if (b.size() != n) throw std::invalid_argument("vector and matrix size are different");
+    const BlockTriangularForm &form = luObj.form();
+    const SparseMatrix &C = luObj.permuted();
+
+    Vector z(n);
+    for (long k = long(form.blockCount()) - 1; k >= 0; --k) {
+        const index_t first = form.blocks[k], last = form.blocks[k + 1];
+        Vector rhs(last - first);
+        for (index_t i = first; i < last; ++i) {
+            double elem = b[form.rowPerm[i]];
+            for (index_t p = C.pointers()[i + 1]; p > C.pointers()[i] and C.indices()[p - 1] >= last; --p)
+                elem -= C.values()[p - 1]*z[C.indices()[p - 1]];
+            rhs[i - first] = elem;
+        }
+        z[std::slice(first, last - first, 1)] = solveBlock(luObj, k, rhs, false);
+    }
+
+    Vector x(n);
+    for (index_t k = 0; k < n; ++k) x[form.colPerm[k]] = z[k];
+    return x;
+}
+
+std::vector<Vector> solveLU(const BTFDecomposition &luObj, const std::vector<Vector> &bs) {
+    std::vector<Vector> xs;
+    xs.reserve(bs.size());
+    for (const Vector &b : bs) xs.push_back(solveLU(luObj, b));
+    return xs;
+}
+
+Vector solveLUTransposed(const BTFDecomposition &luObj, const Vector &b) {
+    // A^T = Q C^T P, so C^T (Px) = Q^T b, where C^T is block lower triangular
+    const size_t n = luObj.size();
+    if (b.size() != n) throw std::invalid_argument("vector and matrix size are different");
+    const BlockTriangularForm &form = luObj.form();
+    const SparseMatrix &C = luObj.permuted();
+
+    Vector c(n), w(n);
+    for (index_t k = 0; k < n; ++k) c[k] = b[form.colPerm[k]];
+    for (index_t k = 0; k < form.blockCount(); ++k) {
+        const index_t first = form.blocks[k], last = form.blocks[k + 1];
+        const Vector wk = solveBlock(luObj, k, c[std::slice(first, last - first, 1)], true);
+        w[std::slice(first, last - first, 1)] = wk;
+        // move the solved block's contribution to the right-hand sides of the next ones
+        for (index_t i = first; i < last; ++i)
+            for (index_t p = C.pointers()[i + 1]; p > C.pointers()[i] and C.indices()[p - 1] >= last; --p)
+                c[C.indices()[p - 1]] -= C.values()[p - 1]*wk[i - first];
+    }
+
+    Vector x(n);
+    for (index_t k = 0; k < n; ++k) x[form.rowPerm[k]] = w[k];
+    return x;
+}
+
+
+Vector solveLU(const BandLUDecomposition &luObj, const Vector &b) {
+    const BandMatrix &LU = luObj.factors();
+    const auto &pivots = luObj.pivots();
+    const size_t n = LU.size(), kl = LU.lower(), kv = LU.lower() + LU.upper();
+    if (b.size() != n) throw std::invalid_argument("vector and matrix size are different");
+
+    // Ly = Pb, applying the interchanges as they were made
+    Vector y = b;
+    for (index_t j = 0; j < n; ++j) {
+        std::swap(y[j], y[pivots[j]]);
+        const double yj = y[j];
+        if (yj == 0.0) continue;
+        const index_t last = std::min(n - 1, j + kl);
+        for (index_t i = j + 1; i <= last; ++i) y[i] -= LU.at(i, j)*yj;
+    }
+
+    // Ux = y, column by column
+    for (long j = n - 1; j >= 0; --j) {
+        const double xj = y[j] /= LU.at(j, j);
+        if (xj == 0.0) continue;
+        for (index_t i = index_t(j) > kv ? j - kv : 0; i < index_t(j); ++i) y[i] -= LU.at(i, j)*xj;
+    }
+
+    return y;
+}
+
+std::vector<Vector> solveLU(const BandLUDecomposition &luObj, const std::vector<Vector> &bs) {
+    std::vector<Vector> xs;
+    xs.reserve(bs.size());
+    for (const Vector &b : bs) xs.push_back(solveLU(luObj, b));
+    return xs;
+}
+
+Vector solveLUTransposed(const BandLUDecomposition &luObj, const Vector &b) {
+    const BandMatrix &LU = luObj.factors();
+    const auto &pivots = luObj.pivots();
+    const size_t n = LU.size(), kl = LU.lower(), kv = LU.lower() + LU.upper();
+    if (b.size() != n) throw std::invalid_argument("vector and matrix size are different");
+
+    // U^T w = b
+    Vector w = b;
+    for (index_t j = 0; j < n; ++j) {
+        double elem = w[j];
+        for (index_t i = j > kv ? j - kv : 0; i < j; ++i) elem -= LU.at(i, j)*w[i];
+        w[j] = elem/LU.at(j, j);
+    }
+
+    // L^T P x = w, undoing the interchanges in reverse order
+    for (long j = n - 1; j >= 0; --j) {
+        const index_t last = std::min(n - 1, index_t(j) + kl);
+        double elem = w[j];
+        for (index_t i = j + 1; i <= last; ++i) elem -= LU.at(i, j)*w[i];
+        w[j] = elem;
+        std::swap(w[j], w[pivots[j]]);
+    }
+
+    return w;
+}
+
+
+Vector solveLU(const TridiagonalLUDecomposition &luObj, const Vector &b) {
+    const size_t n = luObj.size();
+    if (b.size() != n) throw std::invalid_argument("vector and matrix size are different");
+    const auto &dl = luObj.multipliers(), &d = luObj.diagonal(), &du = luObj.upper(), &du2 = luObj.upper2();
+
+    // Ly = Pb, applying the interchanges as they come
+    Vector x = b;
+    for (index_t i = 0; i + 1 < n; ++i) {
+        if (luObj.swapped(i)) {
+            const double elem = x[i];
+            x[i] = x[i + 1];
+            x[i + 1] = elem - dl[i]*x[i];
+        } else {
+            x[i + 1] -= dl[i]*x[i];
+        }
+    }
+    // Ux = y
+    for (long i = n - 1; i >= 0; --i) {
+        double elem = x[i];
+        if (i + 1 < long(n)) elem -= du[i]*x[i + 1];
+        if (i + 2 < long(n)) elem -= du2[i]*x[i + 2];
+        x[i] = elem/d[i];
+    }
+    return x;
+}
+
+std::vector<Vector> solveLU(const TridiagonalLUDecomposition &luObj, const std::vector<Vector> &bs) {
+    std::vector<Vector> xs;
+    xs.reserve(bs.size());
+    for (const Vector &b : bs) xs.push_back(solveLU(luObj, b));
+    return xs;
+}
+
+Vector solveLUTransposed(const TridiagonalLUDecomposition &luObj, const Vector &b) {
+    const size_t n = luObj.size();
+    if (b.size() != n) throw std::invalid_argument("vector and matrix size are different");
+    const auto &dl = luObj.multipliers(), &d = luObj.diagonal(), &du = luObj.upper(), &du2 = luObj.upper2();
+
+    // U^T w = b
+    Vector x = b;
+    for (index_t i = 0; i < n; ++i) {
+        double elem = x[i];
+        if (i >= 1) elem -= du[i - 1]*x[i - 1];
+        if (i >= 2) elem -= du2[i - 2]*x[i - 2];
+        x[i] = elem/d[i];
+    }
+    // L^T P x = w, undoing the interchanges in reverse
+    for (long i = long(n) - 2; i >= 0; --i) {
+        if (luObj.swapped(i)) {
+            const double elem = x[i + 1];
+            x[i + 1] = x[i] - dl[i]*elem;
+            x[i] = elem;
+        } else {
+            x[i] -= dl[i]*x[i + 1];
+        }
+    }
+    return x;
+}
+
+
+namespace {
+    /// Block k (of size m) of a vector
+    inline Vector blockOf(const Vector &v, index_t k, size_t m) {
+        return v[std::slice(k*m, m, 1)];
+    }
+
+    /// Product of the transpose of a square matrix by a vector
+    Vector transposedProduct(const Matrix &A, const Vector &v) {
+        const size_t n = A.size();
+        Vector result(0.0, n);
+        for (index_t i = 0; i < n; ++i) result += A[i]*v[i];
+        return result;
+    }
+}
+
+Vector solveLU(const BlockTridiagonalLUDecomposition &luObj, const Vector &b) {
+    const size_t blocks = luObj.blockCount(), m = luObj.blockSize();
+    if (b.size() != luObj.size()) throw std::invalid_argument("vector and matrix size are different");
+
+    // forward: y_k = P_k^-1 (b_k - L_(k-1) y_(k-1)), P_k being the k-th pivot block
+    Vector x(luObj.size());
+    for (index_t k = 0; k < blocks; ++k) {
+        Vector rhs = blockOf(b, k, m);
+        if (k > 0) rhs -= luObj.lower(k - 1)*Vector(blockOf(x, k - 1, m));
+        x[std::slice(k*m, m, 1)] = solveLU(luObj.pivotBlock(k), rhs);
+    }
+    // back: x_k = y_k - X_k x_(k+1)
+    for (long k = long(blocks) - 2; k >= 0; --k)
+        x[std::slice(k*m, m, 1)] -= luObj.coupling(k)*blockOf(x, k + 1, m);
+    return x;
+}
+
+std::vector<Vector> solveLU(const BlockTridiagonalLUDecomposition &luObj, const std::vector<Vector> &bs) {
+    std::vector<Vector> xs;
+    xs.reserve(bs.size());
+    for (const Vector &b : bs) xs.push_back(solveLU(luObj, b));
+    return xs;
+}
+
+Vector solveLUTransposed(const BlockTridiagonalLUDecomposition &luObj, const Vector &b) {
+    const size_t blocks = luObj.blockCount(), m = luObj.blockSize();
+    if (b.size() != luObj.size()) throw std::invalid_argument("vector and matrix size are different");
+
+    // A^T is the product of the transposed factors, in reverse: first the block unit lower
+    // one (the couplings, transposed), then the block upper one
+    Vector x = b;
+    for (index_t k = 1; k < blocks; ++k)
+        x[std::slice(k*m, m, 1)] -= transposedProduct(luObj.coupling(k - 1), blockOf(x, k - 1, m));
+    for (long k = long(blocks) - 1; k >= 0; --k) {
+        Vector rhs = blockOf(x, k, m);
+        if (k + 1 < long(blocks)) rhs -= transposedProduct(luObj.lower(k), blockOf(x, k + 1, m));
+        x[std::slice(k*m, m, 1)] = solveLUTransposed(luObj.pivotBlock(k), rhs);
+    }
+    return x;
+}
+
+
+namespace {
+
+    /// Solve Lx = b in place, with L unit lower triangular, its rows in the lower part of a skyline matrix
+    void solveSkylineLower(const SkylineMatrix &L, Vector &x) {
+        const double *const lower = L.lowerValues().data();
+        for (index_t i = 0; i < L.size(); ++i) {
+            const index_t first = L.rowStart(i);
+            const double *row = lower + L.lowerPointers()[i];
+            double elem = x[i];
+            for (index_t j = first; j < i; ++j) elem -= row[j - first]*x[j];
+            x[i] = elem;
+        }
+    }
+
+    /// Solve L^T x = b in place, with L as in solveSkylineLower (the rows of L are the columns of L^T)
+    void solveSkylineLowerTransposed(const SkylineMatrix &L, Vector &x) {
+        const double *const lower = L.lowerValues().data();
+        for (long i = L.size() - 1; i >= 0; --i) {
+            const double xi = x[i];
+            if (xi == 0.0) continue;
+            const index_t first = L.rowStart(i);
+            const double *row = lower + L.lowerPointers()[i];
+            for (index_t j = first; j < index_t(i); ++j) x[j] -= row[j - first]*xi;
+        }
+    }
+
+}
+
+Vector solveLU(const SkylineLUDecomposition &luObj, const Vector &b) {
+    const SkylineMatrix &LU = luObj.factors();
+    const size_t n = LU.size();
+    if (b.size() != n) throw std::invalid_argument("vector and matrix size are different");
+
+    Vector x = b;
+    solveSkylineLower(LU, x);
+    // Ux = y by columns, dividing by the pivot first
+    const double *const upper = LU.upperValues().data();
+    for (long j = n - 1; j >= 0; --j) {
+        const double xj = x[j] /= LU.diagonal()[j];
+        if (xj == 0.0) continue;
+        const index_t first = LU.columnStart(j);
+        const double *column = upper + LU.upperPointers()[j];
+        for (index_t i = first; i < index_t(j); ++i) x[i] -= column[i - first]*xj;
+    }
+    return x;
+}
+
+std::vector<Vector> solveLU(const SkylineLUDecomposition &luObj, const std::vector<Vector> &bs) {
+    std::vector<Vector> xs;
+    xs.reserve(bs.size());
+    for (const Vector &b : bs) xs.push_back(solveLU(luObj, b));
+    return xs;
+}
+
+Vector solveLUTransposed(const SkylineLUDecomposition &luObj, const Vector &b) {
+    const SkylineMatrix &LU = luObj.factors();
+    const size_t n = LU.size();
+    if (b.size() != n) throw std::invalid_argument("vector and matrix size are different");
+
+    // U^T w = b: the rows of U^T are the stored columns of U
+    Vector w = b;
+    const double *const upper = LU.upperValues().data();
+    for (index_t j = 0; j < n; ++j) {
+        const index_t first = LU.columnStart(j);
+        const double *column = upper + LU.upperPointers()[j];
+        double elem = w[j];
+        for (index_t i = first; i < j; ++i) elem -= column[i - first]*w[i];
+        w[j] = elem/LU.diagonal()[j];
+    }
+
+    solveSkylineLowerTransposed(LU, w);
+    return w;
+}
+
+Vector solveLDLT(const SkylineLDLTDecomposition &ldlObj, const Vector &b) {
+    const SkylineMatrix &LDL = ldlObj.factors();
+    if (b.size() != LDL.size()) throw std::invalid_argument("vector and matrix size are different");
+
+    Vector x = b;
+    solveSkylineLower(LDL, x);
+    for (index_t i = 0; i < LDL.size(); ++i) x[i] /= LDL.diagonal()[i];
+    solveSkylineLowerTransposed(LDL, x);
+    return x;
+}
+
+std::vector<Vector> solveLDLT(const SkylineLDLTDecomposition &ldlObj, const std::vector<Vector> &bs) {
+    std::vector<Vector> xs;
+    xs.reserve(bs.size());
+    for (const Vector &b : bs) xs.push_back(solveLDLT(ldlObj, b));
+    return xs;
+}
+
+
+Vector solveCholesky(const CholeskyDecomposition &cholObj, const Vector &b) {
+    const PackedMatrix &L = cholObj.factor();
+    const size_t n = L.size();
+    if (b.size() != n) throw std::invalid_argument("vector and matrix size are different");
+
+    // Ly = b by rows, then L^T x = y by columns (the rows of L)
+    Vector x = b;
+    for (index_t i = 0; i < n; ++i) {
+        const double *row = L.row(i);
+        x[i] = (x[i] - std::inner_product(row, row + i, begin(x), 0.0))/row[i];
+    }
+    for (long i = n - 1; i >= 0; --i) {
+        const double *row = L.row(i);
+        const double xi = x[i] /= row[i];
+        if (xi == 0.0) continue;
+        for (index_t j = 0; j < index_t(i); ++j) x[j] -= row[j]*xi;
+    }
+    return x;
+}
+
+std::vector<Vector> solveCholesky(const CholeskyDecomposition &cholObj, const std::vector<Vector> &bs) {
+    std::vector<Vector> xs;
+    xs.reserve(bs.size());
+    for (const Vector &b : bs) xs.push_back(solveCholesky(cholObj, b));
+    return xs;
+}
+
+Vector solveLDLT(const LDLTDecomposition &ldlObj, const Vector &b) {
+    const PackedMatrix &LDL = ldlObj.factors();
+    const size_t n = LDL.size();
+    if (b.size() != n) throw std::invalid_argument("vector and matrix size are different");
+    const auto &perm = ldlObj.perm();
+    // L is unit lower triangular, except that (k + 1, k) holds D for a 2x2 block at k
+    auto rowLength = [&](index_t i) { return i > 0 and ldlObj.isTwoByTwo(i - 1) ? i - 1 : i; };
+
+    Vector x(n);
+    for (index_t k = 0; k < n; ++k) x[k] = b[perm[k]];
+    for (index_t i = 0; i < n; ++i) {
+        const double *row = LDL.row(i);
+        x[i] -= std::inner_product(row, row + rowLength(i), begin(x), 0.0);
+    }
+    for (index_t k = 0; k < n; ++k) {
+        if (not ldlObj.isTwoByTwo(k)) {
+            x[k] /= LDL.at(k, k);
+            continue;
+        }
+        const double d11 = LDL.at(k, k), d21 = LDL.at(k + 1, k), d22 = LDL.at(k + 1, k + 1);
+        const double det = d11*d22 - d21*d21, x1 = x[k], x2 = x[k + 1];
+        x[k] = (d22*x1 - d21*x2)/det;
+        x[k + 1] = (d11*x2 - d21*x1)/det;
+        ++k;
+    }
+    for (long i = n - 1; i >= 0; --i) {
+        const double *row = LDL.row(i);
+        const double xi = x[i];
+        if (xi == 0.0) continue;
+        for (index_t j = 0; j < rowLength(i); ++j) x[j] -= row[j]*xi;
+    }
+
+    Vector result(n);
+    for (index_t k = 0; k < n; ++k) result[perm[k]] = x[k];
+    return result;
+}
+
+std::vector<Vector> solveLDLT(const LDLTDecomposition &ldlObj, const std::vector<Vector> &bs) {
+    std::vector<Vector> xs;
+    xs.reserve(bs.size());
+    for (const Vector &b : bs) xs.push_back(solveLDLT(ldlObj, b));
+    return xs;
+}
+
+
+Vector solveLU(const TriangularDecomposition &triObj, const Vector &b) {
+    const SparseMatrix &A = triObj.matrix();
+    const size_t n = A.size();
+    if (b.size() != n) throw std::invalid_argument("vector and matrix size are different");
+
+    // row rowOrder[k] only involves the columns of the previous steps, besides colOrder[k]
+    Vector x(0.0, n);
+    const auto &pivots = triObj.pivots();
+    for (index_t k = 0; k < n; ++k) {
+        const index_t row = triObj.rowOrder()[k];
+        double elem = b[row];
+        for (index_t p = A.pointers()[row]; p < A.pointers()[row + 1]; ++p)
+            if (p != pivots[k]) elem -= A.values()[p]*x[A.indices()[p]];
+        x[triObj.colOrder()[k]] = elem/A.values()[pivots[k]];
+    }
+    return x;
+}
+
+std::vector<Vector> solveLU(const TriangularDecomposition &triObj, const std::vector<Vector> &bs) {
+    std::vector<Vector> xs;
+    xs.reserve(bs.size());
+    for (const Vector &b : bs) xs.push_back(solveLU(triObj, b));
+    return xs;
+}
+
+Vector solveLUTransposed(const TriangularDecomposition &triObj, const Vector &b) {
+    const SparseMatrix &A = triObj.matrix();
+    const size_t n = A.size();
+    if (b.size() != n) throw std::invalid_argument("vector and matrix size are different");
+
+    // the steps in reverse: once x[row] is known, the other entries of its row (in the columns of
+    // the previous steps) move to the right-hand side
+    Vector rhs = b, x(0.0, n);
+    const auto &pivots = triObj.pivots();
+    for (long k = n - 1; k >= 0; --k) {
+        const index_t row = triObj.rowOrder()[k];
+        const double xk = x[row] = rhs[triObj.colOrder()[k]]/A.values()[pivots[k]];
+        if (xk == 0.0) continue;
+        for (index_t p = A.pointers()[row]; p < A.pointers()[row + 1]; ++p)
+            if (p != pivots[k]) rhs[A.indices()[p]] -= A.values()[p]*xk;
+    }
+    return x;
+}
+
+
+namespace {
+    /// Jv: v reversed
+    Vector reversed(const Vector &v) {
+        Vector result(v.size());
+        std::reverse_copy(begin(v), end(v), begin(result));
+        return result;
+    }
+
+    /// Zv: v shifted down by one place, with a leading zero
+    Vector shiftedDown(const Vector &v) {
+        Vector result(0.0, v.size());
+        if (v.size() > 0) result[std::slice(1, v.size() - 1, 1)] = v[std::slice(0, v.size() - 1, 1)];
+        return result;
+    }
+
+    /// L(a) v, with L(a) the lower triangular Toeplitz matrix with first column a
+    inline Vector lowerToeplitzProduct(const Vector &a, const Vector &v, bool fft) {
+        return convolution(a, v, v.size(), fft);
+    }
+
+    /// U(w) v = J L(w) J v, with U(w) the upper triangular Toeplitz matrix with first row w
+    inline Vector upperToeplitzProduct(const Vector &w, const Vector &v, bool fft) {
+        return reversed(convolution(w, reversed(v), v.size(), fft));
+    }
+}
+
+Vector solveLU(const ToeplitzDecomposition &toepObj, const Vector &b) {
+    if (b.size() != toepObj.size()) throw std::invalid_argument("vector and matrix size are different");
+    if (toepObj.isFallback()) return solveLU(toepObj.getLU(), b);
+    if (b.size() == 0) return b;
+
+    // Gohberg-Semencul: T^-1 b = (L(x) U(Jy) b - L(Zy) U(ZJx) b)/x_0
+    const Vector &x = toepObj.firstColumn(), &y = toepObj.lastColumn();
+    const bool fft = toepObj.usesFFT();
+    Vector result = lowerToeplitzProduct(x, upperToeplitzProduct(reversed(y), b, fft), fft);
+    result -= lowerToeplitzProduct(shiftedDown(y), upperToeplitzProduct(shiftedDown(reversed(x)), b, fft), fft);
+    return result /= x[0];
+}
+
+std::vector<Vector> solveLU(const ToeplitzDecomposition &toepObj, const std::vector<Vector> &bs) {
+    std::vector<Vector> xs;
+    xs.reserve(bs.size());
+    for (const Vector &b : bs) xs.push_back(solveLU(toepObj, b));
+    return xs;
+}
+
+Vector solveLUTransposed(const ToeplitzDecomposition &toepObj, const Vector &b) {
+    if (b.size() != toepObj.size()) throw std::invalid_argument("vector and matrix size are different");
+    if (toepObj.isFallback()) return solveLUTransposed(toepObj.getLU(), b);
+    if (b.size() == 0) return b;
+
+    // the transpose of the Gohberg-Semencul formula: T^-T b = (L(Jy) U(x) b - L(ZJx) U(Zy) b)/x_0
+    const Vector &x = toepObj.firstColumn(), &y = toepObj.lastColumn();
+    const bool fft = toepObj.usesFFT();
+    Vector result = lowerToeplitzProduct(reversed(y), upperToeplitzProduct(x, b, fft), fft);
+    result -= lowerToeplitzProduct(shiftedDown(reversed(x)), upperToeplitzProduct(shiftedDown(y), b, fft), fft);
+    return result /= x[0];
+}
+
+
+namespace {
+    /**
+     * Apply the inverse of each factor of a Kronecker system along its index of the tensor x:
+     * solveColumns(luObj, base, inner, k) solves for columns 0 to k - 1 of the n_m x inner
+     * row-major slab starting at base, in place. Slabs are split in RHS_BLOCK wide blocks of
+     * columns, shared among threads for large systems.
+     */
+    template<typename SolveColumns>
+    void solveKroneckerModes(const KroneckerSystem &kronObj, Vector &x, SolveColumns solveColumns) {
+        const size_t size = kronObj.size();
+        size_t inner = size;
+        for (const LUDecomposition &luObj : kronObj.factors()) {
+            const size_t n = luObj.decompMatrix().size();
+            inner /= n;  // n > 0 (see KroneckerSystem::tryFactor)
+            const size_t width = std::min(inner, RHS_BLOCK), blocks = (inner + width - 1)/width;
+            const size_t units = size/(n*inner)*blocks;
+            auto solveUnit = [&](index_t u) {
+                const index_t first = u%blocks*width;
+                solveColumns(luObj, &x[u/blocks*n*inner + first], inner, std::min(width, inner - first));
+            };
+            if (size < KRONECKER_PARALLEL_MIN_SIZE or units == 1)
+                for (index_t u = 0; u < units; ++u) solveUnit(u);
+            else parallelFor(units, solveUnit);
+        }
+    }
+}
+
+Vector solveLU(const KroneckerSystem &kronObj, const Vector &c) {
+    if (c.size() != kronObj.size()) throw std::invalid_argument("vector and matrix size are different");
+    Vector x = c;
+    solveKroneckerModes(kronObj, x, [](const LUDecomposition &luObj, double *base, size_t ld, size_t k) {
+        // gather the permuted rows, as solveBlock wants them, and scatter the solutions back
+        const Matrix &LU = luObj.decompMatrix();
+        const auto &perm = luObj.perm().vector();
+        const size_t n = LU.size();
+        std::vector<double> Y(n*k);
+        for (index_t i = 0; i < n; ++i)
+            for (index_t r = 0; r < k; ++r) Y[i*k + r] = base[perm[i]*ld + r];
+        solveBlock(LU, Y.data(), k);
+        for (index_t i = 0; i < n; ++i)
+            for (index_t r = 0; r < k; ++r) base[i*ld + r] = Y[i*k + r];
+    });
+    return x;
+}
+
+std::vector<Vector> solveLU(const KroneckerSystem &kronObj, const std::vector<Vector> &cs) {
+    std::vector<Vector> xs;
+    xs.reserve(cs.size());
+    for (const Vector &c : cs) xs.push_back(solveLU(kronObj, c));
+    return xs;
+}
+
+Vector solveLUTransposed(const KroneckerSystem &kronObj, const Vector &c) {
+    if (c.size() != kronObj.size()) throw std::invalid_argument("vector and matrix size are different");
+    // (A ⊗ B)^T = A^T ⊗ B^T: the transposed solves, one column at a time
+    Vector x = c;
+    solveKroneckerModes(kronObj, x, [](const LUDecomposition &luObj, double *base, size_t ld, size_t k) {
+        const size_t n = luObj.decompMatrix().size();
+        Vector column(n);
+        for (index_t r = 0; r < k; ++r) {
+            for (index_t i = 0; i < n; ++i) column[i] = base[i*ld + r];
+            column = solveLUTransposed(luObj, column);
+            for (index_t i = 0; i < n; ++i) base[i*ld + r] = column[i];
+        }
+    });
+    return x;
+}
+
+
+std::vector<Vector> solveLU(const SchurComplementDecomposition &schurObj, const std::vector<Vector> &bs) {
+    const size_t n = schurObj.leadingSize(), m = schurObj.borderSize();
+    for (const auto &b : bs)
+        if (b.size() != n + m) throw std::invalid_argument("vector and matrix size are different");
+    const auto &C = schurObj.lowerBorder(), &W = schurObj.coupling();
+
+    // y = A^-1 f, x2 = S^-1 (g - C y), x1 = y - A^-1 B x2
+    std::vector<Vector> ys(bs.size()), gs(bs.size());
+    for (index_t r = 0; r < bs.size(); ++r) ys[r] = bs[r][std::slice(0, n, 1)];
+    ys = solveLU(schurObj.getA(), ys);
+    for (index_t r = 0; r < bs.size(); ++r) {
+        gs[r] = bs[r][std::slice(n, m, 1)];
+        for (index_t i = 0; i < m; ++i) gs[r][i] -= std::inner_product(begin(C[i]), end(C[i]), begin(ys[r]), 0.0);
+    }
+    if (m > 0) gs = solveLU(schurObj.getSchur(), gs);
+
+    std::vector<Vector> xs(bs.size());
+    for (index_t r = 0; r < bs.size(); ++r) {
+        for (index_t j = 0; j < m; ++j) ys[r] -= W[j]*gs[r][j];
+        xs[r].resize(n + m);
+        xs[r][std::slice(0, n, 1)] = ys[r];
+        xs[r][std::slice(n, m, 1)] = gs[r];
+    }
+    return xs;
+}
+
+Vector solveLU(const SchurComplementDecomposition &schurObj, const Vector &b) {
+    return solveLU(schurObj, std::vector<Vector>{b}).front();
+}
+
+Vector solveLUTransposed(const SchurComplementDecomposition &schurObj, const Vector &b) {
+    const size_t n = schurObj.leadingSize(), m = schurObj.borderSize();
+    if (b.size() != n + m) throw std::invalid_argument("vector and matrix size are different");
+    const auto &C = schurObj.lowerBorder(), &W = schurObj.coupling();
+
+    // M^T = [A^T C^T; B^T D^T], whose Schur complement is S^T:
+    // x2 = S^-T (g - (A^-1 B)^T f), x1 = A^-T (f - C^T x2)
+    Vector f = b[std::slice(0, n, 1)], g = b[std::slice(n, m, 1)];
+    for (index_t j = 0; j < m; ++j) g[j] -= std::inner_product(begin(W[j]), end(W[j]), begin(f), 0.0);
+    if (m > 0) g = solveLUTransposed(schurObj.getSchur(), g);
+    for (index_t i = 0; i < m; ++i) f -= C[i]*g[i];
+
+    Vector x(n + m);
+    x[std::slice(0, n, 1)] = solveLUTransposed(schurObj.getA(), f);
+    x[std::slice(n, m, 1)] = g;
+    return x;
+}
+
+
+Vector solveLU(const UpdatedLU &luObj, const Vector &b) {
+    // x = y - Z C^-1 V^T y, y = A^-1 b
+    Vector x = solveLU(luObj.getLU(), b);
+    const size_t k = luObj.rank();
+    if (k == 0) return x;
+    const auto &V = luObj.lowRankV(), &Z = luObj.solvedU();
+    Vector t(k);
+    for (index_t j = 0; j < k; ++j) t[j] = std::inner_product(begin(V[j]), end(V[j]), begin(x), 0.0);
+    t = solveLU(luObj.getCapacitance(), t);
+    for (index_t j = 0; j < k; ++j) x -= Z[j]*t[j];
+    return x;
+}
+
+std::vector<Vector> solveLU(const UpdatedLU &luObj, const std::vector<Vector> &bs) {
+    std::vector<Vector> xs;
+    xs.reserve(bs.size());
+    for (const Vector &b : bs) xs.push_back(solveLU(luObj, b));
+    return xs;
+}
+
+Vector solveLUTransposed(const UpdatedLU &luObj, const Vector &b) {
+    // (A + U V^T)^-T = A^-T - A^-T V C^-T Z^T: x = A^-T (b - V C^-T Z^T b)
+    const size_t k = luObj.rank();
+    if (k == 0) return solveLUTransposed(luObj.getLU(), b);
+    if (b.size() != luObj.size()) throw std::invalid_argument("vector and matrix size are different");
+    const auto &V = luObj.lowRankV(), &Z = luObj.solvedU();
+    Vector t(k);
+    for (index_t j = 0; j < k; ++j) t[j] = std::inner_product(begin(Z[j]), end(Z[j]), begin(b), 0.0);
+    t = solveLUTransposed(luObj.getCapacitance(), t);
+    Vector w = b;
+    for (index_t j = 0; j < k; ++j) w -= V[j]*t[j];
+    return solveLUTransposed(luObj.getLU(), w);
+}
 
 
 //----- C-style interface -----//
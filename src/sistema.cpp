@@ -1,42 +1,463 @@
 #include <cassert>
+#include <limits>
 
 #include "resol.h"
 #include "sistema.h"
 #include "errors.h"
+#include "inverse.h"
 #include "norm.h"
 
 
-SolveResult solve(const Matrix &A, const Vector &b, double tol) {
-    try {
-        LUDecomposition luObj(A, tol);
-        auto &&res = SolveResult(true, std::move(luObj), solveLU(luObj, b));
-        return std::move(res);
-    } catch (SingularMatrixError &) {
-        return SolveResult(tol);
+namespace {
+    // Whether a dense matrix with nnz non-zero entries is better factored in sparse storage
+    bool factorSparse(size_t n, size_t nnz) {
+        return n >= SPARSE_MIN_SIZE and preferSparse(n, nnz);
     }
+
+    bool factorSparse(const Matrix &A) {
+        const size_t n = A.size();
+        if (n < SPARSE_MIN_SIZE) return false;
+        size_t nnz = 0;
+        for (index_t i = 0; i < n; ++i)
+            for (index_t j = 0; j < n; ++j) nnz += A[i][j] != 0.0;
+        return factorSparse(n, nnz);
+    }
+
+    void checkRightHandSides(const std::vector<Vector> &bs) {
+        if (bs.empty()) throw MatrixError("no right-hand sides");
+    }
+
+    Permutation::Vector identityOrder(size_t n) {
+        Permutation::Vector order(n);
+        for (index_t i = 0; i < n; ++i) order[i] = i;
+        return order;
+    }
+
+    Permutation::Vector reversedOrder(size_t n) {
+        Permutation::Vector order(n);
+        for (index_t i = 0; i < n; ++i) order[i] = n - 1 - i;
+        return order;
+    }
+
+    // Whether every solution xs[k] of Ax = bs[k] has a backward error ||Ax - b||/(||A|| ||x||) within tol
+    bool backwardStable(const Matrix &A, const std::vector<Vector> &bs, const std::vector<Vector> &xs, double tol) {
+        const double normA = normInf(A);
+        for (index_t k = 0; k < bs.size(); ++k)
+            if (not(normInf(A*xs[k] - bs[k]) <= tol*normA*normInf(xs[k]))) return false;
+        return true;
+    }
+
+    // What differs between the decompositions behind Factorization: how they solve, which
+    // permutations they hold and how they compute the norm of the inverse
+
+    template<typename Decomposition>
+    std::vector<Vector> solveAll(const Decomposition &dec, const std::vector<Vector> &bs) {
+        return solveLU(dec, bs);
+    }
+
+    std::vector<Vector> solveAll(const LUDecomposition &luObj, const std::vector<Vector> &bs) {
+        return bs.size() == 1 ? std::vector<Vector>{solveLU(luObj, bs.front())} : solveLU(luObj, bs);
+    }
+
+    std::vector<Vector> solveAll(const SkylineLDLTDecomposition &ldlObj, const std::vector<Vector> &bs) {
+        return solveLDLT(ldlObj, bs);
+    }
+
+    std::vector<Vector> solveAll(const CholeskyDecomposition &cholObj, const std::vector<Vector> &bs) {
+        return solveCholesky(cholObj, bs);
+    }
+
+    std::vector<Vector> solveAll(const LDLTDecomposition &ldlObj, const std::vector<Vector> &bs) {
+        return solveLDLT(ldlObj, bs);
+    }
+
+    // the given permutation, unless the decomposition holds its own
+    template<typename Decomposition>
+    const Permutation::Vector &rowPerm(const Decomposition &, const Permutation::Vector &given) { return given; }
+
+    const Permutation::Vector &rowPerm(const LUDecomposition &luObj, const Permutation::Vector &) {
+        return luObj.perm().vector();
+    }
+
+    const Permutation::Vector &rowPerm(const SparseLUDecomposition &luObj, const Permutation::Vector &) {
+        return luObj.rowPerm();
+    }
+
+    const Permutation::Vector &rowPerm(const BTFDecomposition &luObj, const Permutation::Vector &) {
+        return luObj.rowPerm();
+    }
+
+    const Permutation::Vector &rowPerm(const LDLTDecomposition &ldlObj, const Permutation::Vector &) {
+        return ldlObj.perm();
+    }
+
+    template<typename Decomposition>
+    const Permutation::Vector &colPerm(const Decomposition &, const Permutation::Vector &given) { return given; }
+
+    const Permutation::Vector &colPerm(const SparseLUDecomposition &luObj, const Permutation::Vector &) {
+        return luObj.colPerm();
+    }
+
+    const Permutation::Vector &colPerm(const BTFDecomposition &luObj, const Permutation::Vector &) {
+        return luObj.colPerm();
+    }
+
+    const Permutation::Vector &colPerm(const LDLTDecomposition &ldlObj, const Permutation::Vector &) {
+        return ldlObj.perm();  // PAP^T
+    }
+
+    template<typename Decomposition>
+    bool parity(const Decomposition &dec) { return dec.parity(); }
+
+    bool parity(const LUDecomposition &luObj) { return luObj.perm().parity(); }
+
+    bool parity(const ToeplitzDecomposition &toepObj) {
+        return toepObj.isFallback() and toepObj.getLU().perm().parity();
+    }
+
+    // no pivoting, or a symmetric one
+    bool parity(const SkylineLUDecomposition &) { return false; }
+    bool parity(const SkylineLDLTDecomposition &) { return false; }
+    bool parity(const CholeskyDecomposition &) { return false; }
+    bool parity(const LDLTDecomposition &) { return false; }
+
+    template<typename Decomposition>
+    double decompositionInverseNorm(const Decomposition &dec, NormType nt) { return inverseNorm(dec, nt); }
+
+    double decompositionInverseNorm(const LUDecomposition &luObj, NormType nt) { return norm(inverse(luObj), nt); }
+
+    template<typename Decomposition>
+    class FactorizationOf final : public Factorization {
+    public:
+        FactorizationOf(Decomposition &&dec, Permutation::Vector perm, Permutation::Vector colPerm)
+                : _dec(std::move(dec)), _perm(std::move(perm)), _colPerm(std::move(colPerm)) {}
+
+        std::vector<Vector> solve(const std::vector<Vector> &bs) const override { return solveAll(_dec, bs); }
+        const Permutation::Vector &perm() const override { return rowPerm(_dec, _perm); }
+        const Permutation::Vector &colPerm() const override { return ::colPerm(_dec, _colPerm); }
+        bool parity() const override { return ::parity(_dec); }
+        double inverseNorm(NormType nt) const override { return decompositionInverseNorm(_dec, nt); }
+
+        inline const Decomposition &decomposition() const { return _dec; }
+
+    private:
+        Decomposition _dec;
+        Permutation::Vector _perm, _colPerm;
+    };
+
+    // The decomposition behind a solve result, if it is of this type
+    template<typename Decomposition>
+    const Decomposition &decomposition(const Factorization *factorization) {
+        auto holder = dynamic_cast<const FactorizationOf<Decomposition> *>(factorization);
+        if (not holder) throw MatrixError("the system wasn't solved through this decomposition");
+        return holder->decomposition();
+    }
+}
+
+template<typename Decomposition>
+void SolveResult::setFactorization(SolveMethod method, Decomposition &&dec, const std::vector<Vector> &bs,
+                                   Permutation::Vector perm, Permutation::Vector colPerm) {
+    _factorization.reset(new FactorizationOf<Decomposition>(std::move(dec), std::move(perm), std::move(colPerm)));
+    _method = method;
+    _solutions = _factorization->solve(bs);
+    _success = true;
+}
+
+const char *methodName(SolveMethod method) {
+    switch (method) {
+        case SolveMethod::LU: return "LU";
+        case SolveMethod::SparseLU: return "sparse LU";
+        case SolveMethod::BlockTriangular: return "block triangular LU";
+        case SolveMethod::Iterative: return "iterative";
+        case SolveMethod::Diagonal: return "diagonal";
+        case SolveMethod::LowerTriangular: return "lower triangular";
+        case SolveMethod::UpperTriangular: return "upper triangular";
+        case SolveMethod::PermutedTriangular: return "permuted triangular";
+        case SolveMethod::Tridiagonal: return "tridiagonal LU";
+        case SolveMethod::Band: return "band LU";
+        case SolveMethod::SkylineLDLT: return "skyline LDL^T";
+        case SolveMethod::SkylineLU: return "skyline LU";
+        case SolveMethod::Cholesky: return "Cholesky";
+        case SolveMethod::LDLT: return "Bunch-Kaufman LDL^T";
+        case SolveMethod::Toeplitz: return "Toeplitz (Levinson)";
+    }
+    return "";
+}
+
+SolveResult solve(const Matrix &A, const Vector &b, double tol, SolverChoice choice) {
+    return solve(A, std::vector<Vector>{b}, tol, choice);
+}
+
+SolveResult solve(const Matrix &A, const std::vector<Vector> &bs, double tol, SolverChoice choice) {
+    checkRightHandSides(bs);
+    if (choice == SolverChoice::Auto) return SolveResult::solveStructured(A, bs, tol);
+    if (factorSparse(A)) return solve(SparseMatrix::fromDense(A), bs, tol);
+    return SolveResult::solveGeneral(A, bs, tol);
+}
+
+SolveResult SolveResult::solveGeneral(const Matrix &A, const std::vector<Vector> &bs, double tol) {
+    SolveResult result(tol, LUStatus());
+    LUDecomposition luObj;
+    result._status = luObj.tryFactor(A, tol);
+    if (result._status) result.setFactorization(SolveMethod::LU, std::move(luObj), bs);
+    return result;
+}
+
+SolveResult SolveResult::solveStructured(const Matrix &A, const std::vector<Vector> &bs, double tol) {
+    const size_t n = A.size();
+    const MatrixStructure structure = detectStructure(A);
+    SolveResult result(tol, LUStatus());
+
+    // (permuted) triangular: substitution right away
+    Permutation::Vector rowOrder, colOrder;
+    SolveMethod method = SolveMethod::PermutedTriangular;
+    bool triangular = true;
+    if (structure.isLowerTriangular()) {
+        method = structure.isDiagonal() ? SolveMethod::Diagonal : SolveMethod::LowerTriangular;
+        rowOrder = colOrder = identityOrder(n);
+    } else if (structure.isUpperTriangular()) {
+        method = SolveMethod::UpperTriangular;
+        rowOrder = colOrder = reversedOrder(n);
+    } else triangular = structure.nnz <= n*(n + 1)/2 and findTriangularOrder(A, rowOrder, colOrder);
+    if (triangular) {
+        // only a permuted triangular matrix reports its substitution order as permutations
+        Permutation::Vector perm = identityOrder(n), colPerm;
+        if (method == SolveMethod::PermutedTriangular) {
+            perm = rowOrder;
+            colPerm = colOrder;
+        }
+        TriangularDecomposition triObj;
+        result._status = triObj.tryFactor(A, std::move(rowOrder), std::move(colOrder), tol);
+        if (result._status) result.setFactorization(method, std::move(triObj), bs, std::move(perm), std::move(colPerm));
+        return result;
+    }
+
+    if (structure.isTridiagonal() and structure.isNarrowBand(n)) {
+        TridiagonalLUDecomposition luObj;
+        result._status = luObj.tryFactor(TridiagonalMatrix::fromDense(A), tol);
+        if (not result._status) return result;
+        Permutation::Vector perm = luObj.perm();
+        result.setFactorization(SolveMethod::Tridiagonal, std::move(luObj), bs, std::move(perm));
+        return result;
+    }
+
+    if (structure.isNarrowBand(n)) {
+        BandLUDecomposition luObj;
+        result._status = luObj.tryFactor(BandMatrix::fromDense(A, structure.band.lower, structure.band.upper), tol);
+        if (not result._status) return result;
+        Permutation::Vector perm = luObj.perm();
+        result.setFactorization(SolveMethod::Band, std::move(luObj), bs, std::move(perm));
+        return result;
+    }
+
+    if (factorSparse(n, structure.nnz)) return solve(SparseMatrix::fromDense(A), bs, tol);
+
+    // Toeplitz: O(n^2) inverse generators instead of an O(n^3) factorization
+    if (structure.toeplitz) {
+        ToeplitzDecomposition toepObj;
+        result._status = toepObj.tryFactor(ToeplitzMatrix::fromDense(A), tol);
+        if (not result._status) return result;
+        const bool fallback = toepObj.isFallback();
+        Permutation::Vector perm = fallback ? toepObj.getLU().perm().vector() : identityOrder(n);
+        result.setFactorization(SolveMethod::Toeplitz, std::move(toepObj), bs, std::move(perm));
+        // the recursion is only stable for positive definite matrices: an ill-conditioned leading
+        // submatrix can spoil the solutions without any pivot below LEVINSON_MIN_PIVOT
+        if (fallback or backwardStable(A, bs, result._solutions, tol)) return result;
+        return solveGeneral(A, bs, tol);
+    }
+
+    // strictly diagonally dominant: no pivoting needed, so the envelope is kept
+    const bool smallProfile = double(structure.profile) <= SKYLINE_MAX_FRACTION*double(n*n);
+    if (structure.diagonallyDominant and (not structure.symmetric or (structure.positiveDiagonal and smallProfile))) {
+        if (structure.symmetric) {
+            SkylineLDLTDecomposition ldlObj;
+            result._status = ldlObj.tryFactor(SkylineMatrix::fromDense(A, true), tol);
+            if (result._status) result.setFactorization(SolveMethod::SkylineLDLT, std::move(ldlObj), bs, identityOrder(n));
+        } else {
+            SkylineLUDecomposition luObj;
+            result._status = luObj.tryFactor(SkylineMatrix::fromDense(A), tol);
+            if (result._status) result.setFactorization(SolveMethod::SkylineLU, std::move(luObj), bs, identityOrder(n));
+        }
+        return result;
+    }
+
+    if (structure.symmetric) {
+        // Cholesky first (a positive diagonal is necessary for it), Bunch-Kaufman if A turns out indefinite
+        const PackedMatrix packed = PackedMatrix::fromDense(A);
+        CholeskyDecomposition cholObj;
+        if (structure.positiveDiagonal and cholObj.tryFactor(packed, tol, n >= CHOLESKY_PARALLEL_MIN_ROWS)) {
+            result.setFactorization(SolveMethod::Cholesky, std::move(cholObj), bs, identityOrder(n));
+            return result;
+        }
+        LDLTDecomposition ldlObj;
+        if (ldlObj.tryFactor(packed, tol)) {
+            result.setFactorization(SolveMethod::LDLT, std::move(ldlObj), bs);
+            return result;
+        }
+        // singular as far as symmetric pivoting can tell: let the general LU decomposition report it
+    }
+
+    // reducible: only factor the diagonal blocks (a zero off-diagonal block takes at least n - 1 zeros)
+    if (n >= DENSE_BTF_MIN_SIZE and structure.nnz <= n*n - (n - 1)) {
+        const SparseMatrix sparse = SparseMatrix::fromDense(A);
+        BlockTriangularForm form = blockTriangularForm(sparse);
+        if (form.rank == n and form.blockCount() > 1) {
+            BTFDecomposition luObj;
+            result._status = luObj.tryFactor(sparse, std::move(form), tol);
+            if (result._status) result.setFactorization(SolveMethod::BlockTriangular, std::move(luObj), bs);
+            return result;
+        }
+    }
+
+    return solveGeneral(A, bs, tol);
+}
+
+SolveResult solve(const SparseMatrix &A, const std::vector<Vector> &bs, double tol) {
+    checkRightHandSides(bs);
+    SolveResult result(tol, LUStatus());
+    BlockTriangularForm form = blockTriangularForm(A);
+    if (form.rank == A.size() and form.blockCount() > 1) {
+        // reducible: only factor the diagonal blocks
+        BTFDecomposition luObj;
+        result._status = luObj.tryFactor(A, std::move(form), tol);
+        if (result._status) result.setFactorization(SolveMethod::BlockTriangular, std::move(luObj), bs);
+        return result;
+    }
+
+    SparseLUDecomposition luObj;
+    result._status = luObj.tryFactor(A, tol);
+    if (result._status) result.setFactorization(SolveMethod::SparseLU, std::move(luObj), bs);
+    return result;
+}
+
+SolveResult solve(const SparseMatrix &A, const std::vector<Vector> &bs, const IterativeOptions &options) {
+    checkRightHandSides(bs);
+    IncompleteLU M;
+    LUStatus status = factorPreconditioner(M, A, options);
+    if (not status) return SolveResult(options.tol, status);
+    const IncompleteLU *preconditioner = options.preconditioner == Preconditioner::None ? nullptr : &M;
+
+    SolveResult result(options.tol, status);
+    result._success = true;
+    result._method = SolveMethod::Iterative;
+    for (const Vector &b : bs) {
+        IterativeResult x = solveIterative(A, b, preconditioner, options);
+        result._solutions.push_back(std::move(x.x));
+        result._iterations.push_back(x.iterations);
+        result._iterativeResiduals.push_back(x.residual);
+    }
+    return result;
+}
+
+
+const Permutation::Vector &SolveResult::perm() const {
+    static const Permutation::Vector none;
+    return _factorization ? _factorization->perm() : none;
+}
+
+const Permutation::Vector &SolveResult::colPerm() const {
+    static const Permutation::Vector none;
+    return _factorization ? _factorization->colPerm() : none;
+}
+
+const LUDecomposition &SolveResult::getLU() const {
+    return decomposition<LUDecomposition>(factorization());
+}
+
+const SparseLUDecomposition &SolveResult::getSparseLU() const {
+    return decomposition<SparseLUDecomposition>(factorization());
+}
+
+const BTFDecomposition &SolveResult::getBTF() const {
+    return decomposition<BTFDecomposition>(factorization());
+}
+
+const BandLUDecomposition &SolveResult::getBandLU() const {
+    return decomposition<BandLUDecomposition>(factorization());
+}
+
+const SkylineLUDecomposition &SolveResult::getSkylineLU() const {
+    return decomposition<SkylineLUDecomposition>(factorization());
+}
+
+const SkylineLDLTDecomposition &SolveResult::getSkylineLDLT() const {
+    return decomposition<SkylineLDLTDecomposition>(factorization());
+}
+
+const TriangularDecomposition &SolveResult::getTriangular() const {
+    return decomposition<TriangularDecomposition>(factorization());
+}
+
+const TridiagonalLUDecomposition &SolveResult::getTridiagonal() const {
+    return decomposition<TridiagonalLUDecomposition>(factorization());
+}
+
+const CholeskyDecomposition &SolveResult::getCholesky() const {
+    return decomposition<CholeskyDecomposition>(factorization());
 }
 
+const LDLTDecomposition &SolveResult::getLDLT() const {
+    return decomposition<LDLTDecomposition>(factorization());
+}
 
-SolveResult::SolveResult(bool success, LUDecomposition &&luObj, Vector &&solution)
-        : _success(success), _luObj(std::move(luObj)), _solution(std::move(solution)) {}
+const ToeplitzDecomposition &SolveResult::getToeplitz() const {
+    return decomposition<ToeplitzDecomposition>(factorization());
+}
 
 const Vector &SolveResult::solution() const {
+    return solutions().front();
+}
+
+const std::vector<Vector> &SolveResult::solutions() const {
     if (not _success)
         throw std::invalid_argument("invalid request for unsuccessful solve's solution");
-    return _solution;
+    return _solutions;
+}
+
+bool SolveResult::converged() const {
+    if (not isIterative()) return _success;
+    for (double r : _iterativeResiduals)
+        if (not(r <= _tol)) return false;
+    return true;
 }
 
 double residue(const Matrix &A, const Vector &x, const Vector &b) {
     return normInf(A*x - b)/normInf(x);
 }
 
+double residue(const SparseMatrix &A, const Vector &x, const Vector &b) {
+    return normInf(A*x - b)/normInf(x);
+}
+
 ExtraSolveInfo getExtraSolveInfo(const Matrix &A, const Vector &b, const SolveResult &res) {
-    const auto& luObj = res.getLU();
-    return {
-            .residue = residue(A, res.solution(), b),
-            .cond1 = conditionNumber(A, luObj, NormType::L1),
-            .condInf = conditionNumber(A, luObj, NormType::Inf)
-    };
+    return getExtraSolveInfo(A, std::vector<Vector>{b}, res);
+}
+
+namespace {
+    template<typename MatrixType>
+    ExtraSolveInfo extraSolveInfo(const MatrixType &A, const std::vector<Vector> &bs, const SolveResult &res) {
+        const auto &xs = res.solutions();
+        checkRightHandSides(bs);
+        if (xs.size() != bs.size()) throw MatrixError("solutions and right-hand sides are different in number");
+        ExtraSolveInfo info;
+        for (index_t k = 0; k < bs.size(); ++k) info.residues.push_back(residue(A, xs[k], bs[k]));
+        info.residue = info.residues.front();
+        if (not res.factorization()) {
+            info.cond1 = info.condInf = std::numeric_limits<double>::quiet_NaN();  // not estimated without a factorization
+        } else {
+            info.cond1 = norm(A, NormType::L1)*res.factorization()->inverseNorm(NormType::L1);
+            info.condInf = norm(A, NormType::Inf)*res.factorization()->inverseNorm(NormType::Inf);
+        }
+        return info;
+    }
+}
+
+ExtraSolveInfo getExtraSolveInfo(const Matrix &A, const std::vector<Vector> &bs, const SolveResult &res) {
+    return extraSolveInfo(A, bs, res);
+}
+
+ExtraSolveInfo getExtraSolveInfo(const SparseMatrix &A, const std::vector<Vector> &bs, const SolveResult &res) {
+    return extraSolveInfo(A, bs, res);
 }
 
 
@@ -49,5 +470,5 @@ int sistema(double **a, double *x, double *b, int n, double tol) {
     if (not result) return 0;
     const Vector &solution = result.solution();
     std::copy(begin(solution), end(solution), x);
-    return result.getLU().perm().parity() ? -1 : 1;
+    return result.factorization()->parity() ? -1 : 1;
 }
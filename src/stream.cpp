@@ -0,0 +1,44 @@
+#include "stream.h"
+
+#include "binary.h"
+#include "errors.h"
+#include "io.h"
+#include "resol.h"
+
+
+size_t streamSolve(const LUDecomposition &luObj, std::istream &in, std::ostream &out, OutputFormat format) {
+    const size_t n = luObj.decompMatrix().size();
+    size_t count = 0;
+
+    while (in >> std::ws, in.peek() != std::char_traits<char>::eof()) {
+        const bool binary = in.peek() == (unsigned char) BinaryHeader::MAGIC[0];
+        Vector b = binary ? readBinaryVector(in) : readVector(in, n);
+        if (b.size() != n) throw BadFormat("right-hand side size differs from the matrix's");
+        Vector x = solveLU(luObj, b);
+
+        OutputWriter writer(out);
+        switch (format) {
+            case OutputFormat::Text:
+                printVector(x, writer, PRECISION);
+                break;
+            case OutputFormat::CSV:
+                for (index_t i = 0; i < n; ++i) {
+                    if (i) writer.put(',');
+                    writer.writeScientific(x[i], ROUND_TRIP_PRECISION);
+                }
+                writer.put('\n');
+                break;
+            case OutputFormat::Binary:
+                writer.flush();
+                writeBinaryVector(out, x);
+                break;
+        }
+        writer.flush();
+        out.flush();
+        ++count;
+    }
+    // the loop also ends on a failed read, which isn't the end of the input
+    if (in.fail() and not in.eof()) throw BadFormat("couldn't parse right-hand side");
+
+    return count;
+}
@@ -0,0 +1,121 @@
+#include "structure.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "errors.h"
+
+
+bool MatrixStructure::isNarrowBand(size_t n) const {
+    return double(band.lower + band.upper + 1) <= BAND_MAX_FRACTION*double(n);
+}
+
+MatrixStructure detectStructure(const Matrix &A) {
+    const size_t n = A.size();
+    MatrixStructure structure;
+    std::vector<index_t> columnStart(n);  // first row with a non-zero entry in each column (above the diagonal)
+    for (index_t j = 0; j < n; ++j) columnStart[j] = j;
+
+    for (index_t i = 0; i < n; ++i) {
+        const auto &row = A[i];
+        double offDiagonal = 0.0;
+        index_t first = i;
+        for (index_t j = 0; j < n; ++j) {
+            const double value = row[j];
+            if (value == 0.0) continue;
+            ++structure.nnz;
+            structure.band.add(i, j);
+            if (j == i) continue;
+            offDiagonal += std::abs(value);
+            if (j < i) first = std::min(first, j);
+            else columnStart[j] = std::min(columnStart[j], i);
+        }
+        structure.profile += i - first + 1;
+        structure.diagonallyDominant = structure.diagonallyDominant and std::abs(row[i]) > offDiagonal;
+        structure.positiveDiagonal = structure.positiveDiagonal and row[i] > 0.0;
+        // compare the lower part of the row with the upper part of the column (until the first mismatch)
+        for (index_t j = 0; structure.symmetric and j < i; ++j) structure.symmetric = row[j] == A[j][i];
+        // and the row with the previous one, shifted
+        for (index_t j = 1; structure.toeplitz and i > 0 and j < n; ++j) structure.toeplitz = row[j] == A[i - 1][j - 1];
+    }
+    for (index_t j = 0; j < n; ++j) structure.profile += j - columnStart[j];
+
+    return structure;
+}
+
+bool findTriangularOrder(const Matrix &A, Permutation::Vector &rowOrder, Permutation::Vector &colOrder) {
+    const size_t n = A.size();
+    rowOrder.resize(n);
+    colOrder.resize(n);
+
+    // non-zero entries of each row in the columns not taken yet
+    std::vector<size_t> count(n, 0);
+    std::vector<index_t> singletons;
+    for (index_t i = 0; i < n; ++i) {
+        for (index_t j = 0; j < n; ++j) count[i] += A[i][j] != 0.0;
+        if (count[i] == 1) singletons.push_back(i);
+    }
+
+    std::vector<char> columnTaken(n, false);
+    index_t k = 0;
+    while (not singletons.empty()) {
+        const index_t row = singletons.back();
+        singletons.pop_back();
+        index_t column = 0;
+        while (columnTaken[column] or A[row][column] == 0.0) ++column;
+
+        rowOrder[k] = row;
+        colOrder[k] = column;
+        ++k;
+        columnTaken[column] = true;
+        count[row] = 0;
+        for (index_t i = 0; i < n; ++i) {
+            if (count[i] == 0 or A[i][column] == 0.0) continue;
+            // a row left without entries would make A structurally singular
+            if (--count[i] == 0) return false;
+            if (count[i] == 1) singletons.push_back(i);
+        }
+    }
+
+    return k == n;
+}
+
+
+//-------------------- TriangularDecomposition -------------------//
+
+TriangularDecomposition::TriangularDecomposition(const Matrix &A, double tol) {
+    LUStatus status = tryFactor(A, tol);
+    if (not status) throw SingularMatrixError(tol, "at pivot " + std::to_string(status.pivot));
+}
+
+LUStatus TriangularDecomposition::tryFactor(const Matrix &A, double tol) {
+    Permutation::Vector rowOrder, colOrder;
+    if (not findTriangularOrder(A, rowOrder, colOrder)) throw MatrixError("not a permuted triangular matrix");
+    return tryFactor(A, std::move(rowOrder), std::move(colOrder), tol);
+}
+
+LUStatus TriangularDecomposition::tryFactor(const Matrix &A, Permutation::Vector rowOrder,
+                                            Permutation::Vector colOrder, double tol) {
+    _A = SparseMatrix::fromDense(A);
+    _rowOrder = std::move(rowOrder);
+    _colOrder = std::move(colOrder);
+    _tol = tol;
+
+    const size_t n = _A.size();
+    const auto &pointers = _A.pointers();
+    const auto &indices = _A.indices();
+    _pivots.assign(n, 0);
+    for (index_t k = 0; k < n; ++k) {
+        const auto first = indices.begin() + pointers[_rowOrder[k]], last = indices.begin() + pointers[_rowOrder[k] + 1];
+        const auto it = std::lower_bound(first, last, _colOrder[k]);
+        if (it == last or *it != _colOrder[k]) return LUStatus::singularAt(k);
+        _pivots[k] = index_t(it - indices.begin());
+        if (std::abs(_A.values()[_pivots[k]]) < tol) return LUStatus::singularAt(k);
+    }
+
+    return {};
+}
+
+bool TriangularDecomposition::parity() const {
+    return permutationParity(_rowOrder) != permutationParity(_colOrder);
+}
@@ -0,0 +1,149 @@
+#include "writer.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include "errors.h"
+
+
+OutputWriter::OutputWriter(std::ostream &os, size_t bufferSize) : _os(os), _buffer(bufferSize, '\0') {}
+
+OutputWriter::~OutputWriter() {
+    try { flush(); }
+    catch (...) {}  // destructors mustn't throw; call flush() explicitly to see errors
+}
+
+void OutputWriter::flush() {
+    _os.write(&_buffer[0], std::streamsize(_used));
+    _used = 0;
+    if (not _os) throw IOError("error while writing output");
+}
+
+char *OutputWriter::reserve(size_t length) {
+    if (_used + length > _buffer.size()) {
+        flush();
+        if (length > _buffer.size()) _buffer.resize(length);
+    }
+    return &_buffer[_used];
+}
+
+void OutputWriter::write(const char *str, size_t length) {
+    std::memcpy(reserve(length), str, length);
+    _used += length;
+}
+
+void OutputWriter::write(const char *str) {
+    write(str, std::strlen(str));
+}
+
+void OutputWriter::put(char c) {
+    *reserve(1) = c;
+    ++_used;
+}
+
+void OutputWriter::writeIndex(size_t value, unsigned width) {
+    char digits[std::numeric_limits<size_t>::digits10 + 1];
+    char *first = digits + sizeof digits;
+    do {
+        *--first = char('0' + value%10);
+        value /= 10;
+    } while (value);
+    const size_t length = size_t(digits + sizeof digits - first);
+
+    const size_t padding = width > length ? width - length : 0;
+    char *out = reserve(padding + length);
+    std::memset(out, ' ', padding);
+    std::memcpy(out + padding, first, length);
+    _used += padding + length;
+}
+
+void OutputWriter::writeScientific(double value, unsigned precision) {
+    char *out = reserve(32 + precision);
+    _used += formatScientific(value, precision, out);
+}
+
+
+//---------- formatScientific ----------//
+
+namespace {
+
+    // Powers of ten up to 10^27 are exact in an x87 extended precision long double.
+    const int EXACT_POWERS = 28;
+    const long double powersOf10[EXACT_POWERS] = {
+            1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L, 1e7L, 1e8L, 1e9L, 1e10L, 1e11L, 1e12L, 1e13L,
+            1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L, 1e20L, 1e21L, 1e22L, 1e23L, 1e24L, 1e25L,
+            1e26L, 1e27L
+    };
+
+    const bool haveExtendedPrecision = std::numeric_limits<long double>::digits >= 64;
+    const unsigned MAX_FAST_PRECISION = 14;
+
+    /**
+     * Try to compute the precision + 1 leading decimal digits of value > 0 (correctly rounded)
+     * and its decimal exponent. The scaling is done in extended precision; whenever the
+     * result lies so close to a rounding boundary that the scaling error could matter,
+     * give up so that the caller falls back to the (exact) C library.
+     */
+    bool fastDigits(double value, unsigned precision, uint64_t &digits, int &exponent) {
+        exponent = int(std::floor(std::log10(value)));
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            const int scale = int(precision) - exponent;
+            if (scale >= EXACT_POWERS or -scale >= EXACT_POWERS) return false;
+            const long double scaled = scale >= 0 ? value*powersOf10[scale] : value/powersOf10[-scale];
+
+            // fix off-by-one estimates of the exponent:
+            if (scaled >= powersOf10[precision + 1]) { ++exponent; continue; }
+            if (scaled < powersOf10[precision]) { --exponent; continue; }
+
+            // each step above rounds at most once, so the error is a few ulps at most:
+            const long double margin = std::ldexp(scaled, -58);
+            const long double integral = std::floor(scaled);
+            const long double fraction = scaled - integral;
+            if (std::abs(fraction - 0.5L) <= margin) return false;
+
+            digits = uint64_t(integral) + (fraction > 0.5L);
+            if (digits == uint64_t(powersOf10[precision + 1])) {  // rounding carried into a new digit
+                digits /= 10;
+                ++exponent;
+            }
+            return true;
+        }
+        return false;
+    }
+
+}
+
+size_t formatScientific(double value, unsigned precision, char *out) {
+    uint64_t digits;
+    int exponent;
+    if (not haveExtendedPrecision or precision > MAX_FAST_PRECISION or not std::isfinite(value)
+        or value == 0.0 or not fastDigits(std::abs(value), precision, digits, exponent)) {
+        // Zeros are handled here too, to get the sign of -0.0 right
+        return size_t(std::snprintf(out, 32 + precision, "%.*e", int(precision), value));
+    }
+
+    char *pos = out;
+    if (std::signbit(value)) *pos++ = '-';
+
+    char mantissa[20];
+    for (int k = int(precision); k >= 0; --k) {
+        mantissa[k] = char('0' + digits%10);
+        digits /= 10;
+    }
+    *pos++ = mantissa[0];
+    if (precision > 0) {
+        *pos++ = '.';
+        std::memcpy(pos, mantissa + 1, precision);
+        pos += precision;
+    }
+
+    *pos++ = 'e';
+    *pos++ = exponent < 0 ? '-' : '+';
+    unsigned absExponent = unsigned(std::abs(exponent));
+    if (absExponent >= 100) *pos++ = char('0' + absExponent/100);
+    *pos++ = char('0' + absExponent/10%10);
+    *pos++ = char('0' + absExponent%10);
+    return size_t(pos - out);
+}
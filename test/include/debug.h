@@ -1,7 +1,8 @@
 #ifndef LU_DEBUG_H
 #define LU_DEBUG_H
 
-#include <iosfwd>
+#include <ostream>
+#include <random>
 
 #include "Matrix.h"
 
@@ -32,4 +33,34 @@ std::ostream &operator<<(std::ostream &os, const Matrix &mat) {
     return os;
 }
 
+/// Random vector with n entries in [-1, 1]
+inline
+Vector randomVector(size_t n, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> value(-1, 1);
+    Vector v(n);
+    for (double &elem : v) elem = value(gen);
+    return v;
+}
+
+/// Random n by n matrix with entries in [-1, 1] where inPattern(i, j) holds (zero elsewhere) and the given
+/// shift added to the diagonal; only the lower triangle is drawn and mirrored if symmetric
+template<typename Pattern>
+Matrix randomMatrix(size_t n, double shift, unsigned seed, Pattern inPattern, bool symmetric = false) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> value(-1, 1);
+    Matrix mat(n);
+    for (index_t i = 0; i < n; ++i)
+        for (index_t j = 0; j < (symmetric ? i + 1 : n); ++j)
+            if (inPattern(i, j)) mat[i][j] = mat[symmetric ? j : i][symmetric ? i : j] = value(gen);
+    for (index_t i = 0; i < n; ++i) mat[i][i] += shift;
+    return mat;
+}
+
+/// Random dense n by n matrix with entries in [-1, 1] and the given shift added to the diagonal
+inline
+Matrix randomMatrix(size_t n, double shift, unsigned seed, bool symmetric = false) {
+    return randomMatrix(n, shift, seed, [](index_t, index_t) { return true; }, symmetric);
+}
+
 #endif //LU_DEBUG_H
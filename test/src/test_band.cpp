@@ -0,0 +1,118 @@
+#include <doctest.h>
+#include <string>
+#include <sstream>
+#include "debug.h"
+
+#include "BandMatrix.h"
+#include "BandLU.h"
+#include "errors.h"
+#include "extra.h"
+#include "sistema.h"
+#include "inverse.h"
+#include "io.h"
+#include "resol.h"
+
+
+TEST_SUITE("band") {
+
+    /// Random n by n matrix with kl sub-diagonals and ku super-diagonals, and diagonal entries
+    /// smaller than the rest (so that partial pivoting has to interchange rows)
+    Matrix randomBand(size_t n, size_t kl, size_t ku, unsigned seed) {
+        Matrix mat = randomMatrix(n, 0.0, seed, [=](index_t i, index_t j) { return j + kl >= i and j <= i + ku; });
+        for (index_t i = 0; i < n; ++i) mat[i][i] = 0.2*mat[i][i] + 0.2;
+        return mat;
+    }
+
+    TEST_CASE("bandwidth") {
+        const Matrix mat = {{1, 2, 0, 0},
+                            {0, 3, 0, 4},
+                            {5, 0, 6, 0},
+                            {0, 0, 0, 7}};
+        const Bandwidth band = bandwidth(mat);
+        CHECK(band.lower == 2);
+        CHECK(band.upper == 2);
+
+        const Bandwidth sparseBand = bandwidth(SparseMatrix::fromDense(mat, SparseLayout::CSC));
+        CHECK(sparseBand.lower == 2);
+        CHECK(sparseBand.upper == 2);
+
+        CHECK(bandwidth(identity(5)).lower == 0);
+        CHECK(bandwidth(identity(5)).upper == 0);
+
+        SUBCASE("readMatrix") {
+            const std::string text = "4 5\n0 0 1\n0 1 2\n3 0 4\n1 1 0\n2 2 1\n";
+            Scanner scanner(text.data(), text.data() + text.size());
+            Bandwidth read;
+            const Matrix A = readMatrix(scanner, read);
+            CHECK(A[3][0] == 4);
+            CHECK(read.lower == 3);
+            CHECK(read.upper == 1);
+        }
+    }
+
+    TEST_CASE("band storage") {
+        const Matrix mat = randomBand(8, 2, 1, 3);
+        const BandMatrix A = BandMatrix::fromDense(mat);
+        CHECK(A.lower() == 2);
+        CHECK(A.upper() == 1);
+        CHECK(A.ldab() == 6);
+        CHECK(A.toDense() == mat);
+        CHECK(A(0, 7) == 0.0);
+        CHECK_THROWS_AS(A(8, 0), std::out_of_range);
+
+        BandMatrix B = BandMatrix::fromSparse(SparseMatrix::fromDense(mat));
+        CHECK(B.toDense() == mat);
+        CHECK_THROWS_AS(B.set(0, 2, 1.0), std::out_of_range);
+        CHECK_THROWS_AS(BandMatrix::fromDense(mat, 1, 1), MatrixError);
+
+        const Vector v = {1, -2, 3, 0, 5, 1, -1, 2};
+        const Vector Av = A*v, expected = mat*v;
+        for (index_t i = 0; i < 8; ++i) CHECK(Av[i] == doctest::Approx(expected[i]));
+    }
+
+    TEST_CASE("band LU") {
+        SUBCASE("random") {
+            const size_t n = 200;
+            for (auto kl_ku : {std::make_pair(0, 0), std::make_pair(1, 1), std::make_pair(3, 1),
+                               std::make_pair(1, 4), std::make_pair(5, 5)}) {
+                const Matrix mat = randomBand(n, kl_ku.first, kl_ku.second, unsigned(n + kl_ku.first));
+                const BandLUDecomposition lu(BandMatrix::fromDense(mat));
+                Vector b(n);
+                for (index_t i = 0; i < n; ++i) b[i] = double(i%5) - 2;
+                CHECK(residue(mat, solveLU(lu, b), b) < 1e-10);
+                CHECK(residue(SparseMatrix::fromDense(mat).transposed(), solveLUTransposed(lu, b), b) < 1e-10);
+
+                // the fill stays within kl + ku super-diagonals
+                CHECK(lu.factors().upper() == size_t(kl_ku.second));
+            }
+        }
+
+        SUBCASE("small") {
+            const Matrix mat = {{1, 2, 0},
+                                {4, 5, 6},
+                                {0, 8, 9}};
+            const BandLUDecomposition lu(BandMatrix::fromDense(mat));
+            const Vector x = solveLU(lu, Vector{5, 32, 43});
+            CHECK(x[0] == doctest::Approx(1));
+            CHECK(x[1] == doctest::Approx(2));
+            CHECK(x[2] == doctest::Approx(3));
+            CHECK(lu.perm()[0] == 1);
+            const BandMatrix &U = lu.factors();
+            CHECK((lu.parity() ? -1 : 1)*U.at(0, 0)*U.at(1, 1)*U.at(2, 2) == doctest::Approx(determinant(mat)));
+            CHECK_THROWS_AS(solveLU(lu, Vector{1, 2}), std::invalid_argument);
+        }
+
+        SUBCASE("singular") {
+            const Matrix mat = {{1, 2, 0, 0},
+                                {2, 4, 0, 0},
+                                {0, 0, 1, 1},
+                                {0, 0, 1, 2}};
+            BandLUDecomposition lu;
+            const LUStatus status = lu.tryFactor(BandMatrix::fromDense(mat));
+            CHECK(not status);
+            CHECK(status.pivot == 1);
+            CHECK_THROWS_AS(BandLUDecomposition(BandMatrix(3, 1, 1), numcomp::DEFAULT_TOL), SingularMatrixError);
+        }
+    }
+
+}
@@ -0,0 +1,112 @@
+#include <doctest.h>
+#include "debug.h"
+
+#include "Cholesky.h"
+#include "PackedMatrix.h"
+#include "errors.h"
+#include "extra.h"
+#include "inverse.h"
+#include "resol.h"
+#include "sistema.h"
+
+
+TEST_SUITE("cholesky") {
+
+    TEST_CASE("packed storage") {
+        const Matrix mat = {{4, 1, 2},
+                            {1, 3, 0},
+                            {2, 0, 5}};
+        const PackedMatrix A = PackedMatrix::fromDense(mat);
+        CHECK(A.data().size() == 6);
+        CHECK(A(0, 2) == 2.0);
+        CHECK(A(2, 0) == 2.0);
+        CHECK(A.at(1, 1) == 3.0);
+        CHECK(A.toDense() == mat);
+        CHECK_THROWS_AS(A(3, 0), std::out_of_range);
+
+        const Vector v = {1, -2, 3}, Av = A*v, expected = mat*v;
+        for (index_t i = 0; i < 3; ++i) CHECK(Av[i] == doctest::Approx(expected[i]));
+    }
+
+    TEST_CASE("Cholesky decomposition") {
+        const size_t n = 300;  // several blocks, and enough trailing rows to go parallel
+        const Matrix A = randomMatrix(n, double(n), 3, true);
+        const CholeskyDecomposition chol(A);
+
+        // LL^T = A
+        const PackedMatrix &L = chol.factor();
+        for (index_t i = 0; i < n; i += 7)
+            for (index_t j = 0; j <= i; j += 5) {
+                double sum = 0.0;
+                for (index_t k = 0; k <= j; ++k) sum += L.at(i, k)*L.at(j, k);
+                CHECK(sum == doctest::Approx(A[i][j]).epsilon(1e-12));
+            }
+
+        const CholeskyDecomposition parallel(PackedMatrix::fromDense(A), numcomp::DEFAULT_TOL, true);
+        for (index_t p = 0; p < L.data().size(); ++p)
+            CHECK(parallel.factor().data()[p] == doctest::Approx(L.data()[p]).epsilon(1e-14));
+
+        Vector x(n);
+        for (index_t i = 0; i < n; ++i) x[i] = double(i%9) - 4;
+        const Vector y = solveCholesky(chol, A*x);
+        for (index_t i = 0; i < n; ++i) CHECK(y[i] == doctest::Approx(x[i]));
+
+        SUBCASE("determinant and inverse") {
+            const Matrix small = {{4, 2, 0},
+                                  {2, 5, 1},
+                                  {0, 1, 3}};
+            const CholeskyDecomposition smallChol(small);
+            CHECK(determinant(smallChol) == doctest::Approx(determinant(small)));
+            CHECK(inverse(smallChol) == inverse(small));
+        }
+
+        SUBCASE("not positive definite") {
+            const Matrix indefinite = {{1, 2},
+                                       {2, 1}};
+            CholeskyDecomposition failed;
+            const LUStatus status = failed.tryFactor(indefinite);
+            CHECK(not status);
+            CHECK(status.pivot == 1);
+            CHECK_THROWS_AS(CholeskyDecomposition(indefinite, numcomp::DEFAULT_TOL), SingularMatrixError);
+        }
+    }
+
+    TEST_CASE("Bunch-Kaufman LDL^T decomposition") {
+        SUBCASE("2x2 pivot") {
+            // a zero diagonal forces a 2x2 block
+            const Matrix A = {{0, 2, 1},
+                              {2, 0, 3},
+                              {1, 3, 0}};
+            const LDLTDecomposition ldl(A);
+            bool twoByTwo = false;
+            for (index_t k = 0; k < 3; ++k) twoByTwo = twoByTwo or ldl.isTwoByTwo(k);
+            CHECK(twoByTwo);
+            CHECK(determinant(ldl) == doctest::Approx(determinant(A)));
+            CHECK(inverse(ldl) == inverse(A));
+            const Vector x = {1, -1, 2}, y = solveLDLT(ldl, A*x);
+            for (index_t i = 0; i < 3; ++i) CHECK(y[i] == doctest::Approx(x[i]));
+        }
+
+        SUBCASE("indefinite") {
+            const size_t n = 120;
+            const Matrix A = randomMatrix(n, 0.0, 5, true);
+            const LDLTDecomposition ldl(A);
+            std::vector<Vector> bs(3, Vector(n));
+            for (index_t r = 0; r < 3; ++r)
+                for (index_t i = 0; i < n; ++i) bs[r][i] = double((r + 2)*(i + 1)%13) - 6;
+            const std::vector<Vector> xs = solveLDLT(ldl, bs);
+            for (index_t r = 0; r < 3; ++r) CHECK(residue(A, xs[r], bs[r]) < 1e-10);
+            CHECK(determinant(ldl)/determinant(A) == doctest::Approx(1.0));
+        }
+
+        SUBCASE("singular") {
+            const Matrix A = {{1, 2, 3},
+                              {2, 4, 6},
+                              {3, 6, 9}};
+            LDLTDecomposition failed;
+            CHECK(not failed.tryFactor(A));
+            CHECK_THROWS_AS(LDLTDecomposition(A, numcomp::DEFAULT_TOL), SingularMatrixError);
+        }
+    }
+
+}
@@ -1,3 +1,11 @@
-#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#define DOCTEST_CONFIG_IMPLEMENT
 #define DOCTEST_CONFIG_NO_POSIX_SIGNALS
 #include <doctest.h>
+#include <algorithm>
+#include "ThreadPool.h"
+
+int main(int argc, char **argv) {
+    // make sure the parallel code paths are exercised even on single core machines
+    ThreadPool::configureShared(std::max(4u, ThreadPool::hardwareConcurrency()));
+    return doctest::Context(argc, argv).run();
+}
@@ -0,0 +1,310 @@
+#include <doctest.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+#include "debug.h"
+
+#include "io.h"
+#include "binary.h"
+#include "writer.h"
+#include "stream.h"
+#include "resol.h"
+#include "errors.h"
+
+
+Scanner scan(const std::string &str) {
+    return Scanner(str.data(), str.data() + str.size());
+}
+
+
+TEST_SUITE("io") {
+
+    TEST_CASE("scanner") {
+        SUBCASE("indices") {
+            std::string text = "  12\n0 \t 7";
+            Scanner scanner = scan(text);
+            CHECK(scanner.readIndex("") == 12);
+            CHECK(scanner.readIndex("") == 0);
+            CHECK(scanner.readIndex("") == 7);
+            CHECK(scanner.atEnd());
+            CHECK_THROWS_AS(scanner.readIndex(""), BadFormat);
+        }
+
+        SUBCASE("doubles") {
+            const char *samples[] = {
+                    "0", "-0", "1", "-2.5", "3.14159265358979", "1e10", "1E-10", "+7.25e+2",
+                    "0.1", "123456789012345678", "1.7976931348623157e308", "4.9e-324",
+                    "2.2250738585072014e-308", "0.30000000000000004", "1234567890.0987654321e-5",
+                    ".5", "5.", "inf", "-nan", "1e400",
+            };
+            for (const char *sample : samples) {
+                std::string text = sample;
+                Scanner scanner = scan(text);
+                double expected = std::strtod(sample, nullptr);
+                double actual = scanner.readDouble("");
+                CAPTURE(sample);
+                if (expected != expected) CHECK(actual != actual);
+                else CHECK(std::memcmp(&expected, &actual, sizeof(double)) == 0);
+                CHECK(scanner.atEnd());
+            }
+        }
+
+        SUBCASE("errors") {
+            std::string text = "1 2x 3";
+            Scanner scanner = scan(text);
+            scanner.readIndex("");
+            try {
+                scanner.readDouble("bad number");
+                FAIL("expected BadFormat");
+            } catch (BadFormat &e) {
+                CHECK(std::string(e.what()) == "bad input format (bad number at byte 2)");
+            }
+        }
+    }
+
+    TEST_CASE("read") {
+        std::string text = "3 4\n0 0 1.5\n1 1 2\n2 2 -3e0\n0 2 4\n2\n0 1\n2 -1\n";
+        Scanner scanner = scan(text);
+        Matrix A = readMatrix(scanner);
+        CHECK(A == Matrix{{1.5, 0, 4},
+                          {0,   2, 0},
+                          {0,   0, -3}});
+        Vector b = readVector(scanner, A.size());
+        CHECK((b == Vector{1, 0, -1}).min());
+        CHECK(scanner.atEnd());
+
+        SUBCASE("out of range") {
+            std::string bad = "2 1\n0 2 1\n";
+            Scanner badScanner = scan(bad);
+            CHECK_THROWS_AS(readMatrix(badScanner), BadFormat);
+        }
+
+        SUBCASE("truncated") {
+            std::string bad = "2 2\n0 0 1\n";
+            Scanner badScanner = scan(bad);
+            CHECK_THROWS_AS(readMatrix(badScanner), BadFormat);
+        }
+    }
+
+    TEST_CASE("multiple right-hand sides") {
+        const char *path = "LU_test_multi.DAT";
+        {
+            std::ofstream file(path);
+            file << "2 2\n0 0 2\n1 1 4\n1\n0 1\n\n2\n0 -1\n1 8\n0\n";
+        }
+        Matrix A;
+        std::vector<Vector> bs;
+        readSystem(MappedFile(path), A, bs);
+        REQUIRE(bs.size() == 3);
+        CHECK((bs[0] == Vector{1, 0}).min());
+        CHECK((bs[1] == Vector{-1, 8}).min());
+        CHECK((bs[2] == Vector{0, 0}).min());
+
+        {
+            std::ofstream file(path);
+            file << "2 1\n0 0 2\n";
+        }
+        readSystem(MappedFile(path), A, bs);
+        REQUIRE(bs.size() == 1);  // a missing vector is the null vector
+        CHECK((bs[0] == Vector{0, 0}).min());
+        std::remove(path);
+    }
+
+    TEST_CASE("parallel read") {
+        // large enough to go through the chunked parser, with repeated entries
+        // and triplets that span lines
+        const size_t n = 500, m = 200000;
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<index_t> index(0, n - 1);
+        std::uniform_real_distribution<double> value(-1e3, 1e3);
+
+        std::ostringstream oss;
+        oss.precision(17);
+        oss << n << ' ' << m << '\n';
+        for (index_t k = 0; k < m; ++k)
+            oss << index(gen) << (k%7 == 0 ? "\n" : " ") << index(gen) << ' ' << value(gen) << '\n';
+        oss << "1\n0 1\n";
+        const std::string text = oss.str();
+        REQUIRE(text.size() > (size_t(1) << 22));
+
+        std::istringstream iss(text);
+        Matrix expected = readMatrix(iss);
+        Scanner scanner = scan(text);
+        CHECK(readMatrix(scanner) == expected);
+        Vector b = readVector(scanner, n);
+        CHECK(b[0] == 1.0);
+        CHECK(scanner.atEnd());
+
+        SUBCASE("sparse") {
+            Scanner sparseScanner = scan(text);
+            CHECK(readSparseMatrix(sparseScanner).toDense() == expected);
+        }
+
+        SUBCASE("bandwidth") {
+            Scanner bandScanner = scan(text);
+            Bandwidth band;
+            CHECK(readMatrix(bandScanner, band) == expected);
+            CHECK(band.lower == bandwidth(expected).lower);
+            CHECK(band.upper == bandwidth(expected).upper);
+        }
+
+        SUBCASE("truncated") {
+            std::string bad = text.substr(0, text.find('\n', text.size()/2));
+            Scanner badScanner = scan(bad);
+            CHECK_THROWS_AS(readMatrix(badScanner), BadFormat);
+        }
+    }
+
+    TEST_CASE("binary") {
+        const char *path = "LU_test_binary.BIN";
+        Matrix A = {{1, 0, -2.5},
+                    {0, 3,    0},
+                    {4, 0,    5}};
+        Vector b = {1, 0, -1};
+
+        for (BinaryLayout layout : {BinaryLayout::Dense, BinaryLayout::Triplets}) {
+            {
+                std::ofstream out(path, std::ios::binary);
+                writeBinaryMatrix(out, A, layout);
+                writeBinaryVector(out, b, layout);
+            }
+            MappedFile file(path);
+            REQUIRE(isBinary(file));
+
+            BinaryMatrix binA = mapBinaryMatrix(file);
+            CHECK(binA.n == 3);
+            CHECK(binA.end % 64 == 0);
+            CHECK(binA.toMatrix() == A);
+            if (layout == BinaryLayout::Dense) {
+                CHECK(binA.nnz == 9);
+                CHECK(binA.view()(2, 0) == 4);
+                CHECK((binA.view()*b == A*b).min());
+            } else {
+                CHECK(binA.nnz == 5);
+                CHECK_THROWS_AS(binA.view(), ValueError);
+            }
+            CHECK((mapBinaryVector(file, binA.end).toVector() == b).min());
+
+            Matrix A2;
+            Vector b2;
+            readSystem(file, A2, b2);
+            CHECK(A2 == A);
+            CHECK((b2 == b).min());
+        }
+
+        SUBCASE("corrupted") {
+            {
+                std::fstream io(path, std::ios::in | std::ios::out | std::ios::binary);
+                io.seekp(70);
+                io.put('x');
+            }
+            MappedFile file(path);
+            CHECK_THROWS_AS(mapBinaryMatrix(file), BadFormat);
+            CHECK_NOTHROW(mapBinaryMatrix(file, 0, false));
+        }
+
+        SUBCASE("overflowing entry count") {
+            // nnz + 2^61 triplets take the same payload size modulo 2^64, and fit a huge dimension
+            {
+                std::fstream io(path, std::ios::in | std::ios::out | std::ios::binary);
+                BinaryHeader header;
+                io.read(reinterpret_cast<char *>(&header), sizeof header);
+                header.n = UINT32_MAX;
+                header.nnz += uint64_t(1) << 61u;
+                io.seekp(0);
+                io.write(reinterpret_cast<const char *>(&header), sizeof header);
+            }
+            MappedFile file(path);
+            CHECK_THROWS_AS(mapBinaryMatrix(file, 0, false), BadFormat);
+        }
+
+        std::remove(path);
+    }
+
+    TEST_CASE("formatScientific") {
+        std::mt19937_64 gen(7);
+        std::uniform_real_distribution<double> mantissa(1.0, 10.0);
+        std::uniform_int_distribution<int> exponent(-320, 310);
+        char expected[64], actual[64];
+
+        auto check = [&](double value, unsigned precision) {
+            std::snprintf(expected, sizeof expected, "%.*e", int(precision), value);
+            size_t length = formatScientific(value, precision, actual);
+            actual[length] = '\0';
+            CAPTURE(expected);
+            REQUIRE(std::string(actual) == expected);
+        };
+
+        for (double special : {0.0, -0.0, 1.0, -1.0, 0.5, 9.9999999999995, 9.99999999999949,
+                               1.0000000000005, 2.5e-13, 1e22, 1e23, 5e-324, 1.7976931348623157e308,
+                               std::nan(""), -HUGE_VAL})
+            for (unsigned precision = 0; precision <= 16; ++precision) check(special, precision);
+
+        for (int k = 0; k < 200000; ++k) {
+            double value = mantissa(gen)*std::pow(10.0, exponent(gen)/10);
+            if (k%2) value = -value;
+            check(value, 12);
+            check(value, unsigned(k%17));
+        }
+
+        // ties in decimal (exactly representable halves):
+        for (int k = 1; k < 4096; ++k) check(k/8.0 + 1e4, 4);
+    }
+
+    TEST_CASE("printVector") {
+        Vector vec = {1.5, -0.0, -2.25e-300, 0.0, 123456789.123, std::nan("")};
+        Permutation::Vector perm = {3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5};
+
+        std::ostringstream expected;
+        expected.precision(12);
+        for (index_t i = 0; i < vec.size(); ++i)
+            expected << std::setw(1) << i << " \t" << (vec[i] >= 0 ? " " : "") << std::scientific << vec[i] << '\n';
+        expected << "\npermutation vector:\n";
+        for (index_t i = 0; i < perm.size(); ++i)
+            expected << std::setw(2) << i << " \t" << " " << std::scientific << perm[i] << '\n';
+        expected << '\n';
+
+        std::ostringstream actual;
+        actual.precision(12);
+        printVector(vec, actual);
+        printVector(perm, actual, "permutation vector");
+        CHECK(actual.str() == expected.str());
+    }
+
+    TEST_CASE("streamSolve") {
+        Matrix A = {{2, 1, 0},
+                    {1, 3, 1},
+                    {0, 1, 4}};
+        LUDecomposition luObj(A);
+        Vector b1 = {1, 0, 0}, b2 = {0, 2, -1};
+
+        std::stringstream in;
+        in << "1\n0 1\n";
+        writeBinaryVector(in, b2);
+        in << "\n0\n";
+
+        std::ostringstream out;
+        CHECK(streamSolve(luObj, in, out, OutputFormat::Binary) == 3);
+
+        std::istringstream answers(out.str());
+        CHECK((readBinaryVector(answers) == solveLU(luObj, b1)).min());
+        CHECK((readBinaryVector(answers) == solveLU(luObj, b2)).min());
+        CHECK((readBinaryVector(answers) == Vector(0.0, 3)).min());
+        CHECK(answers.peek() == std::char_traits<char>::eof());
+
+        std::istringstream bad("1\n5 1\n");
+        CHECK_THROWS_AS(streamSolve(luObj, bad, out), BadFormat);
+        // a non-numeric count mustn't read as a null vector and end the stream
+        std::istringstream nonNumeric("abc\n2 0 1 1 1\n");
+        CHECK_THROWS_AS(streamSolve(luObj, nonNumeric, out), BadFormat);
+        std::istringstream badCount("x 0 1");
+        CHECK_THROWS_AS(readVector(badCount, 3), BadFormat);
+    }
+
+}
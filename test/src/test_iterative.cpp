@@ -0,0 +1,171 @@
+#include <doctest.h>
+#include <cmath>
+#include <sstream>
+#include "debug.h"
+
+#include "iterative.h"
+#include "errors.h"
+#include "io.h"
+#include "norm.h"
+#include "sistema.h"
+
+
+TEST_SUITE("iterative") {
+
+    // Convection-diffusion on a side by side grid (5-point stencil, non-symmetric)
+    SparseMatrix gridMatrix(size_t side) {
+        const size_t n = side*side;
+        TripletBuilder builder(n);
+        for (index_t i = 0; i < side; ++i)
+            for (index_t j = 0; j < side; ++j) {
+                const index_t k = i*side + j;
+                builder.add(k, k, 4);
+                if (i > 0) builder.add(k, k - side, -1.2);
+                if (i + 1 < side) builder.add(k, k + side, -0.8);
+                if (j > 0) builder.add(k, k - 1, -1.1);
+                if (j + 1 < side) builder.add(k, k + 1, -0.9);
+            }
+        return builder.build<index_t>();
+    }
+
+    Vector rhs(size_t n) {
+        Vector b(n);
+        for (index_t i = 0; i < n; ++i) b[i] = double(i%7) - 3;
+        return b;
+    }
+
+    TEST_CASE("incomplete LU") {
+        SUBCASE("exact on a tridiagonal matrix") {
+            // no fill-in: ILU(0) is the complete factorization
+            const Matrix dense = {{4, 1, 0, 0},
+                                  {2, 5, 1, 0},
+                                  {0, 1, 3, 1},
+                                  {0, 0, 2, 6}};
+            const SparseMatrix A = SparseMatrix::fromDense(dense);
+            const Vector b = {1, 2, 3, 4};
+            IncompleteLU ilu0, ilut;
+            REQUIRE(ilu0.factorILU0(A));
+            REQUIRE(ilut.factorILUT(A, 0.0, 4));
+            CHECK(ilu0.nnz() == A.nnz());
+            CHECK(residue(A, ilu0.apply(b), b) < 1e-15);
+            CHECK(residue(A, ilut.apply(b), b) < 1e-15);
+        }
+
+        SUBCASE("fill") {
+            const SparseMatrix A = gridMatrix(20);
+            IncompleteLU ilu0, ilut;
+            REQUIRE(ilu0.factorILU0(A));
+            REQUIRE(ilut.factorILUT(A, 1e-3, 20));
+            CHECK(ilu0.nnz() == A.nnz());
+            CHECK(ilut.nnz() > A.nnz());
+            CHECK(ilut.nnz() <= A.size()*41);
+
+            // a better approximation of A^-1
+            const Vector b = rhs(A.size());
+            CHECK(norm2(b - A*ilut.apply(b)) < norm2(b - A*ilu0.apply(b)));
+        }
+
+        SUBCASE("zero pivot") {
+            IncompleteLU M;
+            const SparseMatrix A = SparseMatrix::fromDense(Matrix{{0, 1}, {1, 0}});
+            LUStatus status = M.factorILU0(A);
+            CHECK(not status);
+            CHECK(status.pivot == 0);
+            CHECK(not M.factorILUT(A));
+            CHECK_THROWS_AS(solveIterative(A, Vector{1, 1}, IterativeOptions()), SingularMatrixError);
+        }
+    }
+
+    TEST_CASE("Krylov solvers") {
+        const SparseMatrix A = gridMatrix(30);
+        const Vector b = rhs(A.size());
+
+        for (auto method : {IterativeMethod::GMRES, IterativeMethod::BiCGSTAB}) {
+            size_t unpreconditioned = 0;
+            for (auto preconditioner : {Preconditioner::None, Preconditioner::ILU0, Preconditioner::ILUT}) {
+                IterativeOptions options;
+                options.method = method;
+                options.preconditioner = preconditioner;
+                const IterativeResult result = solveIterative(A, b, options);
+                CHECK(result.converged);
+                CHECK(result.residual <= options.tol);
+                CHECK(norm2(b - A*result.x)/norm2(b) == doctest::Approx(result.residual));
+                if (preconditioner == Preconditioner::None) unpreconditioned = result.iterations;
+                else CHECK(result.iterations < unpreconditioned);
+            }
+        }
+
+        SUBCASE("iteration cap") {
+            IterativeOptions options;
+            options.preconditioner = Preconditioner::None;
+            options.maxIterations = 5;
+            for (auto method : {IterativeMethod::GMRES, IterativeMethod::BiCGSTAB}) {
+                options.method = method;
+                const IterativeResult result = solveIterative(A, b, options);
+                CHECK(not result.converged);
+                CHECK(result.iterations == 5);
+                CHECK(result.residual > options.tol);
+            }
+        }
+
+        SUBCASE("initial guess") {
+            IterativeOptions options;
+            const Vector x = solveIterative(A, b, options).x;
+            const IterativeResult result = gmres(A, b, nullptr, options, x);
+            CHECK(result.converged);
+            CHECK(result.iterations == 0);
+            CHECK(gmres(A, Vector(0.0, A.size()), nullptr, options).converged);
+        }
+    }
+
+    TEST_CASE("BiCGSTAB breakdown") {
+        // nonsingular, but r^ A r^ = 0 for r^ = b: the first step length is undefined
+        TripletBuilder builder(2);
+        builder.add(0, 1, 1);
+        builder.add(1, 0, 1);
+        const SparseMatrix A = builder.build<index_t>();
+        const Vector b = {1, 0};
+        IterativeOptions options;
+        options.preconditioner = Preconditioner::None;
+
+        options.method = IterativeMethod::BiCGSTAB;
+        const IterativeResult result = solveIterative(A, b, options);
+        CHECK(not result.converged);
+        CHECK(std::isfinite(result.residual));
+        CHECK((result.x == result.x).min());  // no NaN
+
+        options.method = IterativeMethod::GMRES;
+        CHECK(solveIterative(A, b, options).converged);
+    }
+
+    TEST_CASE("iterative solve mode") {
+        const SparseMatrix A = gridMatrix(15);
+        const std::vector<Vector> bs = {rhs(A.size()), Vector(1.0, A.size())};
+        IterativeOptions options;
+        options.method = IterativeMethod::BiCGSTAB;
+
+        auto result = solve(A, bs, options);
+        REQUIRE(result);
+        CHECK(result.isIterative());
+        CHECK(result.converged());
+        CHECK(result.perm().size() == 0);
+        CHECK(not result.factorization());
+        REQUIRE(result.iterations().size() == 2);
+        for (index_t k = 0; k < 2; ++k) {
+            CHECK(result.iterations()[k] > 0);
+            CHECK(result.iterativeResiduals()[k] <= options.tol);
+            CHECK(residue(A, result.solutions()[k], bs[k]) < 1e-9);
+        }
+
+        std::ostringstream oss;
+        printResult(result, getExtraSolveInfo(A, bs, result), oss);
+        CHECK(oss.str().find("iterations 2: ") != std::string::npos);
+        CHECK(oss.str().find("condition number") == std::string::npos);
+
+        options.maxIterations = 1;
+        result = solve(A, bs, options);
+        REQUIRE(result);
+        CHECK(not result.converged());
+    }
+
+}
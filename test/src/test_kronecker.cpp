@@ -0,0 +1,68 @@
+#include <doctest.h>
+#include "debug.h"
+
+#include "Kronecker.h"
+#include "errors.h"
+#include "norm.h"
+#include "resol.h"
+
+
+TEST_SUITE("Kronecker") {
+
+    Vector rightHandSide(size_t n) {
+        Vector v(n);
+        for (index_t i = 0; i < n; ++i) v[i] = double(i%7) - 3;
+        return v;
+    }
+
+    TEST_CASE("Kronecker product") {
+        const Matrix A = {{1, 2}, {3, 4}}, B = {{0, 5}, {6, 7}};
+        const Matrix AB = kroneckerProduct(A, B);
+        CHECK(AB == Matrix{{0, 5, 0, 10}, {6, 7, 12, 14}, {0, 15, 0, 20}, {18, 21, 24, 28}});
+
+        const Vector x = {1, -1, 2, 3}, product = kroneckerProduct({A, B}, x), expected = AB*x;
+        for (index_t i = 0; i < 4; ++i) CHECK(product[i] == doctest::Approx(expected[i]));
+        CHECK_THROWS_AS(kroneckerProduct({A, B}, Vector(3)), MatrixError);
+        CHECK_THROWS_AS(kroneckerProduct(std::vector<Matrix>{}, x), MatrixError);
+        CHECK_THROWS_AS(kroneckerProduct({A, Matrix(0), B}, Vector()), MatrixError);
+    }
+
+    TEST_CASE("Kronecker solver") {
+        // small: against the LU decomposition of the product itself
+        const Matrix A = randomMatrix(7, 0.0, 1), B = randomMatrix(5, 0.0, 2);
+        const KroneckerSystem kronObj(A, B);
+        CHECK(kronObj.size() == 35);
+        const Matrix AB = kroneckerProduct(A, B);
+        const LUDecomposition luObj(AB);
+        const Vector c = rightHandSide(35);
+        const Vector x = solveLU(kronObj, c), expected = solveLU(luObj, c);
+        for (index_t i = 0; i < 35; ++i) CHECK(x[i] == doctest::Approx(expected[i]).epsilon(1e-10));
+        const Vector y = solveLUTransposed(kronObj, c), expectedT = solveLUTransposed(luObj, c);
+        for (index_t i = 0; i < 35; ++i) CHECK(y[i] == doctest::Approx(expectedT[i]).epsilon(1e-10));
+
+        SUBCASE("three factors, in parallel") {
+            const std::vector<Matrix> factors = {randomMatrix(30, 4.0, 3), randomMatrix(40, 0.0, 4),
+                                                 randomMatrix(50, 2.0, 5)};
+            const KroneckerSystem large(factors);
+            REQUIRE(large.size() >= KRONECKER_PARALLEL_MIN_SIZE);
+            const Vector b = rightHandSide(large.size());
+            const std::vector<Vector> xs = solveLU(large, std::vector<Vector>{b, 2.0*b});
+            const Vector residual = kroneckerProduct(factors, xs[0]) - b;
+            CHECK(normInf(residual) < 1e-9*normInf(b));
+            for (index_t i = 0; i < large.size(); ++i) CHECK(xs[1][i] == doctest::Approx(2.0*xs[0][i]));
+        }
+
+        SUBCASE("singular factor") {
+            Matrix singular = B;
+            singular[3] = singular[1];
+            KroneckerSystem failed;
+            CHECK(not failed.tryFactor({A, singular}));
+            CHECK(failed.failedFactor() == 1);
+            CHECK_THROWS_AS(KroneckerSystem(singular, A), SingularMatrixError);
+            CHECK_THROWS_AS(failed.tryFactor({}), MatrixError);
+            CHECK_THROWS_AS(failed.tryFactor({A, Matrix(0)}), MatrixError);
+            CHECK_THROWS_AS(KroneckerSystem(Matrix(0), B), MatrixError);
+        }
+    }
+
+}
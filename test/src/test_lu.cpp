@@ -108,6 +108,99 @@ TEST_SUITE("lu") {
 
     }
 
+    TEST_CASE("tryFactor") {
+        LUDecomposition lu;
+
+        LUStatus status = lu.tryFactor(Matrix{{0, 0},
+                                              {0, 0}});
+        CHECK(not status);
+        CHECK(status.pivot == 0);
+
+        status = lu.tryFactor(Matrix{{1, 0, 0},
+                                     {0, 1, 1},
+                                     {1, 1, 1}});
+        CHECK(not status);
+        CHECK(status.pivot == 2);
+
+        Matrix test2 = {{ 2, 5},
+                        {-1, 1}};
+        status = lu.tryFactor(test2);
+        CHECK(status);
+        CHECK(lu.decompMatrix() == LUDecomposition(test2).decompMatrix());
+        CHECK(lu.perm().parity());
+    }
+
+    TEST_CASE("bordering") {
+        const Matrix A = {{ 2, 5, 1, 0},
+                          {-1, 1, 3, 2},
+                          { 4, 0, 1, 1},
+                          { 1, 2, 0, 5}};
+        const size_t n = A.size();
+        auto leading = [&](size_t m) {
+            Matrix block(m);
+            for (index_t i = 0; i < m; ++i) block[i] = A[i][std::slice(0, m, 1)];
+            return block;
+        };
+        auto checkFactors = [&](const LUDecomposition &lu, size_t m) {
+            // P A = L U, row by row
+            const Matrix &LU = lu.decompMatrix();
+            REQUIRE(LU.size() == m);
+            REQUIRE(lu.perm().vector().size() == m);
+            for (index_t i = 0; i < m; ++i)
+                for (index_t j = 0; j < m; ++j) {
+                    double elem = 0.0;
+                    for (index_t k = 0; k <= std::min(i, j); ++k) elem += (k == i ? 1.0 : LU[i][k])*LU[k][j];
+                    CHECK(elem == doctest::Approx(A[lu.perm().vector()[i]][j]));
+                }
+        };
+
+        // grow from the 2 by 2 leading block, which has to pivot
+        LUDecomposition lu(leading(2));
+        for (size_t m = 2; m < n; ++m) {
+            Vector row(m), col(m);
+            for (index_t j = 0; j < m; ++j) {
+                row[j] = A[m][j];
+                col[j] = A[j][m];
+            }
+            REQUIRE(lu.appendRowCol(row, col, A[m][m]));
+            checkFactors(lu, m + 1);
+        }
+        CHECK(lu.perm().parity() == LUDecomposition(leading(2)).perm().parity());
+
+        // back: the bordered rows first, then a pivoted one (rebuilt and refactored)
+        for (size_t m = n - 1; m >= 1; --m) {
+            REQUIRE(lu.removeLast());
+            checkFactors(lu, m);
+        }
+        CHECK_THROWS_AS(lu.appendRowCol(Vector(2), Vector(1), 1.0), MatrixError);
+
+        SUBCASE("singular border") {
+            LUDecomposition singular(leading(2));
+            const LUStatus status = singular.appendRowCol({4, 10}, {1, 3}, 2.0);  // twice the first row
+            CHECK(not status);
+            CHECK(status.pivot == 2);
+            CHECK(singular.decompMatrix() == LUDecomposition(leading(2)).decompMatrix());
+        }
+
+        SUBCASE("scaled pivot") {
+            // a border of small entries: its pivot d - r A^-1 c is small, but not relative to them
+            LUDecomposition small(Matrix{{4, 1}, {1, 3}});
+            REQUIRE(small.appendRowCol({1e-14, 2e-14}, {1, 1}, 1e-13));
+            CHECK(small.decompMatrix()[2][2] == doctest::Approx(1e-13 - 8e-14/11));
+            // a border of large entries, twice the first row but for diag: its pivot is rounding noise
+            LUDecomposition large(leading(2));
+            CHECK(not large.appendRowCol({4e13, 1e14}, {1, 3}, 2e13 + 0.01));
+        }
+
+        SUBCASE("empty") {
+            LUDecomposition empty(Matrix(0));
+            REQUIRE(empty.appendRowCol({}, {}, 3.0));
+            CHECK(empty.decompMatrix() == Matrix{{3}});
+            REQUIRE(empty.removeLast());
+            CHECK_THROWS_AS(empty.removeLast(), MatrixError);
+        }
+    }
+
     TEST_CASE("array") {
         auto a = newmat(2);
         int perm[2];
@@ -3,12 +3,17 @@
 //
 
 #include <doctest.h>
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 
 #include "debug.h"
 #include "inverse.h"
 #include "norm.h"
 #include "extra.h"
+#include "ThreadPool.h"
+#include "BoundedQueue.h"
+#include "errors.h"
 
 
 TEST_SUITE ("inverse") {
@@ -37,3 +42,43 @@ TEST_SUITE ("inverse") {
     }
 
 }
+
+
+TEST_SUITE ("threads") {
+
+    TEST_CASE ("parallelFor") {
+        ThreadPool pool(3);
+        std::vector<int> hits(1000, 0);
+        parallelFor(pool, hits.size(), [&](index_t i) { ++hits[i]; });
+        CHECK(std::count(hits.begin(), hits.end(), 1) == 1000);
+
+        CHECK_THROWS_AS(parallelFor(pool, 10, [](index_t i) { if (i == 5) throw ValueError("test"); }),
+                        ValueError);
+
+        // nested calls must not deadlock even when every worker is busy
+        std::atomic<int> count(0);
+        parallelFor(pool, 8, [&](index_t) {
+            parallelFor(pool, 8, [&](index_t) { ++count; });
+        });
+        CHECK(count == 64);
+
+        CHECK(pool.submit([] { return 42; }).get() == 42);
+    }
+
+    TEST_CASE ("BoundedQueue") {
+        BoundedQueue<int> queue(2);
+        std::thread producer([&queue] {
+            for (int k = 0; k < 100; ++k) queue.push(k);
+            queue.close();
+        });
+
+        int item, expected = 0;
+        while (queue.pop(item)) CHECK(item == expected++);
+        producer.join();
+
+        CHECK(expected == 100);
+        CHECK(queue.maxSize() <= 2);
+        CHECK(not queue.push(0));
+    }
+
+}
@@ -0,0 +1,58 @@
+#include <doctest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include "debug.h"
+
+#include "binary.h"
+#include "pipeline.h"
+
+
+TEST_SUITE("pipeline") {
+
+    TEST_CASE("runPipeline") {
+        // diagonal systems of decreasing size (the first ones take longest to factor), x_i = k + 1
+        const size_t count = 8;
+        std::vector<std::string> paths;
+        for (index_t k = 0; k < count; ++k) {
+            paths.push_back("LU_test_pipeline" + std::to_string(k) + ".DAT");
+            const size_t n = 400 - 45*k;
+            std::ofstream file(paths.back());
+            file << n << ' ' << n << '\n';
+            for (index_t i = 0; i < n; ++i) file << i << ' ' << i << ' ' << (k == 5 ? 0 : i + 1) << '\n';
+            file << n << '\n';
+            for (index_t i = 0; i < n; ++i) file << i << ' ' << (i + 1)*(k + 1) << '\n';
+        }
+        std::vector<SolveTask> tasks;
+        for (const std::string &path : paths) tasks.push_back({path.c_str(), OutputFormat::Binary, SolverChoice::GeneralLU});
+
+        PipelineOptions options;
+        options.factorWorkers = 4;
+        options.metricsWorkers = 2;
+        std::vector<std::string> reported, outNames;
+        std::vector<bool> failed;
+        const auto stats = runPipeline(tasks, options, [&](const char *path, const std::string &outName, const char *error) {
+            reported.push_back(path);
+            outNames.push_back(outName);
+            failed.push_back(error != nullptr);
+        });
+
+        REQUIRE(reported.size() == count);
+        CHECK(reported == paths);
+        for (index_t k = 0; k < count; ++k) {
+            CHECK(failed[k] == (k == 5));  // singular
+            if (failed[k]) continue;
+            std::ifstream solution(outNames[k], std::ios::binary);
+            const Vector x = readBinaryVector(solution);
+            REQUIRE(x.size() == 400 - 45*k);
+            for (double xi : x) CHECK(xi == doctest::Approx(double(k + 1)));
+            std::remove(outNames[k].c_str());
+        }
+        REQUIRE(stats.size() == 4);
+        CHECK(stats[1].workers == 4);
+        for (const StageStats &stage : stats) CHECK(stage.items == count);
+
+        for (const std::string &path : paths) std::remove(path.c_str());
+    }
+
+}
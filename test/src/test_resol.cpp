@@ -1,4 +1,5 @@
 #include <doctest.h>
+#include <cmath>
 #include "debug.h"
 
 #define RESOL_DECLARATIONS_ONLY
@@ -45,6 +46,27 @@ TEST_SUITE("resol") {
         }
     }
 
+    TEST_CASE("leading zeros") {
+        const Matrix mat = {{2, 1, 0, 3},
+                            {4, -1, 2, 0},
+                            {0, 5, 1, 1},
+                            {1, 0, -3, 2}};
+        LUDecomposition luDecomp(mat);
+        std::vector<Vector> units;
+        for (index_t k = 0; k < 4; ++k) {
+            Vector e(0.0, 4);
+            e[k] = 1;
+            units.push_back(e);
+            const Vector x = solveLU(luDecomp, e);
+            const Vector r = mat*x - e;
+            for (double ri : r) CHECK(std::abs(ri) < 1e-15);
+        }
+
+        // the same skipping in the blocked solve
+        const std::vector<Vector> xs = solveLU(luDecomp, units);
+        for (index_t k = 0; k < 4; ++k) CHECK((xs[k] == solveLU(luDecomp, units[k])).min());
+    }
+
     TEST_CASE("array") {
         double **a = newmat(2);
         a[0][0] = 1; a[0][1] = 1; a[1][1] = 1;
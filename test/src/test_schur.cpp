@@ -0,0 +1,79 @@
+#include <doctest.h>
+#include <random>
+#include "debug.h"
+
+#include "SchurComplement.h"
+#include "errors.h"
+#include "inverse.h"
+#include "norm.h"
+#include "resol.h"
+
+
+TEST_SUITE("Schur complement") {
+
+    /// Dense bordered matrix [A B; C D], B given by columns and C by rows
+    Matrix borderedMatrix(const Matrix &A, const std::vector<Vector> &B, const std::vector<Vector> &C, const Matrix &D) {
+        const size_t n = A.size(), m = D.size();
+        Matrix M(n + m);
+        for (index_t i = 0; i < n + m; ++i)
+            for (index_t j = 0; j < n + m; ++j) {
+                if (i < n) M[i][j] = j < n ? A[i][j] : B[j - n][i];
+                else M[i][j] = j < n ? C[i - n][j] : D[i - n][j - n];
+            }
+        return M;
+    }
+
+    TEST_CASE("bordered system") {
+        const size_t n = 60, m = 4;
+        std::mt19937 gen(17);
+        std::uniform_real_distribution<double> value(-1, 1);
+        Matrix A(n), D(m);
+        for (index_t i = 0; i < n; ++i)
+            for (index_t j = 0; j < n; ++j) A[i][j] = value(gen) + (i == j ? 3.0 : 0.0);
+        std::vector<Vector> B(m, Vector(n)), C(m, Vector(n));
+        for (index_t k = 0; k < m; ++k)
+            for (index_t i = 0; i < n; ++i) {
+                B[k][i] = value(gen);
+                C[k][i] = value(gen);
+            }
+        // a saddle point system: zero trailing block
+        const Matrix M = borderedMatrix(A, B, C, D);
+        const LUDecomposition luA(A);
+        const SchurComplementDecomposition schurObj(LUDecomposition(luA), B, C, D);
+        CHECK(schurObj.size() == n + m);
+
+        Vector b(n + m);
+        for (index_t i = 0; i < n + m; ++i) b[i] = double(i%5) - 2;
+        const LUDecomposition luM(M);
+        const Vector x = solveLU(schurObj, b), expected = solveLU(luM, b);
+        for (index_t i = 0; i < n + m; ++i) CHECK(x[i] == doctest::Approx(expected[i]).epsilon(1e-10));
+        const Vector y = solveLUTransposed(schurObj, b), expectedT = solveLUTransposed(luM, b);
+        for (index_t i = 0; i < n + m; ++i) CHECK(y[i] == doctest::Approx(expectedT[i]).epsilon(1e-10));
+        CHECK(inverseNorm(schurObj, NormType::Inf) == doctest::Approx(norm(inverse(luM), NormType::Inf)));
+
+        const std::vector<Vector> xs = solveLU(schurObj, std::vector<Vector>{b, 3.0*b});
+        for (index_t i = 0; i < n + m; ++i) CHECK(xs[1][i] == doctest::Approx(3.0*x[i]));
+
+        SUBCASE("new trailing block") {
+            SchurComplementDecomposition updated = schurObj;
+            for (index_t i = 0; i < m; ++i) D[i][i] = 2.0;
+            REQUIRE(updated.setD(D));
+            const Vector z = solveLU(updated, b), expected2 = solveLU(LUDecomposition(borderedMatrix(A, B, C, D)), b);
+            for (index_t i = 0; i < n + m; ++i) CHECK(z[i] == doctest::Approx(expected2[i]).epsilon(1e-10));
+            CHECK_THROWS_AS(updated.setD(Matrix(m + 1)), MatrixError);
+        }
+
+        SUBCASE("singular Schur complement") {
+            std::vector<Vector> singularB = B;
+            singularB[2] = singularB[1];
+            std::vector<Vector> singularC = C;
+            singularC[2] = singularC[1];
+            SchurComplementDecomposition singular;
+            const LUStatus status = singular.tryFactor(LUDecomposition(luA), singularB, singularC, Matrix(m));
+            CHECK(not status);
+            CHECK(status.pivot >= n);
+            CHECK_THROWS_AS(singular.tryFactor(LUDecomposition(luA), B, std::vector<Vector>(m, Vector(n + 1)), D), MatrixError);
+        }
+    }
+
+}
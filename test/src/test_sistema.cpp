@@ -1,8 +1,13 @@
 #include <doctest.h>
+#include <sstream>
+#include <string>
 #include "debug.h"
 
 #include "sistema.h"
+#include "errors.h"
+#include "io.h"
 #include "oldies.h"
+#include "resol.h"
 
 
 TEST_SUITE("sistema") {
@@ -23,6 +28,7 @@ TEST_SUITE("sistema") {
 
             SolveResult result = solve(mat, {});
             CHECK(not result);
+            CHECK(not result.status());
             CHECK_THROWS_AS(result.solution(), std::invalid_argument);
         }
 
@@ -44,6 +50,162 @@ TEST_SUITE("sistema") {
 
     }
 
+    TEST_CASE("multiple right-hand sides") {
+        const size_t n = 20, k = 70;  // more than one block of right-hand sides
+        Matrix A(n);
+        for (index_t i = 0; i < n; ++i)
+            for (index_t j = 0; j < n; ++j) A[i][j] = (i == j) ? n : double((i*7 + j*3)%5) - 2;
+        std::vector<Vector> bs(k, Vector(n));
+        for (index_t r = 0; r < k; ++r)
+            for (index_t i = 0; i < n; ++i) bs[r][i] = double((r + 1)*(i + 2)%11) - 5;
+
+        auto result = solve(A, bs);
+        REQUIRE(result);
+        REQUIRE(result.solutions().size() == k);
+        CHECK((result.solution() == result.solutions().front()).min());
+        for (index_t r = 0; r < k; ++r) {
+            const Vector x = solve(A, bs[r]).solution();
+            for (index_t i = 0; i < n; ++i)
+                CHECK(result.solutions()[r][i] == doctest::Approx(x[i]).epsilon(1e-14));
+        }
+
+        auto info = getExtraSolveInfo(A, bs, result);
+        REQUIRE(info.residues.size() == k);
+        CHECK(info.residue == info.residues.front());
+        for (double res : info.residues) CHECK(res < 1e-12);
+
+        SUBCASE("none") {
+            const std::vector<Vector> none;
+            CHECK_THROWS_AS(solve(A, none), MatrixError);
+            CHECK_THROWS_AS(solve(A, none, numcomp::DEFAULT_TOL, SolverChoice::GeneralLU), MatrixError);
+            CHECK_THROWS_AS(solve(SparseMatrix::fromDense(A), none), MatrixError);
+            CHECK_THROWS_AS(solve(SparseMatrix::fromDense(A), none, IterativeOptions()), MatrixError);
+            CHECK_THROWS_AS(getExtraSolveInfo(A, none, result), MatrixError);
+        }
+    }
+
+    TEST_CASE("structure dispatch") {
+        const size_t n = 40;
+        auto check = [&](const Matrix &A, SolveMethod expected) {
+            Vector b(n);
+            for (index_t i = 0; i < n; ++i) b[i] = double(i%7) - 3;
+            const SolveResult result = solve(A, b);
+            REQUIRE(result);
+            CHECK(std::string(methodName(result.method())) == std::string(methodName(expected)));
+            CHECK(residue(A, result.solution(), b) < 1e-12);
+            CHECK(result.perm().size() == n);
+            REQUIRE(result.factorization());
+            CHECK((result.factorization()->solve({b}).front() == result.solution()).min());
+            if (expected != SolveMethod::LU) CHECK_THROWS_AS(result.getLU(), MatrixError);
+            if (expected != SolveMethod::Toeplitz) CHECK_THROWS_AS(result.getToeplitz(), MatrixError);
+
+            // the same condition numbers as through the general LU decomposition
+            const SolveResult general = solve(A, b, numcomp::DEFAULT_TOL, SolverChoice::GeneralLU);
+            CHECK(general.method() == SolveMethod::LU);
+            const ExtraSolveInfo info = getExtraSolveInfo(A, b, result), generalInfo = getExtraSolveInfo(A, b, general);
+            CHECK(info.cond1 == doctest::Approx(generalInfo.cond1));
+            CHECK(info.condInf == doctest::Approx(generalInfo.condInf));
+        };
+
+        Matrix A(n);
+        for (index_t i = 0; i < n; ++i) A[i][i] = double(i + 1);
+        check(A, SolveMethod::Diagonal);
+
+        for (index_t i = 1; i < n; ++i) A[i][i - 1] = 0.5;
+        check(A, SolveMethod::LowerTriangular);
+        Matrix reversed(n);
+        for (index_t i = 0; i < n; ++i) reversed[i] = A[n - 1 - i];
+        check(reversed, SolveMethod::PermutedTriangular);
+
+        for (index_t i = 1; i < n; ++i) A[i - 1][i] = -2.0;
+        check(A, SolveMethod::Tridiagonal);
+        A[5][8] = 1.0;
+        check(A, SolveMethod::Band);
+
+        Matrix B(n);
+        for (index_t i = 0; i < n; ++i)
+            for (index_t j = 0; j < n; ++j) B[i][j] = i == j ? 2.0*n : 1.0/double(i + j + 1);
+        check(B, SolveMethod::Cholesky);  // dominant, but the envelope is the whole matrix
+        for (index_t i = 0; i < n; ++i) B[i][i] = i%2 ? 0.5 : -0.5;
+        check(B, SolveMethod::LDLT);
+        for (index_t i = 0; i < n; ++i) B[i][i] = 2.0*n;
+        B[3][30] = 5.0;
+        check(B, SolveMethod::SkylineLU);
+        for (index_t i = 0; i < n; ++i) B[i][i] = 0.5;
+        check(B, SolveMethod::LU);
+
+        Matrix arrow(n);  // a wide band, but a small envelope
+        for (index_t i = 0; i < n; ++i) {
+            arrow[i][i] = 2.0*n;
+            arrow[n - 1][i] = arrow[i][n - 1] = i == n - 1 ? 2.0*n : 1.0;
+        }
+        check(arrow, SolveMethod::SkylineLDLT);
+
+        Matrix T(n);  // Toeplitz, neither symmetric nor dominant
+        for (index_t i = 0; i < n; ++i)
+            for (index_t j = 0; j < n; ++j) T[i][j] = i >= j ? 1.0/double(1 + i - j) : -0.7/double(1 + j - i);
+        check(T, SolveMethod::Toeplitz);
+        CHECK(not solve(T, Vector(1.0, n)).getToeplitz().isFallback());
+        for (index_t i = 0; i < n; ++i) T[i][i] = 0.0;  // Levinson can't start
+        check(T, SolveMethod::Toeplitz);
+        CHECK(solve(T, Vector(1.0, n)).getToeplitz().isFallback());
+
+        // a nearly singular leading 2 by 2 submatrix: the Levinson pivot 1e-7 passes, but its
+        // solutions are far less accurate than those of the LU decomposition, which takes over
+        Vector column(n), row(n);
+        for (index_t k = 0; k < n; ++k) {
+            column[k] = (k%3 ? 0.4 : -0.3)/double(k + 1);
+            row[k] = (k%2 ? 0.5 : -0.2)/double(k + 1);
+        }
+        column[0] = row[0] = column[1] = 1.0;
+        row[1] = 1.0 - 1e-7;
+        const ToeplitzMatrix nearlySingular(column, row);
+        const Vector ones(1.0, n);
+        CHECK(not ToeplitzDecomposition(nearlySingular).isFallback());
+        CHECK(residue(nearlySingular.toDense(), solveLU(ToeplitzDecomposition(nearlySingular), ones), ones) > 1e-12);
+        check(nearlySingular.toDense(), SolveMethod::LU);
+
+        Matrix U(n);
+        for (index_t i = 0; i < n; ++i)
+            for (index_t j = i; j < n; ++j) U[i][j] = 1.0 + double(j - i);
+        check(U, SolveMethod::UpperTriangular);
+        U[n - 1][n - 1] = 0.0;
+        CHECK(not solve(U, Vector(1.0, n)));
+
+        SUBCASE("printResult") {
+            const SolveResult result = solve(U, Vector(1.0, n), numcomp::DEFAULT_TOL, SolverChoice::GeneralLU);
+            CHECK(not result);
+            U[n - 1][n - 1] = 1.0;
+            std::ostringstream oss;
+            const Vector b(1.0, n);
+            const SolveResult triangular = solve(U, b);
+            printResult(triangular, getExtraSolveInfo(U, b, triangular), oss);
+            CHECK(oss.str().find("method: upper triangular") != std::string::npos);
+        }
+    }
+
+    TEST_CASE("reducible dispatch") {
+        // block upper triangular with three dense, unstructured diagonal blocks, rows reversed
+        const size_t n = 3*DENSE_BTF_MIN_SIZE, blockSize = DENSE_BTF_MIN_SIZE;
+        Matrix A(n);
+        for (index_t i = 0; i < n; ++i)
+            for (index_t j = i/blockSize*blockSize; j < n; ++j)
+                A[n - 1 - i][j] = double((i*7 + j*13)%11) - 5 + (i == j ? 3.0 : 0.0);
+        Vector b(n);
+        for (index_t i = 0; i < n; ++i) b[i] = double(i%5) - 2;
+
+        const SolveResult result = solve(A, b);
+        REQUIRE(result);
+        CHECK(result.method() == SolveMethod::BlockTriangular);
+        CHECK(result.getBTF().blockCount() == 3);
+        CHECK(residue(A, result.solution(), b) < 1e-10);
+
+        const SolveResult general = solve(A, b, numcomp::DEFAULT_TOL, SolverChoice::GeneralLU);
+        CHECK(general.method() == SolveMethod::LU);
+        const ExtraSolveInfo info = getExtraSolveInfo(A, b, result), generalInfo = getExtraSolveInfo(A, b, general);
+        CHECK(info.cond1 == doctest::Approx(generalInfo.cond1));
+    }
+
     TEST_CASE("C-style") {
 
         auto a = newmat(2);
@@ -0,0 +1,121 @@
+#include <doctest.h>
+#include <random>
+#include <string>
+#include <vector>
+#include "debug.h"
+
+#include "SkylineMatrix.h"
+#include "SkylineLU.h"
+#include "errors.h"
+#include "io.h"
+#include "resol.h"
+#include "sistema.h"
+
+
+TEST_SUITE("skyline") {
+
+    /// Random diagonally dominant n by n matrix whose rows (and columns) start at random distances
+    /// (at most width) from the diagonal, symmetric if asked
+    Matrix randomProfile(size_t n, size_t width, bool symmetric, unsigned seed) {
+        std::mt19937 gen(seed);
+        std::uniform_int_distribution<size_t> distance(0, width);
+        std::vector<size_t> rowWidth(n), columnWidth(n);
+        for (index_t i = 0; i < n; ++i) {
+            rowWidth[i] = std::min<size_t>(i, distance(gen));
+            columnWidth[i] = std::min<size_t>(i, distance(gen));
+        }
+        // the envelope ends at the first entry, the rest is sparse
+        const auto inProfile = [&](index_t i, index_t j) {
+            return j <= i ? i - j == rowWidth[i] or (i - j < rowWidth[i] and (i + j)%2)
+                          : j - i == columnWidth[j] or (j - i < columnWidth[j] and (i + j)%2);
+        };
+        Matrix mat = randomMatrix(n, 0.0, seed, inProfile, symmetric);
+        for (index_t i = 0; i < n; ++i) mat[i][i] = 2.0*double(width) + 1;
+        return mat;
+    }
+
+    TEST_CASE("skyline storage") {
+        const Matrix mat = {{4, 0, 1, 0},
+                            {0, 3, 0, 2},
+                            {1, 0, 5, 0},
+                            {0, 7, 0, 1}};
+        const SkylineMatrix A = SkylineMatrix::fromDense(mat);
+        CHECK(A.rowStart(2) == 0);
+        CHECK(A.rowStart(3) == 1);
+        CHECK(A.columnStart(1) == 1);
+        CHECK(A.columnStart(3) == 1);
+        CHECK(A.profileSize() == 4 + 4 + 4);  // zeros within the envelope included
+        CHECK(A.toDense() == mat);
+        CHECK(A(3, 0) == 0.0);
+        CHECK_THROWS_AS(A(4, 0), std::out_of_range);
+
+        const Vector v = {1, -2, 3, 4};
+        const Vector Av = A*v, expected = mat*v;
+        for (index_t i = 0; i < 4; ++i) CHECK(Av[i] == doctest::Approx(expected[i]));
+
+        CHECK_THROWS_AS(SkylineMatrix::fromDense(mat, true), MatrixError);
+        const Matrix sym = {{4, 0, 1},
+                            {0, 3, 2},
+                            {1, 2, 5}};
+        const SkylineMatrix S = SkylineMatrix::fromDense(sym, true);
+        CHECK(S.isSymmetric());
+        CHECK(S.profileSize() == 3 + 2);
+        CHECK(S.toDense() == sym);
+        CHECK(S.expanded().toDense() == sym);
+
+        SUBCASE("readSkylineMatrix") {
+            const std::string text = "3 4\n0 0 1\n2 1 3\n1 1 2\n0 2 -1\n";
+            Scanner scanner(text.data(), text.data() + text.size());
+            const SkylineMatrix R = readSkylineMatrix(scanner);
+            CHECK(R.rowStart(2) == 1);
+            CHECK(R.columnStart(2) == 0);
+            CHECK(R(0, 2) == -1);
+            CHECK(R(2, 1) == 3);
+        }
+    }
+
+    TEST_CASE("skyline LU") {
+        const size_t n = 300;
+        const Matrix mat = randomProfile(n, 20, false, 5);
+        const SkylineMatrix A = SkylineMatrix::fromDense(mat);
+        CHECK(A.profileSize() < n*n/5);
+
+        const SkylineLUDecomposition lu(A);
+        CHECK(lu.factors().profileSize() == A.profileSize());  // no fill outside the envelope
+        Vector b(n);
+        for (index_t i = 0; i < n; ++i) b[i] = double(i%7) - 3;
+        CHECK(residue(mat, solveLU(lu, b), b) < 1e-12);
+        CHECK(residue(SparseMatrix::fromDense(mat).transposed(), solveLUTransposed(lu, b), b) < 1e-12);
+
+        SUBCASE("zero pivot") {
+            const Matrix needsPivoting = {{0, 1},
+                                          {1, 0}};
+            SkylineLUDecomposition bad;
+            const LUStatus status = bad.tryFactor(SkylineMatrix::fromDense(needsPivoting));
+            CHECK(not status);
+            CHECK(status.pivot == 0);
+        }
+    }
+
+    TEST_CASE("skyline LDLT") {
+        const size_t n = 300;
+        const Matrix mat = randomProfile(n, 20, true, 9);
+        const SkylineMatrix A = SkylineMatrix::fromDense(mat, true);
+        const SkylineLDLTDecomposition ldl(A);
+        Vector b(n);
+        for (index_t i = 0; i < n; ++i) b[i] = double(i%5) - 2;
+        const Vector x = solveLDLT(ldl, b);
+        CHECK(residue(mat, x, b) < 1e-12);
+
+        // the same as the LU of the expanded matrix
+        const Vector y = solveLU(SkylineLUDecomposition(A), b);
+        for (index_t i = 0; i < n; ++i) CHECK(y[i] == doctest::Approx(x[i]));
+
+        CHECK_THROWS_AS(SkylineLDLTDecomposition(SkylineMatrix::fromDense(mat), numcomp::DEFAULT_TOL), MatrixError);
+        const Matrix singular = {{1, 2},
+                                 {2, 4}};
+        SkylineLDLTDecomposition bad;
+        CHECK(not bad.tryFactor(SkylineMatrix::fromDense(singular, true)));
+    }
+
+}
@@ -0,0 +1,329 @@
+#include <doctest.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include "debug.h"
+
+#include "SparseMatrix.h"
+#include "errors.h"
+#include "io.h"
+#include "norm.h"
+#include "resol.h"
+#include "extra.h"
+#include "SparseLU.h"
+#include "BTF.h"
+#include "sistema.h"
+
+
+TEST_SUITE("sparse") {
+
+    const Matrix dense = {{4, 0, 1, 0},
+                          {0, 0, 0, -2},
+                          {3, 0, 5, 0},
+                          {0, 7, 0, 1}};
+
+    TEST_CASE("builder") {
+        TripletBuilder builder(4);
+        builder.add(3, 3, 1);
+        builder.add(0, 2, 9);
+        builder.add(2, 0, 3);
+        builder.add(0, 0, 4);
+        builder.add(1, 1, 6);  // overwritten with zero: not stored
+        builder.add(1, 3, -2);
+        builder.add(0, 2, 1);  // the last one wins
+        builder.add(3, 1, 7);
+        builder.add(2, 2, 5);
+        builder.add(1, 1, 0);
+        CHECK_THROWS_AS(builder.add(4, 0, 1), std::out_of_range);
+
+        SparseMatrix A = builder.build<index_t>();
+        CHECK(A.nnz() == 7);
+        CHECK(A.toDense() == dense);
+        CHECK(A(0, 2) == 1);
+        CHECK(A(1, 1) == 0);
+        CHECK_THROWS_AS(A(0, 4), std::out_of_range);
+
+        SUBCASE("layouts") {
+            SparseMatrix32 B = builder.build<std::uint32_t>(SparseLayout::CSC);
+            CHECK(B.layout() == SparseLayout::CSC);
+            CHECK(B.toDense() == dense);
+            CHECK(B(3, 1) == 7);
+            CHECK(B.converted(SparseLayout::CSR).toDense() == dense);
+            CHECK((B.pointers() == std::vector<std::uint32_t>{0, 2, 3, 5, 7}));
+
+            SparseMatrix At = A.transposed();
+            for (index_t i = 0; i < 4; ++i)
+                for (index_t j = 0; j < 4; ++j) CHECK(At(i, j) == dense[j][i]);
+            CHECK(SparseMatrix::fromDense(dense, SparseLayout::CSC).toDense() == dense);
+        }
+    }
+
+    TEST_CASE("operations") {
+        const Vector v = {1, -2, 0.5, 3};
+        for (auto layout : {SparseLayout::CSR, SparseLayout::CSC}) {
+            SparseMatrix A = SparseMatrix::fromDense(dense, layout);
+            CHECK(((A*v) == (dense*v)).min());
+            CHECK(norm1(A) == norm1(dense));
+            CHECK(normInf(A) == normInf(dense));
+        }
+        CHECK_THROWS_AS(SparseMatrix(4)*Vector(3), MatrixError);
+        CHECK_THROWS_AS(SparseMatrix(2, SparseLayout::CSR, {0, 1, 1}, {2}, {1.0}), MatrixError);
+    }
+
+    TEST_CASE("read and solve") {
+        std::string text = "4 8\n0 0 4\n0 2 1\n1 3 -2\n2 0 3\n2 2 5\n3 1 7\n3 3 1\n3 3 1\n1\n2 1\n";
+        Scanner scanner(text.data(), text.data() + text.size());
+        SparseMatrix A = readSparseMatrix(scanner);
+        CHECK(A.toDense() == dense);
+        Vector b = readVector(scanner, A.size());
+
+        auto result = solve(A, std::vector<Vector>{b});
+        REQUIRE(result);
+        CHECK(residue(A, result.solution(), b) < 1e-15);
+        auto info = getExtraSolveInfo(A, std::vector<Vector>{b}, result);
+        CHECK(info.cond1 == conditionNumber(dense, NormType::L1));
+    }
+
+    // n by n matrix with a random pattern (about `perRow` entries per row) and no zero-free diagonal
+    Matrix randomSparse(size_t n, size_t perRow, unsigned seed) {
+        std::mt19937 gen(seed);
+        std::bernoulli_distribution entry(double(perRow)/double(n));
+        const auto inPattern = [&](index_t i, index_t j) { return j == (i + 1)%n or entry(gen); };
+        Matrix A = randomMatrix(n, 0.0, seed, inPattern);
+        for (index_t i = 0; i < n; ++i) A[i][(i + 1)%n] += 2;  // non-singular, but the diagonal alone won't do
+        return A;
+    }
+
+    TEST_CASE("sparse LU") {
+        SUBCASE("small") {
+            const Matrix mat = {{0, 2, 0},
+                                {1, 0, 3},
+                                {0, 4, 5}};
+            SparseLUDecomposition lu(SparseMatrix::fromDense(mat));
+            Vector x = solveLU(lu, Vector{2, 4, 9});
+            CHECK(x[0] == doctest::Approx(1));
+            CHECK(x[1] == doctest::Approx(1));
+            CHECK(x[2] == doctest::Approx(1));
+            CHECK((lu.parity() ? -1 : 1)*determinant(mat) < 0);  // det = -14 = sign*prod(diag(U))
+
+            Vector y = solveLUTransposed(lu, Vector{1, 12, 13});
+            CHECK(y[0] == doctest::Approx(2));
+            CHECK(y[1] == doctest::Approx(1));
+            CHECK(y[2] == doctest::Approx(2));
+        }
+
+        SUBCASE("singular") {
+            const Matrix mat = {{1, 2, 0},
+                                {2, 4, 0},
+                                {0, 0, 1}};
+            SparseLUDecomposition lu;
+            CHECK(not lu.tryFactor(SparseMatrix::fromDense(mat)));
+            CHECK_THROWS_AS(SparseLUDecomposition(SparseMatrix(3)), SingularMatrixError);
+        }
+
+        SUBCASE("random") {
+            const size_t n = 300;
+            const Matrix dense = randomSparse(n, 3, 7);
+            const SparseMatrix A = SparseMatrix::fromDense(dense, SparseLayout::CSC);
+            for (double threshold : {0.01, 0.1, 1.0}) {
+                SparseLUDecomposition lu(A, numcomp::DEFAULT_TOL, threshold);
+                CHECK(lu.lower().layout() == SparseLayout::CSC);
+                Vector b(n);
+                for (index_t i = 0; i < n; ++i) b[i] = double(i%7) - 3;
+                CHECK(residue(A, solveLU(lu, b), b) < 1e-12);
+                const Vector y = solveLUTransposed(lu, b);
+                CHECK(residue(A.transposed(), y, b) < 1e-12);
+            }
+
+            SparseLUDecomposition lu(A);
+            CHECK(inverseNorm(lu, NormType::L1)*norm1(dense) == doctest::Approx(conditionNumber(dense, NormType::L1)));
+            CHECK(inverseNorm(lu, NormType::Inf)*normInf(dense) ==
+                  doctest::Approx(conditionNumber(dense, NormType::Inf)));
+        }
+
+        SUBCASE("ordering") {
+            // arrow matrix: eliminating the hub first fills everything, last fills nothing
+            const size_t n = 50;
+            TripletBuilder builder(n);
+            for (index_t i = 0; i < n; ++i) {
+                builder.add(i, i, 4);
+                if (i > 0) {
+                    builder.add(0, i, 1);
+                    builder.add(i, 0, 1);
+                }
+            }
+            const SparseMatrix A = builder.build<index_t>();
+            CHECK(minimumDegreeOrdering(A)[0] != 0);
+            SparseLUDecomposition lu(A);
+            CHECK(lu.nnz() == A.nnz() + n);  // no fill (the diagonal is stored in both L and U)
+        }
+    }
+
+    TEST_CASE("sparse right-hand side") {
+        const size_t n = 400;
+        const Matrix dense = randomSparse(n, 2, 5);
+        const SparseMatrix A = SparseMatrix::fromDense(dense);
+        SparseLUDecomposition lu(A);
+        LUDecomposition denseLU(dense);
+        for (index_t k : {index_t(0), index_t(17), n - 1}) {
+            Vector e(0.0, n);
+            e[k] = 1;
+            const Vector x = solveLU(lu, e);
+            CHECK(residue(A, x, e) < 1e-12);
+            const Vector y = solveLU(denseLU, e);
+            for (index_t i = 0; i < n; ++i) CHECK(x[i] == doctest::Approx(y[i]).epsilon(1e-9));
+
+            // past the density threshold the full sweep gives the same result
+            Vector b = e;
+            for (index_t i = 0; i < n; i += 2) b[i] += 1e-3*double(i%5);
+            CHECK(residue(A, solveLU(lu, b), b) < 1e-12);
+        }
+    }
+
+    TEST_CASE("refactor") {
+        const size_t n = 200;
+        SparseMatrix A = SparseMatrix::fromDense(randomSparse(n, 3, 11));
+        SparseLUDecomposition lu(A);
+        Vector b(n);
+        for (index_t i = 0; i < n; ++i) b[i] = double(i%5) - 2;
+
+        for (int step = 1; step <= 3; ++step) {
+            for (index_t p = 0; p < A.nnz(); ++p) A.values()[p] *= 1 + 0.01*double((p*step)%7);
+            REQUIRE(lu.refactor(A.values()));
+            CHECK(lu.reusedPivots());
+            CHECK(residue(A, solveLU(lu, b), b) < 1e-12);
+        }
+
+        SUBCASE("degraded pivot") {
+            // scaling a pivot row scales its pivot, but not the entries below it: pick the
+            // step with the largest multiplier and make its pivot unacceptable
+            const SparseMatrix &L = lu.lower();
+            index_t step = 0;
+            double largest = 0.0;
+            for (index_t k = 0; k < n; ++k)
+                for (index_t p = L.pointers()[k] + 1; p < L.pointers()[k + 1]; ++p)
+                    if (std::abs(L.values()[p]) > largest) {
+                        largest = std::abs(L.values()[p]);
+                        step = k;
+                    }
+            REQUIRE(largest > 0.1);
+            const index_t row = lu.rowPerm()[step];
+            for (index_t p = A.pointers()[row]; p < A.pointers()[row + 1]; ++p) A.values()[p] *= 1e-6;
+            REQUIRE(lu.refactor(A));
+            CHECK(not lu.reusedPivots());
+            CHECK(residue(A, solveLU(lu, b), b) < 1e-12);
+        }
+
+        SUBCASE("different pattern") {
+            CHECK_THROWS_AS(lu.refactor(SparseMatrix::fromDense(randomSparse(n, 3, 12))), std::invalid_argument);
+            CHECK_THROWS_AS(lu.refactor(std::vector<double>(3)), std::invalid_argument);
+        }
+    }
+
+    // Block upper triangular matrix with the given block sizes, then scrambled by random permutations
+    Matrix reducibleMatrix(const std::vector<size_t> &sizes, unsigned seed) {
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<double> value(-1, 1);
+        size_t n = 0;
+        for (size_t size : sizes) n += size;
+        Matrix C(n);
+        index_t first = 0;
+        for (size_t size : sizes) {
+            for (index_t i = first; i < first + size; ++i) {
+                C[i][i] = 4 + value(gen);
+                if (size > 1) C[i][first + (i - first + 1)%size] = value(gen);  // irreducible block
+                for (index_t k = 0; k < 2; ++k) C[i][first + std::uniform_int_distribution<index_t>(0, n - first - 1)(gen)] = value(gen);
+            }
+            first += size;
+        }
+
+        std::vector<index_t> p(n), q(n);
+        for (index_t i = 0; i < n; ++i) p[i] = q[i] = i;
+        std::shuffle(p.begin(), p.end(), gen);
+        std::shuffle(q.begin(), q.end(), gen);
+        Matrix A(n);
+        for (index_t i = 0; i < n; ++i)
+            for (index_t j = 0; j < n; ++j) A[p[i]][q[j]] = C[i][j];
+        return A;
+    }
+
+    TEST_CASE("block triangular form") {
+        const std::vector<size_t> sizes = {5, 1, 120, 3, 1, 1, 40};
+        const Matrix dense = reducibleMatrix(sizes, 21);
+        const SparseMatrix A = SparseMatrix::fromDense(dense);
+        const size_t n = A.size();
+
+        const BlockTriangularForm form = blockTriangularForm(A);
+        CHECK(form.rank == n);
+        CHECK(form.blockCount() >= sizes.size());  // the random entries may split blocks further
+        for (index_t k = 0; k < form.blockCount(); ++k)
+            for (index_t i = form.blocks[k]; i < form.blocks[k + 1]; ++i)
+                for (index_t j = 0; j < form.blocks[k]; ++j)
+                    CHECK(dense[form.rowPerm[i]][form.colPerm[j]] == 0);
+
+        BTFDecomposition lu(A);
+        CHECK(lu.blockCount() == form.blockCount());
+        Vector b(n);
+        for (index_t i = 0; i < n; ++i) b[i] = double(i%7) - 3;
+        CHECK(residue(A, solveLU(lu, b), b) < 1e-12);
+        CHECK(residue(A.transposed(), solveLUTransposed(lu, b), b) < 1e-12);
+        CHECK((lu.parity() ? -1 : 1)*determinant(dense) > 0);
+
+        SUBCASE("dispatch") {
+            auto result = solve(A, std::vector<Vector>{b});
+            REQUIRE(result);
+            CHECK(result.isBlockTriangular());
+            CHECK(result.colPerm().size() == n);
+            auto info = getExtraSolveInfo(A, std::vector<Vector>{b}, result);
+            CHECK(info.cond1 == doctest::Approx(conditionNumber(dense, NormType::L1)));
+            CHECK(info.condInf == doctest::Approx(conditionNumber(dense, NormType::Inf)));
+
+            // irreducible (periodic tridiagonal): factored as a whole
+            TripletBuilder builder(300);
+            for (index_t i = 0; i < 300; ++i) {
+                builder.add(i, i, 4);
+                builder.add(i, (i + 1)%300, -1);
+                builder.add((i + 1)%300, i, -1);
+            }
+            const SparseMatrix periodic = builder.build<index_t>();
+            CHECK(blockTriangularForm(periodic).blockCount() == 1);
+            CHECK(solve(periodic, std::vector<Vector>{Vector(1.0, 300)}).isSparse());
+        }
+
+        SUBCASE("triangular") {
+            Matrix lower(50);
+            for (index_t i = 0; i < 50; ++i)
+                for (index_t j = 0; j <= i; j += 3) lower[i][j] = 1 + double(i == j);
+            CHECK(blockTriangularForm(SparseMatrix::fromDense(lower)).blockCount() == 50);
+        }
+
+        SUBCASE("singular") {
+            // structurally singular: two rows with a single entry in the same column
+            const SparseMatrix S = SparseMatrix::fromDense(Matrix{{1, 0, 0}, {2, 0, 0}, {0, 1, 1}});
+            const std::vector<index_t> match = maximumTransversal(S);
+            CHECK(std::count(match.begin(), match.end(), index_t(-1)) == 1);
+            BTFDecomposition singular;
+            CHECK(not singular.tryFactor(S));
+            CHECK_THROWS_AS(BTFDecomposition(S, numcomp::DEFAULT_TOL), SingularMatrixError);
+            // numerically singular block
+            CHECK(not singular.tryFactor(SparseMatrix::fromDense(Matrix{{1, 2, 5}, {2, 4, 1}, {0, 0, 1}})));
+        }
+    }
+
+    TEST_CASE("sparse dispatch") {
+        const size_t n = 2*SPARSE_MIN_SIZE;
+        const Matrix A = randomSparse(n, 2, 3);
+        Vector b(1.0, n);
+        auto result = solve(A, b);
+        REQUIRE(result);
+        CHECK((result.isSparse() or result.isBlockTriangular()));
+        CHECK(result.perm().size() == n);
+        CHECK_THROWS_AS(result.getLU(), MatrixError);
+        CHECK(residue(A, result.solution(), b) < 1e-12);
+        auto info = getExtraSolveInfo(A, b, result);
+        CHECK(info.cond1 == doctest::Approx(conditionNumber(A, NormType::L1)));
+
+        CHECK(not solve(Matrix{{1, 2}, {3, 4}}, {1, 1}).isSparse());
+    }
+
+}
@@ -0,0 +1,84 @@
+#include <doctest.h>
+#include "debug.h"
+
+#include "structure.h"
+#include "errors.h"
+#include "resol.h"
+#include "sistema.h"
+
+
+TEST_SUITE("structure") {
+
+    TEST_CASE("detectStructure") {
+        const Matrix lower = {{2, 0, 0},
+                              {1, 3, 0},
+                              {6, 0, 5}};
+        MatrixStructure structure = detectStructure(lower);
+        CHECK(structure.nnz == 5);
+        CHECK(structure.isLowerTriangular());
+        CHECK(not structure.isUpperTriangular());
+        CHECK(not structure.symmetric);
+        CHECK(not structure.diagonallyDominant);
+        CHECK(structure.positiveDiagonal);
+        CHECK(structure.profile == 6);
+
+        const Matrix spd = {{4, -1, 0, 0},
+                            {-1, 4, -1, 0},
+                            {0, -1, 4, 2},
+                            {0, 0, 2, 3}};
+        structure = detectStructure(spd);
+        CHECK(structure.isTridiagonal());
+        CHECK(not structure.isDiagonal());
+        CHECK(structure.symmetric);
+        CHECK(structure.diagonallyDominant);
+        CHECK(structure.positiveDiagonal);
+        CHECK(structure.band.lower == 1);
+        CHECK(structure.band.upper == 1);
+
+        structure = detectStructure(Matrix{{1, 0}, {0, -2}});
+        CHECK(structure.isDiagonal());
+        CHECK(not structure.positiveDiagonal);
+        CHECK(not structure.isNarrowBand(2));
+        CHECK(structure.isNarrowBand(8));
+    }
+
+    TEST_CASE("permuted triangular") {
+        // rows and columns of an upper triangular matrix, scrambled
+        const Matrix A = {{0, 3, 0, 0},
+                          {5, 1, 2, 7},
+                          {0, 4, 0, 6},
+                          {0, 2, 8, 1}};
+        Permutation::Vector rowOrder, colOrder;
+        REQUIRE(findTriangularOrder(A, rowOrder, colOrder));
+        for (index_t k = 0; k < 4; ++k)
+            for (index_t m = k + 1; m < 4; ++m) CHECK(A[rowOrder[k]][colOrder[m]] == 0.0);
+
+        const TriangularDecomposition tri(A);
+        const Vector x = {1, -1, 2, 0.5};
+        const Vector b = A*x, y = solveLU(tri, b);
+        for (index_t i = 0; i < 4; ++i) CHECK(y[i] == doctest::Approx(x[i]));
+
+        Matrix At(4);
+        for (index_t i = 0; i < 4; ++i)
+            for (index_t j = 0; j < 4; ++j) At[i][j] = A[j][i];
+        const Vector z = solveLUTransposed(tri, At*x);
+        for (index_t i = 0; i < 4; ++i) CHECK(z[i] == doctest::Approx(x[i]));
+
+        SUBCASE("not triangular") {
+            const Matrix full = {{1, 2},
+                                 {3, 4}};
+            CHECK(not findTriangularOrder(full, rowOrder, colOrder));
+            CHECK_THROWS_AS(TriangularDecomposition(full, numcomp::DEFAULT_TOL), MatrixError);
+            // two rows needing the same column: structurally singular
+            CHECK(not findTriangularOrder(Matrix{{1, 0, 0}, {2, 0, 0}, {3, 4, 5}}, rowOrder, colOrder));
+        }
+
+        SUBCASE("singular") {
+            TriangularDecomposition singular;
+            const LUStatus status = singular.tryFactor(Matrix{{1, 0}, {2, 1e-15}});
+            CHECK(not status);
+            CHECK(status.pivot == 1);
+        }
+    }
+
+}
@@ -0,0 +1,106 @@
+#include <doctest.h>
+#include "debug.h"
+
+#include "ToeplitzMatrix.h"
+#include "ToeplitzSolver.h"
+#include "errors.h"
+#include "inverse.h"
+#include "norm.h"
+#include "resol.h"
+
+
+TEST_SUITE("Toeplitz") {
+
+    /// Random n by n Toeplitz matrix with entries in [-1, 1] and the given t_0
+    ToeplitzMatrix randomToeplitz(size_t n, double t0, unsigned seed) {
+        Vector column = randomVector(n, seed), row = randomVector(n, seed + 1);
+        for (index_t k = 0; k < n; ++k) {
+            column[k] /= double(k + 1);
+            row[k] /= double(k + 1);
+        }
+        column[0] = row[0] = t0;
+        return ToeplitzMatrix(column, row);
+    }
+
+    Vector testVector(size_t n) {
+        Vector v(n);
+        for (index_t i = 0; i < n; ++i) v[i] = double(i%9) - 4;
+        return v;
+    }
+
+    TEST_CASE("Toeplitz storage") {
+        const Matrix mat = {{1, 4, 5},
+                            {2, 1, 4},
+                            {3, 2, 1}};
+        const ToeplitzMatrix A = ToeplitzMatrix::fromDense(mat);
+        CHECK(A(2, 0) == 3.0);
+        CHECK(A(0, 2) == 5.0);
+        CHECK(A.diagonal(-1) == 4.0);
+        CHECK_THROWS_AS(A(0, 3), std::out_of_range);
+        CHECK(A.toDense() == mat);
+        CHECK(A.transposed().toDense() == Matrix{{1, 2, 3}, {4, 1, 2}, {5, 4, 1}});
+
+        const Vector v = {1, -2, 3}, Av = A*v, expected = mat*v;
+        for (index_t i = 0; i < 3; ++i) CHECK(Av[i] == doctest::Approx(expected[i]));
+
+        CHECK_THROWS_AS(ToeplitzMatrix::fromDense(Matrix{{1, 2}, {3, 4}}), MatrixError);
+        CHECK_THROWS_AS(ToeplitzMatrix({1, 2}, {1, 2, 3}), MatrixError);
+        CHECK_THROWS_AS(ToeplitzMatrix({1, 2}, {2, 3}), MatrixError);
+    }
+
+    TEST_CASE("convolution") {
+        const Vector a = {1, 2, 3}, b = {4, -1};
+        const Vector direct = convolution(a, b, 4, false), fft = convolution(a, b, 4, true);
+        const Vector expected = {4, 7, 10, -3};
+        for (index_t k = 0; k < 4; ++k) {
+            CHECK(direct[k] == expected[k]);
+            CHECK(fft[k] == doctest::Approx(expected[k]));
+        }
+        CHECK(convolution(a, b, 2, true).size() == 2);
+
+        // the FFT product of a large matrix
+        const size_t n = 2*TOEPLITZ_FFT_MIN_SIZE + 3;
+        const ToeplitzMatrix A = randomToeplitz(n, 2.0, 5);
+        const Vector v = testVector(n), Av = A*v, expected2 = A.toDense()*v;
+        for (index_t i = 0; i < n; ++i) CHECK(Av[i] == doctest::Approx(expected2[i]).epsilon(1e-12));
+    }
+
+    TEST_CASE("Levinson solver") {
+        for (size_t fftMinSize : {TOEPLITZ_FFT_MIN_SIZE, size_t(0)}) {
+            for (size_t n : {1, 2, 5, 60, 300}) {
+                const ToeplitzMatrix A = randomToeplitz(n, 1.5, unsigned(n));
+                const ToeplitzDecomposition toepObj(A, numcomp::DEFAULT_TOL, fftMinSize);
+                CHECK(not toepObj.isFallback());
+                CHECK(toepObj.usesFFT() == (n >= fftMinSize));
+
+                const Matrix dense = A.toDense();
+                const LUDecomposition luObj(dense);
+                const Vector b = testVector(n);
+                const Vector x = solveLU(toepObj, b), expected = solveLU(luObj, b);
+                for (index_t i = 0; i < n; ++i) CHECK(x[i] == doctest::Approx(expected[i]).epsilon(1e-10));
+                const Vector y = solveLUTransposed(toepObj, b), expectedT = solveLUTransposed(luObj, b);
+                for (index_t i = 0; i < n; ++i) CHECK(y[i] == doctest::Approx(expectedT[i]).epsilon(1e-10));
+                CHECK(inverseNorm(toepObj, NormType::L1) == doctest::Approx(norm(inverse(luObj), NormType::L1)));
+            }
+        }
+
+        SUBCASE("fallback") {
+            // t_0 = 0: the first leading principal submatrix is singular, but not the matrix
+            const ToeplitzMatrix A = randomToeplitz(30, 0.0, 3);
+            const ToeplitzDecomposition toepObj(A);
+            CHECK(toepObj.isFallback());
+            const Vector b = testVector(30);
+            const Vector residual = A*solveLU(toepObj, b) - b;
+            CHECK(normInf(residual) < 1e-10);
+            const Vector residualT = A.transposed()*solveLUTransposed(toepObj, b) - b;
+            CHECK(normInf(residualT) < 1e-10);
+        }
+
+        SUBCASE("singular") {
+            CHECK_THROWS_AS(ToeplitzDecomposition(ToeplitzMatrix({1, 1, 1}, {1, 1, 1}), 1e-10), SingularMatrixError);
+            ToeplitzDecomposition singular;
+            CHECK(not singular.tryFactor(ToeplitzMatrix({0, 1, 0}, {0, 1, 0})));
+        }
+    }
+
+}
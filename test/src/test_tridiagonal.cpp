@@ -0,0 +1,134 @@
+#include <doctest.h>
+#include "debug.h"
+
+#include "TridiagonalMatrix.h"
+#include "TridiagonalLU.h"
+#include "errors.h"
+#include "norm.h"
+#include "resol.h"
+#include "sistema.h"
+
+
+TEST_SUITE("tridiagonal") {
+
+    /// Random n by n tridiagonal matrix with entries in [-1, 1] and the given shift added to the diagonal
+    TridiagonalMatrix randomTridiagonal(size_t n, double shift, unsigned seed) {
+        const Vector diagonal = randomVector(n, seed), offDiagonal = randomVector(2*n, seed + 1);
+        TridiagonalMatrix A(n);
+        for (index_t i = 0; i < n; ++i) {
+            A.diagonal()[i] = diagonal[i] + shift;
+            if (i + 1 < n) {
+                A.lower()[i] = offDiagonal[2*i];
+                A.upper()[i] = offDiagonal[2*i + 1];
+            }
+        }
+        return A;
+    }
+
+    TEST_CASE("tridiagonal storage") {
+        const Matrix mat = {{2, 1, 0, 0},
+                            {3, 4, 5, 0},
+                            {0, 6, 7, 8},
+                            {0, 0, 9, 1}};
+        const TridiagonalMatrix A = TridiagonalMatrix::fromDense(mat);
+        CHECK(A(1, 0) == 3.0);
+        CHECK(A(2, 3) == 8.0);
+        CHECK(A(0, 3) == 0.0);
+        CHECK_THROWS_AS(A(4, 0), std::out_of_range);
+        CHECK(A.toDense() == mat);
+
+        const Vector v = {1, -2, 3, 4}, Av = A*v, expected = mat*v;
+        for (index_t i = 0; i < 4; ++i) CHECK(Av[i] == doctest::Approx(expected[i]));
+
+        CHECK_THROWS_AS(TridiagonalMatrix::fromDense(Matrix{{1, 0, 2}, {0, 1, 0}, {0, 0, 1}}), MatrixError);
+        CHECK_THROWS_AS(TridiagonalMatrix({1}, {1, 2, 3}, {1, 2}), MatrixError);
+    }
+
+    TEST_CASE("pivoted Thomas algorithm") {
+        // zeros on the diagonal: rows have to be swapped
+        const Matrix mat = {{0, 1, 0, 0, 0},
+                            {2, 0, 3, 0, 0},
+                            {0, 4, 0, 5, 0},
+                            {0, 0, 6, 1e-3, 7},
+                            {0, 0, 0, 8, 1}};
+        const TridiagonalLUDecomposition luObj(TridiagonalMatrix::fromDense(mat));
+        bool swapped = false;
+        for (index_t i = 0; i < 4; ++i) swapped = swapped or luObj.swapped(i);
+        CHECK(swapped);
+
+        const Vector x = {1, -1, 2, 0.5, 3};
+        const Vector y = solveLU(luObj, mat*x);
+        for (index_t i = 0; i < 5; ++i) CHECK(y[i] == doctest::Approx(x[i]));
+        Matrix transposed(5);
+        for (index_t i = 0; i < 5; ++i)
+            for (index_t j = 0; j < 5; ++j) transposed[i][j] = mat[j][i];
+        const Vector z = solveLUTransposed(luObj, transposed*x);
+        for (index_t i = 0; i < 5; ++i) CHECK(z[i] == doctest::Approx(x[i]));
+
+        SUBCASE("long") {
+            const size_t n = 5000;
+            const TridiagonalMatrix A = randomTridiagonal(n, 0.0, 7);  // not dominant
+            const TridiagonalLUDecomposition longLU(A);
+            Vector b(n);
+            for (index_t i = 0; i < n; ++i) b[i] = double(i%11) - 5;
+            const Vector residual = A*solveLU(longLU, b) - b;
+            CHECK(normInf(residual) < 1e-8*normInf(b));
+        }
+
+        SUBCASE("singular") {
+            TridiagonalLUDecomposition singular;
+            // the first two rows are the same
+            const LUStatus status = singular.tryFactor(TridiagonalMatrix({1, 1}, {1, 1, 1}, {1, 0}));
+            CHECK(not status);
+            CHECK(status.pivot == 2);
+        }
+    }
+
+    TEST_CASE("block Thomas algorithm") {
+        const size_t blocks = 20, m = 3;
+        const Matrix dense = randomMatrix(blocks*m, 8.0, 11,
+                                          [=](index_t i, index_t j) { return j/m + 1 >= i/m and j/m <= i/m + 1; });
+        BlockTridiagonalMatrix A = BlockTridiagonalMatrix::fromDense(dense, m);
+        CHECK(A.toDense() == dense);
+        CHECK_THROWS_AS(BlockTridiagonalMatrix::fromDense(dense, 7), MatrixError);
+        CHECK_THROWS_AS(BlockTridiagonalMatrix::fromDense(dense, 2), MatrixError);
+
+        const BlockTridiagonalLUDecomposition luObj(A);
+        const size_t n = A.size();
+        Vector x(n);
+        for (index_t i = 0; i < n; ++i) x[i] = double(i%5) - 2;
+        const Vector Ax = A*x, expected = dense*x;
+        for (index_t i = 0; i < n; ++i) CHECK(Ax[i] == doctest::Approx(expected[i]));
+        const Vector y = solveLU(luObj, Ax);
+        for (index_t i = 0; i < n; ++i) CHECK(y[i] == doctest::Approx(x[i]));
+
+        Matrix transposed(n);
+        for (index_t i = 0; i < n; ++i)
+            for (index_t j = 0; j < n; ++j) transposed[i][j] = dense[j][i];
+        const Vector z = solveLUTransposed(luObj, transposed*x);
+        for (index_t i = 0; i < n; ++i) CHECK(z[i] == doctest::Approx(x[i]));
+
+        SUBCASE("singular block") {
+            A.diagonal(4) = Matrix(m);
+            A.lower(3) = Matrix(m);
+            BlockTridiagonalLUDecomposition singular;
+            const LUStatus status = singular.tryFactor(A);
+            CHECK(not status);
+            CHECK(status.pivot / m == 4);
+        }
+    }
+
+    TEST_CASE("cyclic reduction") {
+        for (size_t n : {1, 2, 7, 64, 1000, 40000}) {  // the largest has parallel levels
+            const TridiagonalMatrix A = randomTridiagonal(n, 3.0, unsigned(n));
+            Vector b(n);
+            for (index_t i = 0; i < n; ++i) b[i] = double(i%13) - 6;
+            const Vector x = solveCyclicReduction(A, b), expected = solveLU(TridiagonalLUDecomposition(A), b);
+            for (index_t i = 0; i < n; ++i) CHECK(x[i] == doctest::Approx(expected[i]).epsilon(1e-12));
+        }
+
+        CHECK_THROWS_AS(solveCyclicReduction(TridiagonalMatrix({1, 1}, {0, 1, 1}, {1, 1}), Vector(1.0, 3)),
+                        SingularMatrixError);
+    }
+
+}
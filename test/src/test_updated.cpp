@@ -0,0 +1,99 @@
+#include <doctest.h>
+#include <random>
+#include "debug.h"
+
+#include "UpdatedLU.h"
+#include "errors.h"
+#include "inverse.h"
+#include "norm.h"
+#include "resol.h"
+
+
+TEST_SUITE("low-rank updates") {
+
+    TEST_CASE("Sherman-Morrison-Woodbury") {
+        const size_t n = 50;
+        std::mt19937 gen(23);
+        std::uniform_real_distribution<double> value(-1, 1);
+        auto randomVector = [&]() {
+            Vector v(n);
+            for (double &elem : v) elem = value(gen);
+            return v;
+        };
+        Matrix A(n);
+        for (index_t i = 0; i < n; ++i) A[i] = randomVector();
+        for (index_t i = 0; i < n; ++i) A[i][i] += 4.0;
+
+        UpdatedLU luObj(A, numcomp::DEFAULT_TOL, 4);
+        Vector b(n);
+        for (index_t i = 0; i < n; ++i) b[i] = double(i%6) - 2.5;
+
+        // each update against the LU decomposition of the updated matrix
+        Matrix M = A;
+        for (index_t step = 0; step < 7; ++step) {
+            const Vector u = randomVector(), v = randomVector();
+            REQUIRE(luObj.update(u, v));
+            for (index_t i = 0; i < n; ++i) M[i] += u[i]*v;
+            CHECK(luObj.matrix() == M);
+
+            const LUDecomposition expected(M);
+            const Vector x = solveLU(luObj, b), y = solveLU(expected, b);
+            for (index_t i = 0; i < n; ++i) CHECK(x[i] == doctest::Approx(y[i]).epsilon(1e-10));
+            const Vector xT = solveLUTransposed(luObj, b), yT = solveLUTransposed(expected, b);
+            for (index_t i = 0; i < n; ++i) CHECK(xT[i] == doctest::Approx(yT[i]).epsilon(1e-10));
+            CHECK(luObj.residue() < UPDATED_LU_MAX_RESIDUE);
+        }
+        // the fifth update went past the maximum rank
+        CHECK(luObj.refactorizations() == 1);
+        CHECK(luObj.rank() == 2);
+        CHECK(inverseNorm(luObj, NormType::L1) == doctest::Approx(norm(inverse(LUDecomposition(M)), NormType::L1)));
+
+        SUBCASE("rank-k update") {
+            const std::vector<Vector> U = {randomVector(), randomVector()}, V = {randomVector(), randomVector()};
+            REQUIRE(luObj.update(U, V));
+            CHECK(luObj.rank() == 4);
+            CHECK_THROWS_AS(luObj.update(U, {V[0]}), MatrixError);
+            CHECK_THROWS_AS(luObj.update(Vector(n + 1), Vector(n)), MatrixError);
+        }
+
+        SUBCASE("residue check") {
+            // A + u v^T nearly singular: the capacitance 1 + v^T A^-1 u is tiny, yet the residue stays small
+            UpdatedLU fresh(A);
+            const Vector u = randomVector(), v0 = randomVector();
+            const Vector z = solveLU(LUDecomposition(A), u);
+            const Vector v = v0*(-(1.0 - 1e-9)/(v0*z).sum());
+            REQUIRE(fresh.update(u, v));
+            CHECK(fresh.residue() < UPDATED_LU_MAX_RESIDUE);
+
+            // no residue tolerated: every update refactors
+            UpdatedLU strict(A, numcomp::DEFAULT_TOL, UPDATED_LU_MAX_RANK, 0.0);
+            REQUIRE(strict.update(u, v0));
+            CHECK(strict.refactorizations() == 1);
+            CHECK(strict.rank() == 0);
+        }
+
+        SUBCASE("zero row sums") {
+            // M = A + u v^T with M (1, ..., 1) = 0: singular, but with a tiny enough tolerance the
+            // rounded capacitance passes, and the residue is 0/0
+            const size_t m = 5;
+            Matrix B(m);
+            for (index_t i = 0; i < m; ++i)
+                for (index_t j = 0; j < m; ++j) B[i][j] = i == j ? 2.0*m : double((i*3 + j*5)%7) - 3;
+            const Vector u = -(B*Vector(1.0, m)), v = {0, 0.25, 0.5, 0, 0.25};
+            UpdatedLU zeroSums(B, 1e-300);
+            zeroSums.update(u, v);
+            CHECK(zeroSums.refactorizations() == 1);
+            CHECK(zeroSums.rank() == 0);
+        }
+
+        SUBCASE("singular update") {
+            // subtract the first row: the matrix gets a zero row
+            UpdatedLU fresh(A);
+            Vector e0(0.0, n);
+            e0[0] = 1.0;
+            const Vector row = A[0];
+            CHECK(not fresh.update(e0, -row));
+        }
+    }
+
+}